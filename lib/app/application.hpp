@@ -4,55 +4,146 @@
 #pragma once
 
 #include "configuration/storage.hpp"
+#include "esp_cpu.h"
 #include "esp_event.h"
 #include "freertos/idf_additions.h"
 #include "midi_synth.hpp"
+#include "output_cursor.hpp"
+#include "render_partition.hpp"
+#include "render_profile.hpp"
 #include "synthesizer_events.hpp"
+#include <array>
 #include <configuration/synth.hpp>
+#include <cstdint>
+#include <optional>
 
 namespace teslasynth::app {
 using namespace midisynth;
 
-namespace {
-void on_track_play(bool playing) {
-  if (playing) {
-    ESP_ERROR_CHECK_WITHOUT_ABORT(
-        esp_event_post(EVENT_SYNTHESIZER_BASE, SYNTHESIZER_PLAYING, NULL, 0, 0));
-  } else {
-    ESP_ERROR_CHECK_WITHOUT_ABORT(
-        esp_event_post(EVENT_SYNTHESIZER_BASE, SYNTHESIZER_STOPPED, NULL, 0, 0));
+/**
+ * The synth write lock, split per output.
+ *
+ * Rendering an output only needs that output's lock, so render workers on
+ * different cores don't wait on each other. Anything that touches state
+ * shared between outputs (MIDI input, configuration) takes all of them.
+ * Locks are always taken in ascending output order.
+ */
+class SynthLocks {
+  static constexpr uint8_t outputs = configuration::hardware::OutputConfig::size;
+#if CONFIG_TESLASYNTH_RMT_PULL
+  // The RMT interrupt renders outputs itself, so they're guarded by spinlocks it can take too
+  std::array<portMUX_TYPE, outputs> locks;
+
+public:
+  SynthLocks() {
+    for (auto &lock : locks)
+      portMUX_INITIALIZE(&lock);
+  }
+
+  inline void acquire(OutputRange range) {
+    for (uint8_t ch = range.first; ch < range.end(); ch++)
+      portENTER_CRITICAL_SAFE(&locks[ch]);
+  }
+  inline void release(OutputRange range) {
+    for (uint8_t ch = range.end(); ch > range.first; ch--)
+      portEXIT_CRITICAL_SAFE(&locks[ch - 1]);
+  }
+#else
+  std::array<SemaphoreHandle_t, outputs> locks;
+
+public:
+  SynthLocks() {
+    for (auto &lock : locks)
+      lock = xSemaphoreCreateMutex();
   }
-}
-}; // namespace
+
+  inline void acquire(OutputRange range) {
+    for (uint8_t ch = range.first; ch < range.end(); ch++)
+      xSemaphoreTake(locks[ch], portMAX_DELAY);
+  }
+  inline void release(OutputRange range) {
+    for (uint8_t ch = range.end(); ch > range.first; ch--)
+      xSemaphoreGive(locks[ch - 1]);
+  }
+#endif
+  inline void acquire() { acquire({0, outputs}); }
+  inline void release() { release({0, outputs}); }
+};
+
+/// The clock the render profile is timed with, in CPU cycles of the core that reads it
+struct CpuCycles {
+  static constexpr uint32_t per_us = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+  static inline uint32_t now() { return esp_cpu_get_cycle_count(); }
+};
 
 class PlaybackHandle {
   AppSynth *impl;
-  SemaphoreHandle_t lock;
+  SynthLocks *locks;
+  RenderProfile *_profile;
 
 public:
   PlaybackHandle() {}
-  PlaybackHandle(AppSynth *impl, SemaphoreHandle_t lock) : impl(impl), lock(lock) {}
+  PlaybackHandle(AppSynth *impl, SynthLocks *locks, RenderProfile *profile)
+      : impl(impl), locks(locks), _profile(profile) {}
 
-  inline void acquire() { xSemaphoreTake(lock, portMAX_DELAY); }
-  inline void release() { xSemaphoreGive(lock); }
+  inline void acquire() { locks->acquire(); }
+  inline void release() { locks->release(); }
+  inline void acquire(OutputRange range) { locks->acquire(range); }
+  inline void release(OutputRange range) { locks->release(range); }
 
   inline void handle(MidiChannelMessage msg, Duration time) { impl->handle(msg, time); }
-  template <size_t BUFSIZE>
+  /// Only a hint, it is read without a lock
+  inline bool stopping() const { return impl->stopping(); }
+  /// Requires every output's lock
+  inline void stop_when_silent() { impl->stop_when_silent(); }
+  template <size_t BUFSIZE, class ENCODER>
   inline void
   sample_all(Duration16 max,
-             PulseBuffer<configuration::hardware::OutputConfig::size, BUFSIZE> &output) {
+             PulseBuffer<configuration::hardware::OutputConfig::size, BUFSIZE, ENCODER> &output) {
     impl->sample_all(max, output);
   };
+  /// Requires the locks of `range` only
+  template <size_t BUFSIZE, class ENCODER>
+  inline void
+  sample_range(Duration16 max,
+               PulseBuffer<configuration::hardware::OutputConfig::size, BUFSIZE, ENCODER> &output,
+               OutputRange range) {
+    impl->sample_range(max, output, range);
+  };
+  /// Time until the next pulse of any output in `range`, requires their locks
+  inline std::optional<Duration> next_edge(OutputRange range) {
+    std::optional<Duration> res;
+    for (uint8_t ch = range.first; ch < range.end(); ch++)
+      if (auto edge = impl->next_edge(ch))
+        res = res ? std::min(*res, *edge) : *edge;
+    return res;
+  }
+  /// Takes the cursor's output lock itself, so it may be called from the RMT interrupt
+  template <class ENCODER>
+  inline size_t pull(OutputCursor<ENCODER> &cursor, typename ENCODER::Symbol *out,
+                     size_t capacity) {
+    const OutputRange range{cursor.output(), 1};
+    locks->acquire(range);
+    const size_t written = cursor.pull(*impl, out, capacity);
+    locks->release(range);
+    return written;
+  }
+  /// Only a hint, it is read without a lock
+  inline bool is_playing() const { return impl->track().is_playing(); }
+  /// Lock-free, may be recorded into from any task or interrupt
+  inline RenderProfile &profile() { return *_profile; }
 };
 
 class UIHandle {
   AppSynth *impl;
-  SemaphoreHandle_t write_lock, read_lock;
+  SynthLocks *write_lock;
+  SemaphoreHandle_t read_lock;
+  RenderProfile *profile;
 
 public:
   UIHandle() {}
-  UIHandle(AppSynth *impl, SemaphoreHandle_t write, SemaphoreHandle_t read)
-      : impl(impl), write_lock(write), read_lock(read) {}
+  UIHandle(AppSynth *impl, SynthLocks *write, SemaphoreHandle_t read, RenderProfile *profile)
+      : impl(impl), write_lock(write), read_lock(read), profile(profile) {}
 
   inline AppConfig config_read() const {
     xSemaphoreTake(read_lock, portMAX_DELAY);
@@ -64,11 +155,17 @@ public:
   inline void config_set(const AppConfig &config, bool reload = false, bool persist = false) {
     xSemaphoreTake(read_lock, portMAX_DELAY);
 
-    xSemaphoreTake(write_lock, portMAX_DELAY);
-    impl->configuration() = config;
+    // Built before taking the write lock, which keeps interrupts off in pull mode. The read
+    // lock guards it, it is too big for the callers' stacks.
+    static TuningTable tuning;
+    tuning.retune(config.synth().tuning);
+
+    write_lock->acquire();
     if (reload)
-      impl->reload_config();
-    xSemaphoreGive(write_lock);
+      impl->load_config(config, tuning);
+    else
+      impl->set_config(config, tuning);
+    write_lock->release();
 
     xSemaphoreGive(read_lock);
     ESP_ERROR_CHECK(
@@ -84,21 +181,49 @@ public:
   }
 
   inline void playback_off() {
-    xSemaphoreTake(write_lock, portMAX_DELAY);
+    write_lock->acquire();
     impl->off();
-    xSemaphoreGive(write_lock);
+    write_lock->release();
+  }
+
+  inline InputTiming input_timing(bool reset = false) {
+    write_lock->acquire();
+    auto res = impl->input_timing();
+    if (reset)
+      impl->reset_input_timing();
+    write_lock->release();
+    return res;
+  }
+
+  /// Read while the render loop keeps recording, so counters may be a block apart
+  inline const RenderProfile &render_profile() const { return *profile; }
+  inline void reset_render_profile() { profile->reset(); }
+
+  inline EngineStats engine_stats(uint8_t ch) {
+    const OutputRange output{ch, 1};
+    write_lock->acquire(output);
+    auto res = impl->stats(ch);
+    write_lock->release(output);
+    return res;
+  }
+
+  inline void reset_engine_stats() {
+    write_lock->acquire();
+    impl->reset_stats();
+    write_lock->release();
   }
 };
 
 class Application {
   AppSynth impl;
-  SemaphoreHandle_t write_lock, read_lock;
+  SynthLocks write_lock;
+  SemaphoreHandle_t read_lock;
+  RenderProfile profile;
 
 public:
-  Application() : write_lock(xSemaphoreCreateMutex()), read_lock(xSemaphoreCreateMutex()) {}
+  Application() : read_lock(xSemaphoreCreateMutex()) {}
   Application(const AppConfig &config)
-      : impl(config, on_track_play), write_lock(xSemaphoreCreateMutex()),
-        read_lock(xSemaphoreCreateMutex()) {}
+      : impl(config), read_lock(xSemaphoreCreateMutex()) {}
   void load(const AppConfig &config) {
     impl.configuration() = config;
     impl.reload_config();
@@ -110,7 +235,7 @@ public:
       load(config);
     return res;
   }
-  PlaybackHandle playback() { return PlaybackHandle(&impl, write_lock); }
-  UIHandle ui() { return UIHandle(&impl, write_lock, read_lock); }
+  PlaybackHandle playback() { return PlaybackHandle(&impl, &write_lock, &profile); }
+  UIHandle ui() { return UIHandle(&impl, &write_lock, read_lock, &profile); }
 };
 }; // namespace teslasynth::app
@@ -28,6 +28,7 @@ constexpr char max_duty[] = "max-duty";
 constexpr char duty_window[] = "duty-window";
 constexpr char pulse_resolution[] = "pulse-resolution";
 constexpr char tuning[] = "tuning";
+constexpr char latency[] = "latency";
 constexpr char notes[] = "notes";
 constexpr char instrument[] = "instrument";
 constexpr char percussion[] = "percussion";
@@ -41,6 +42,11 @@ typedef struct {
 } config_args_t;
 config_args_t config_args;
 
+struct {
+  struct arg_lit *reset;
+  struct arg_end *end;
+} jitter_args;
+
 UIHandle handle_;
 
 #define cstr(value) std::string(value).c_str()
@@ -86,9 +92,10 @@ void print_routing_config(const AppMidiRoutingConfig &config) {
 int print_config(AppConfig &config) {
   printf("Synth configuration:\n"
          "\t%s = %s\n"
-         "\t%s = <%s>\n",
+         "\t%s = <%s>\n"
+         "\t%s = %s\n",
          keys::tuning, cstr(config.synth().tuning), keys::instrument,
-         instrument_value(config.synth()));
+         instrument_value(config.synth()), keys::latency, cstr(config.synth().latency));
 
   for (auto i = 0; i < config.channels_size(); i++) {
     print_output_config(i, config.channel(i));
@@ -149,6 +156,27 @@ int playbackoff_cmd(int, char **) {
   return 0;
 }
 
+void print_lateness(const char *name, const LatenessStats &stats) {
+  printf("\t%s: %lu late of %lu, mean %.0fus, jitter %.0fus, max %luus\n", name,
+         static_cast<unsigned long>(stats.late), static_cast<unsigned long>(stats.count),
+         stats.mean_us(), stats.jitter_us(), static_cast<unsigned long>(stats.max_us));
+}
+
+int jitter_cmd(int argc, char **argv) {
+  int nerrors = arg_parse(argc, argv, (void **)&jitter_args);
+  if (nerrors != 0) {
+    arg_print_errors(stderr, jitter_args.end, argv[0]);
+    return 0;
+  }
+
+  const auto latency = handle_.config_read().synth().latency;
+  const auto timing = handle_.input_timing(jitter_args.reset->count != 0);
+  printf("Input timing against playback:\n");
+  print_lateness("without latency", timing.unbuffered);
+  print_lateness(("with latency " + std::string(latency)).c_str(), timing.buffered);
+  return 0;
+}
+
 int device_limits_cmd(int, char **) {
   printf("Max notes: %d\n", ChannelConfig::max_notes);
   return 0;
@@ -193,6 +221,9 @@ void register_configuration_commands(UIHandle handle) {
       arg_strn(nullptr, nullptr, "<key[:ch]=value>", 0, 50, "Set configuration value");
   config_args.end = arg_end(20);
 
+  jitter_args.reset = arg_lit0("r", "reset", "Start measuring again");
+  jitter_args.end = arg_end(2);
+
   const std::array commands = {
       esp_console_cmd_t{
           .command = "config",
@@ -205,6 +236,12 @@ void register_configuration_commands(UIHandle handle) {
           .help = "All notes off instantly",
           .func = playbackoff_cmd,
       },
+      esp_console_cmd_t{
+          .command = "jitter",
+          .help = "Print how late live MIDI reaches playback, with and without the synth latency",
+          .func = jitter_cmd,
+          .argtable = &jitter_args,
+      },
       esp_console_cmd_t{
           .command = "limits",
           .help = "Print device hard limits set in firmware at compile time",
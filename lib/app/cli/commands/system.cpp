@@ -1,6 +1,7 @@
 // Copyright Hossein Naderi 2025, 2026
 // SPDX-License-Identifier: GPL-3.0-only
 
+#include "application.hpp"
 #include "argtable3/argtable3.h"
 #include "esp_app_desc.h"
 #include "esp_console.h"
@@ -30,6 +31,7 @@ namespace teslasynth::app::cli {
 
 namespace {
 constexpr char TAG[] = "cmd_system_common";
+UIHandle handle_;
 
 /* 'version' command */
 int get_version(int argc, char **argv) {
@@ -222,9 +224,70 @@ void register_log_level(void) {
   };
   ESP_ERROR_CHECK(esp_console_cmd_register(&cmd));
 }
+/** 'stats' command prints the render loop profile, the one way to read it while playing */
+
+struct {
+  struct arg_lit *reset;
+  struct arg_end *end;
+} stats_args;
+
+unsigned long us(uint32_t cycles) { return cycles / CpuCycles::per_us; }
+
+int stats(int argc, char **argv) {
+  int nerrors = arg_parse(argc, argv, (void **)&stats_args);
+  if (nerrors != 0) {
+    arg_print_errors(stderr, stats_args.end, argv[0]);
+    return 1;
+  }
+
+  const auto &profile = handle_.render_profile();
+  printf("Stage\t\tCount\tp50\tp99\tmax (us)\n");
+  for (size_t i = 0; i < midisynth::stages; i++) {
+    const auto &timing = profile.timings[i];
+    printf("%-10s\t%" PRIu32 "\t%lu\t%lu\t%lu\n", midisynth::stage_names[i], timing.count(),
+           us(timing.percentile(50)), us(timing.percentile(99)), us(timing.max()));
+  }
+  printf("Symbols per block: p50 %" PRIu32 ", p99 %" PRIu32 ", max %" PRIu32 "\n",
+         profile.symbols.percentile(50), profile.symbols.percentile(99), profile.symbols.max());
+  printf("Deadline misses: %" PRIu32 "\n", profile.deadline_misses.load());
+  printf("Input dropped: %" PRIu32 "\n", profile.input_dropped.load());
+
+  if constexpr (EngineCounters::enabled) {
+    printf("Output\tPulses\tSkipped\tLimited\tLimited on (us)\tSteals\tPeak voices\tDropped\n");
+    for (uint8_t ch = 0; ch < configuration::hardware::OutputConfig::size; ch++) {
+      const auto engine = handle_.engine_stats(ch);
+      printf("%d\t%" PRIu32 "\t%" PRIu32 "\t%" PRIu32 "\t%" PRIu64 "\t\t%" PRIu32 "\t%d\t\t%" PRIu32
+             "\n",
+             ch + 1, engine.pulses, engine.skipped, engine.limited, engine.limited_on_us,
+             engine.steals, engine.peak_voices, engine.dropped);
+    }
+  }
+
+  if (stats_args.reset->count != 0) {
+    handle_.reset_render_profile();
+    handle_.reset_engine_stats();
+  }
+  return 0;
+}
+
+void register_stats(void) {
+  stats_args.reset = arg_lit0("r", "reset", "Start profiling again");
+  stats_args.end = arg_end(2);
+
+  const esp_console_cmd_t cmd = {
+      .command = "stats",
+      .help = "Print render loop timings and what each output played and dropped, also "
+              "during a show",
+      .hint = NULL,
+      .func = &stats,
+      .argtable = &stats_args,
+  };
+  ESP_ERROR_CHECK(esp_console_cmd_register(&cmd));
+}
 } // namespace
 
-void register_system_common(void) {
+void register_system_common(UIHandle handle) {
+  handle_ = handle;
   register_free();
   register_heap();
   register_version();
@@ -234,6 +297,7 @@ void register_system_common(void) {
 #endif
   register_log_level();
   register_maintenance();
+  register_stats();
 }
 
 } // namespace teslasynth::app::cli
@@ -8,7 +8,7 @@
 
 namespace teslasynth::app::cli {
 extern void register_configuration_commands(UIHandle handle);
-extern void register_system_common(void);
+extern void register_system_common(UIHandle handle);
 extern void register_instruments(void);
 
 void init(UIHandle handle) {
@@ -20,7 +20,7 @@ void init(UIHandle handle) {
 
   /* Register commands */
   esp_console_register_help_command();
-  register_system_common();
+  register_system_common(handle);
   register_configuration_commands(handle);
   register_instruments();
 
@@ -78,6 +78,12 @@ Decoder<AppConfig> parse_appconfig(helpers::JSONParser &parser) {
 
   config.synth().tuning = TRY(parse_frequency(root.get(keys::tuning)));
   config.synth().instrument = TRY(parse_instrument(root.get(keys::instrument)));
+  auto latency = root.get(keys::latency);
+  if (latency.is_number()) {
+    config.synth().latency = TRY(parse_duration(latency));
+    if (config.synth().latency > midisynth::SynthConfig::max_latency)
+      return "Invalid latency";
+  }
 
   auto channels = TRY(parse_array(root.get(keys::channels)));
   int idx = 0;
@@ -131,6 +137,7 @@ JSONEncoder encode(const AppConfig &config) {
   JSONEncoder encoder;
   auto root = encoder.object();
   root.add(keys::tuning, config.synth().tuning);
+  root.add(keys::latency, config.synth().latency.micros());
   if (config.synth().instrument.has_value())
     root.add(keys::instrument, *config.synth().instrument);
   else
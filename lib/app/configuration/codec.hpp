@@ -17,6 +17,7 @@ constexpr char max_duty[] = "max-duty";
 constexpr char duty_window[] = "duty-window";
 constexpr char pulse_resolution[] = "pulse-resolution";
 constexpr char tuning[] = "tuning";
+constexpr char latency[] = "latency";
 constexpr char notes[] = "notes";
 constexpr char channels[] = "channels";
 constexpr char instrument[] = "instrument";
@@ -11,5 +11,14 @@ using AppConfig = teslasynth::midisynth::Configuration<
     teslasynth::app::configuration::hardware::OutputConfig::size>;
 using AppMidiRoutingConfig = teslasynth::midisynth::MidiRoutingConfig<
     teslasynth::app::configuration::hardware::OutputConfig::size>;
+
+namespace teslasynth::app {
+/// Posts the synthesizer's playing and stopped events when the track starts or stops
+struct OnTrackPlay {
+  void operator()(bool playing) const;
+};
+} // namespace teslasynth::app
+
 using AppSynth =
-    teslasynth::midisynth::Teslasynth<teslasynth::app::configuration::hardware::OutputConfig::size>;
+    teslasynth::midisynth::Teslasynth<teslasynth::app::configuration::hardware::OutputConfig::size,
+                                      teslasynth::synth::Voice<>, teslasynth::app::OnTrackPlay>;
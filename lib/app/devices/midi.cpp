@@ -15,4 +15,22 @@ void init(StreamBufferHandle_t buf) {
   else
     static_assert(ble_support || usb_support, "Must support at least one midi driver");
 }
+
+bool ChunkSender::add(MessageBufferHandle_t buf,
+                      const teslasynth::midi::TimedChannelMessage &event) {
+  if (_writer.append(event))
+    return true;
+  const bool sent = flush(buf);
+  _writer.append(event);
+  return sent;
+}
+
+bool ChunkSender::flush(MessageBufferHandle_t buf) {
+  if (_writer.empty())
+    return true;
+  const size_t size = _writer.size();
+  const bool sent = xMessageBufferSend(buf, _writer.data(), size, 0) == size;
+  _writer.clear();
+  return sent;
+}
 } // namespace teslasynth::app::devices::midi
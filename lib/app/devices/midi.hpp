@@ -5,6 +5,10 @@
 
 #include "esp_event_base.h"
 #include "freertos/idf_additions.h"
+#include "midi_core.hpp"
+#include "midi_frame.hpp"
+#include <cstddef>
+#include <cstdint>
 
 ESP_EVENT_DECLARE_BASE(EVENT_MIDI_DEVICE_BASE);
 enum {
@@ -35,4 +39,34 @@ void init(StreamBufferHandle_t sbuf);
 }
 
 void init(StreamBufferHandle_t buf);
+
+/// Largest chunk of frames a driver sends at once
+constexpr size_t max_chunk = 128;
+
+/**
+ * Collects the events a driver received into chunks of frames (see
+ * midi_frame.hpp), each stamped with the time it arrived or was sent at on
+ * the esp_timer clock.
+ *
+ * The buffer is a message buffer, so a chunk stays together.
+ */
+class ChunkSender {
+  uint8_t _frames[max_chunk];
+  teslasynth::midi::FrameWriter _writer{_frames, max_chunk};
+  static_assert(max_chunk >= teslasynth::midi::FrameWriter::max_frame_size);
+
+public:
+  ChunkSender() = default;
+  ChunkSender(const ChunkSender &) = delete;
+  ChunkSender &operator=(const ChunkSender &) = delete;
+
+  /**
+   * Adds an event, sending the chunk so far first if it is full
+   *
+   * @return false if that chunk didn't fit in the buffer and was dropped
+   */
+  bool add(MessageBufferHandle_t buf, const teslasynth::midi::TimedChannelMessage &event);
+  /// Sends what was collected and starts a new chunk; false if it was dropped
+  bool flush(MessageBufferHandle_t buf);
+};
 } // namespace teslasynth::app::devices::midi
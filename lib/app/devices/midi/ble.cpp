@@ -6,9 +6,11 @@
 #if CONFIG_SOC_BT_SUPPORTED
 
 #include "../midi.hpp"
+#include "ble_midi.hpp"
 #include "esp_err.h"
 #include "esp_event.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/idf_additions.h"
 #include "host/ble_gatt.h"
 #include "host/ble_hs.h"
@@ -41,9 +43,22 @@ static bool adv_in_progress = false;
 void ble_app_on_sync(void);
 void ble_app_advertise(void);
 
+// The sender and the decoder are only touched from the NimBLE host task
+ChunkSender sender;
+
+// Frames every decoded message at the time the sender played it
+struct Forward {
+  void operator()(const teslasynth::midi::TimedChannelMessage &e) const {
+    if (!sender.add(midi_buffer, e))
+      ESP_LOGE(TAG, "Couldn't write received BLE data!");
+  }
+};
+teslasynth::midi::BleMidiDecoder<Forward> decoder;
+
 inline void receive_midi(ble_gatt_access_ctxt *ctxt) {
   ESP_LOGD(TAG, "MIDI write, om_len=%d", ctxt->om->om_len);
-  uint8_t buf[128];
+  const uint64_t arrival = esp_timer_get_time();
+  uint8_t buf[max_chunk];
   uint16_t copied = 0;
 
   int rc = ble_hs_mbuf_to_flat(ctxt->om, buf, sizeof(buf), &copied);
@@ -52,11 +67,11 @@ inline void receive_midi(ble_gatt_access_ctxt *ctxt) {
     return;
   }
 
-  if (copied > 0) {
-    if (xStreamBufferSend(midi_buffer, buf, copied, 0) != copied) {
-      ESP_LOGE(TAG, "Couldn't write received BLE data!");
-    }
-  }
+  // A packet goes to the synth task as one chunk
+  if (copied > 0 && !decoder.decode(buf, copied, arrival))
+    ESP_LOGW(TAG, "Dropped a malformed BLE-MIDI packet");
+  if (!sender.flush(midi_buffer))
+    ESP_LOGE(TAG, "Couldn't write received BLE data!");
 }
 
 int midi_gatt_access_cb(uint16_t conn_hdl, uint16_t attr_hdl, struct ble_gatt_access_ctxt *ctxt,
@@ -98,6 +113,7 @@ int gap_event_handler(struct ble_gap_event *event, void *) {
     if (event->connect.status == 0) {
       ESP_LOGI(TAG, "Connected, handle=%d", event->connect.conn_handle);
       adv_in_progress = false;
+      decoder.reset();
       ESP_ERROR_CHECK(
           esp_event_post(EVENT_MIDI_DEVICE_BASE, MIDI_DEVICE_CONNECTED, NULL, 0, portMAX_DELAY));
     } else {
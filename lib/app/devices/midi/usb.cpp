@@ -10,7 +10,7 @@
 #include "../midi.hpp"
 #include "esp_log.h"
 #include "esp_mac.h"
-#include "freertos/task.h"
+#include "esp_timer.h"
 #include "tinyusb.h"
 #include "tinyusb_default_config.h"
 #include <stdio.h>
@@ -88,37 +88,48 @@ const uint8_t s_midi_hs_cfg_desc[] = {
 };
 #endif // TUD_OPT_HIGH_SPEED
 
-inline uint8_t usb_midi_cin_length(uint8_t cin) {
-  static const uint8_t len_table[16] = {
-      /*0*/ 0, /*1*/ 0,
-      /*2*/ 2, /*3*/ 3,
-      /*4*/ 3, /*5*/ 1,
-      /*6*/ 2, /*7*/ 3,
-      /*8*/ 3, /*9*/ 3,
-      /*A*/ 3, /*B*/ 3,
-      /*C*/ 2, /*D*/ 2,
-      /*E*/ 3, /*F*/ 1,
+// Only touched from the TinyUSB task
+ChunkSender sender;
+
+/**
+ * USB-MIDI packets carry whole messages behind a code index number, so
+ * channel messages map straight to events. System messages and sysex are
+ * skipped like the parser skips them.
+ */
+inline bool to_event(const uint8_t packet[4], uint64_t time_us,
+                     teslasynth::midi::TimedChannelMessage &event) {
+  const uint8_t cin = packet[0] & 0x0F;
+  if (cin < 0x8 || cin > 0xE)
+    return false;
+  const teslasynth::midi::MidiStatus status(packet[1]);
+  event = {
+      .time_us = time_us,
+      .message =
+          {
+              .type = status.channel_status_type(),
+              .channel = status.channel(),
+              .data0 = packet[2],
+              .data1 = packet[3],
+          },
   };
-  return len_table[cin & 0x0F];
+  return true;
 }
+} // namespace
 
-void midi_read(void *) {
+// Called by the TinyUSB task once a transfer is in, so packets are stamped
+// when they arrive instead of at the next poll
+extern "C" void tud_midi_rx_cb(uint8_t itf) {
+  const uint64_t arrival = esp_timer_get_time();
   uint8_t packet[4];
-  bool read = false;
-  for (;;) {
-    vTaskDelay(1);
-    while (tud_midi_available()) {
-      read = tud_midi_packet_read(packet);
-      if (read) {
-        size_t count = usb_midi_cin_length(packet[0] & 0x0F);
-        if (xStreamBufferSend(midi_buffer, &packet[1], count, 0) != count) {
-          ESP_LOGE(TAG, "Couldn't write received USB data!");
-        }
-      }
-    }
+  teslasynth::midi::TimedChannelMessage event;
+  while (tud_midi_n_packet_read(itf, packet)) {
+    if (to_event(packet, arrival, event) && !sender.add(midi_buffer, event))
+      ESP_LOGE(TAG, "Couldn't write received USB data!");
   }
+  if (!sender.flush(midi_buffer))
+    ESP_LOGE(TAG, "Couldn't write received USB data!");
 }
-} // namespace
+
 void init(StreamBufferHandle_t sbuf) {
   assert(sbuf != nullptr);
   midi_buffer = sbuf;
@@ -143,10 +154,6 @@ void init(StreamBufferHandle_t sbuf) {
   ESP_ERROR_CHECK(tinyusb_driver_install(&tusb_cfg));
 
   ESP_LOGI(TAG, "USB initialization DONE");
-
-  // Read received MIDI packets
-  ESP_LOGI(TAG, "MIDI read task init");
-  xTaskCreate(midi_read, "usb_midi_read", 2 * 1024, NULL, 5, NULL);
 }
 } // namespace teslasynth::app::devices::midi::usb
 
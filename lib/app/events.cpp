@@ -1,7 +1,29 @@
 // Copyright Hossein Naderi 2025, 2026
 // SPDX-License-Identifier: GPL-3.0-only
 
+#include "configuration/synth.hpp"
+#include "esp_err.h"
+#include "esp_event.h"
 #include "esp_event_base.h"
+#include "sdkconfig.h"
 #include "synthesizer_events.hpp"
 
 ESP_EVENT_DEFINE_BASE(EVENT_SYNTHESIZER_BASE);
+
+namespace teslasynth::app {
+void OnTrackPlay::operator()(bool playing) const {
+#if CONFIG_TESLASYNTH_RMT_PULL
+  // Called with the output spinlocks held, where only ISR safe calls are allowed
+  ESP_ERROR_CHECK_WITHOUT_ABORT(esp_event_isr_post(
+      EVENT_SYNTHESIZER_BASE, playing ? SYNTHESIZER_PLAYING : SYNTHESIZER_STOPPED, NULL, 0, NULL));
+#else
+  if (playing) {
+    ESP_ERROR_CHECK_WITHOUT_ABORT(
+        esp_event_post(EVENT_SYNTHESIZER_BASE, SYNTHESIZER_PLAYING, NULL, 0, 0));
+  } else {
+    ESP_ERROR_CHECK_WITHOUT_ABORT(
+        esp_event_post(EVENT_SYNTHESIZER_BASE, SYNTHESIZER_STOPPED, NULL, 0, 0));
+  }
+#endif
+}
+} // namespace teslasynth::app
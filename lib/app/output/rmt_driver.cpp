@@ -16,6 +16,7 @@
 #include "midi_synth.hpp"
 #include "rmt_driver.hpp"
 #include "soc/gpio_num.h"
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <stddef.h>
@@ -23,47 +24,45 @@
 
 namespace teslasynth::app::devices::rmt {
 using configuration::hardware::OutputConfig;
-using teslasynth::midisynth::Pulse;
+using teslasynth::midisynth::Duration32;
+using teslasynth::midisynth::RmtSymbolCompiler;
+using teslasynth::midisynth::RmtSymbolEncoder;
+
+static_assert(sizeof(RmtSymbolEncoder::Symbol) == sizeof(rmt_symbol_word_t),
+              "rendered symbols are handed to the RMT as they are");
 
 namespace {
 constexpr uint32_t rmt_resolution_hz = 1'000'000;
 constexpr char TAG[] = "RMT-DRIVER";
 
-inline void symbol_for_idx(Pulse const *current, rmt_symbol_word_t *symbol) {
-  if (current->is_zero()) {
-    *symbol = {
-        .duration0 = std::max<uint16_t>(1, current->off.micros() - 1),
-        .level0 = 0,
-        .duration1 = 1,
-        .level1 = 0,
-    };
-  } else {
-    *symbol = {
-        .duration0 = current->on.micros(),
-        .level0 = 1,
-        .duration1 = std::max<uint16_t>(1, current->off.micros()),
-        .level1 = 0,
-    };
-  }
-}
+rmt_channel_handle_t channels[OutputConfig::size];
+rmt_encoder_handle_t encoders[OutputConfig::size];
 
-size_t callback(const void *data, size_t data_size, size_t symbols_written, size_t symbols_free,
-                rmt_symbol_word_t *symbols, bool *done, void *arg) {
-  const Pulse *input = static_cast<const Pulse *>(data);
-  const size_t data_length = data_size / sizeof(Pulse);
+TransmitDone on_done = nullptr;
 
-  size_t written = 0;
-  for (; written < symbols_free && symbols_written + written < data_length; written++) {
-    Pulse const *current = &input[symbols_written + written];
-    symbol_for_idx(current, &symbols[written]);
-  }
-  if (written + symbols_written == data_length)
-    *done = true;
-  return written;
+bool trans_done(rmt_channel_handle_t, const rmt_tx_done_event_data_t *, void *arg) {
+  return on_done != nullptr && on_done(reinterpret_cast<uintptr_t>(arg));
 }
 
-rmt_channel_handle_t channels[OutputConfig::size];
-rmt_encoder_handle_t encoders[OutputConfig::size];
+#if CONFIG_TESLASYNTH_RMT_PULL
+SymbolSource source = nullptr;
+
+// A transmission's payload is its length, which has to outlive it. Queued and
+// running transmissions never take more than the queue's depth of slots.
+struct StreamLengths {
+  std::array<uint32_t, queue_depth + 1> slots;
+  size_t next = 0;
+};
+StreamLengths lengths[OutputConfig::size];
+
+size_t pull(const void *data, size_t, size_t written, size_t free, rmt_symbol_word_t *symbols,
+            bool *done, void *arg) {
+  const uint8_t ch = reinterpret_cast<uintptr_t>(arg);
+  const auto length = Duration32::micros(*static_cast<const uint32_t *>(data));
+  return source(ch, length, written, reinterpret_cast<RmtSymbolEncoder::Symbol *>(symbols), free,
+                *done);
+}
+#endif
 
 constexpr rmt_transmit_config_t tx_config = {
     .loop_count = 0,
@@ -95,17 +94,23 @@ void disable(void) {
 void init(const OutputConfig &config) {
   ESP_LOGI(TAG, "Create %u RMT TX channel(s)", OutputConfig::size);
 
-  constexpr rmt_simple_encoder_config_t encoder_config = {
-      .callback = callback,
-      .arg = NULL,
-      .min_chunk_size = 1,
+#if CONFIG_TESLASYNTH_RMT_PULL
+  // The interrupt renders symbols as memory frees up, never more than a pulse's worth short
+  rmt_simple_encoder_config_t encoder_config = {
+      .callback = pull,
+      .arg = nullptr,
+      .min_chunk_size = RmtSymbolCompiler::max_symbols,
   };
+#else
+  // Symbols are encoded while rendering, so the interrupt only copies them
+  constexpr rmt_copy_encoder_config_t encoder_config = {};
+#endif
   rmt_tx_channel_config_t tx_chan_config = {
       .gpio_num = gpio_num_t::GPIO_NUM_NC,
       .clk_src = RMT_CLK_SRC_DEFAULT,
       .resolution_hz = rmt_resolution_hz,
       .mem_block_symbols = CONFIG_SOC_RMT_MEM_WORDS_PER_CHANNEL,
-      .trans_queue_depth = 10,
+      .trans_queue_depth = queue_depth,
       .flags =
           {
               .invert_out = false,
@@ -124,29 +129,32 @@ void init(const OutputConfig &config) {
     ESP_LOGI(TAG, "Output#%d conneced to GPIO %d", i + 1, pin);
     tx_chan_config.gpio_num = pin;
     ESP_ERROR_CHECK(rmt_new_tx_channel(&tx_chan_config, &channels[i]));
+    const rmt_tx_event_callbacks_t callbacks = {.on_trans_done = trans_done};
+    void *arg = reinterpret_cast<void *>(uintptr_t{i});
+    ESP_ERROR_CHECK(rmt_tx_register_event_callbacks(channels[i], &callbacks, arg));
+#if CONFIG_TESLASYNTH_RMT_PULL
+    encoder_config.arg = arg;
     ESP_ERROR_CHECK(rmt_new_simple_encoder(&encoder_config, &encoders[i]));
+#else
+    ESP_ERROR_CHECK(rmt_new_copy_encoder(&encoder_config, &encoders[i]));
+#endif
   }
 
   enable();
 }
 
-void pulse_write(const midisynth::Pulse *pulse, size_t len, uint8_t ch) {
-#if CONFIG_TESLASYNTH_DEBUG
-  static size_t counter = 0, min_i = std::numeric_limits<size_t>::max(), max_i = 0, total = 0;
-  min_i = std::min(len, min_i);
-  max_i = std::max(len, max_i);
-  total += len;
-  if (counter++ % 100 == 0) {
-    ESP_LOGI(TAG, "RMT items stats, min: %u, max: %u, total: %u, avg: %u", min_i, max_i, total,
-             total / counter);
-  }
-#endif
+void set_on_done(TransmitDone callback) { on_done = callback; }
+
+bool connected(uint8_t ch) { return channels[ch] != nullptr; }
 
+bool symbols_write(const RmtSymbolEncoder::Symbol *symbols, size_t len, uint8_t ch) {
   if (len == 0 || channels[ch] == nullptr)
-    return;
+    return false;
 
-  esp_err_t err = rmt_transmit(channels[ch], encoders[ch], pulse, len * sizeof(Pulse), &tx_config);
-  // ESP_ERR_INVALID_STATE means the TX queue is full in non-blocking mode.
+  esp_err_t err = rmt_transmit(channels[ch], encoders[ch], symbols,
+                               len * sizeof(RmtSymbolEncoder::Symbol), &tx_config);
+  // ESP_ERR_INVALID_STATE means the TX queue is full in non-blocking mode,
+  // which callers keeping fewer batches in flight than its depth never see.
   // Drop the batch gracefully — the synthesizer clock keeps running and
   // playback resumes on the next iteration. Any other error is a real fault.
   if (err == ESP_ERR_INVALID_STATE) {
@@ -154,10 +162,36 @@ void pulse_write(const midisynth::Pulse *pulse, size_t len, uint8_t ch) {
     static uint32_t drops = 0;
     ESP_LOGW(TAG, "RMT queue full, dropping batch (ch=%u, total=%lu)", ch, ++drops);
 #endif
-  } else {
-    ESP_ERROR_CHECK(err);
+    return false;
+  }
+  ESP_ERROR_CHECK(err);
+  return true;
+}
+
+#if CONFIG_TESLASYNTH_RMT_PULL
+void set_source(SymbolSource s) { source = s; }
+
+bool stream_write(Duration32 length, uint8_t ch) {
+  if (length.is_zero() || channels[ch] == nullptr || source == nullptr)
+    return false;
+
+  auto &stream = lengths[ch];
+  uint32_t &slot = stream.slots[stream.next];
+  slot = length.micros();
+  esp_err_t err = rmt_transmit(channels[ch], encoders[ch], &slot, sizeof(slot), &tx_config);
+  if (err == ESP_ERR_INVALID_STATE) {
+    // Same as a dropped batch, the slot is reused by the next transmission
+#if CONFIG_TESLASYNTH_DEBUG
+    static uint32_t drops = 0;
+    ESP_LOGW(TAG, "RMT queue full, dropping stream (ch=%u, total=%lu)", ch, ++drops);
+#endif
+    return false;
   }
+  ESP_ERROR_CHECK(err);
+  stream.next = (stream.next + 1) % stream.slots.size();
+  return true;
 }
+#endif
 } // namespace teslasynth::app::devices::rmt
 
 #endif
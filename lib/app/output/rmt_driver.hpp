@@ -4,10 +4,52 @@
 #pragma once
 
 #include "midi_synth.hpp"
+#include "sdkconfig.h"
 #include <cstddef>
 
 namespace teslasynth::app::devices::rmt {
-void pulse_write(const midisynth::Pulse *pulse, size_t len, uint8_t ch = 0);
+/// Transmissions an output can have queued at once
+constexpr size_t queue_depth = 10;
+
+/// Whether output `ch` has a pin, writes to the others are never queued
+bool connected(uint8_t ch);
+
+/**
+ * Queues RMT symbols, as midisynth::RmtSymbolCompiler makes them, for
+ * transmission on an output. They are read until the transmission is done.
+ *
+ * @return whether a transmission was queued, which is then reported done
+ */
+bool symbols_write(const midisynth::RmtSymbolEncoder::Symbol *symbols, size_t len,
+                   uint8_t ch = 0);
+
+/**
+ * Called from the RMT interrupt when a transmission of output `ch` is done,
+ * in the order they were queued. Returns whether it woke a higher priority task.
+ */
+using TransmitDone = bool (*)(uint8_t ch);
+void set_on_done(TransmitDone on_done);
+
+#if CONFIG_TESLASYNTH_RMT_PULL
+/**
+ * Renders up to `free` symbols of output `ch` and returns how many it wrote,
+ * setting `done` once the transmission's `length` is covered. A transmission
+ * starts with `written` at zero.
+ *
+ * Called from the RMT interrupt whenever symbol memory frees up.
+ */
+using SymbolSource = size_t (*)(uint8_t ch, midisynth::Duration32 length, size_t written,
+                                midisynth::RmtSymbolEncoder::Symbol *symbols, size_t free,
+                                bool &done);
+void set_source(SymbolSource source);
+/**
+ * Queues `length` of an output, rendered by the source while it is transmitted
+ *
+ * @return false if it was dropped, as the queue is full
+ */
+bool stream_write(midisynth::Duration32 length, uint8_t ch = 0);
+#endif
+
 void enable(void);
 void disable(void);
 } // namespace teslasynth::app::devices::rmt
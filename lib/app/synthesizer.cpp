@@ -3,18 +3,28 @@
 
 #include "application.hpp"
 #include "configuration/hardware.hpp"
+#include "devices/midi.hpp"
 #include "esp_log.h"
 #include "esp_task_wdt.h"
 #include "esp_timer.h"
+#include "event_queue.hpp"
 #include "freertos/idf_additions.h"
 #include "midi_core.hpp"
-#include "midi_parser.hpp"
+#include "midi_frame.hpp"
 #include "midi_synth.hpp"
 #include "output/rmt_driver.hpp"
+#include "output_cursor.hpp"
 #include "portmacro.h"
+#include "render_cadence.hpp"
+#include "render_partition.hpp"
+#include "render_profile.hpp"
+#include "transmit_slots.hpp"
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <optional>
 #include <stddef.h>
 
 namespace teslasynth::app::synth {
@@ -26,82 +36,271 @@ namespace {
 constexpr char TAG[] = "SYNTH";
 PlaybackHandle playback;
 StreamBufferHandle_t stream;
+// Received messages from the input task to the first render worker
+EventQueue<256> events;
+
+#if CONFIG_TESLASYNTH_PARALLEL_RENDER
+constexpr uint8_t render_workers =
+    std::min<uint8_t>(CONFIG_FREERTOS_NUMBER_OF_CORES, OutputConfig::size);
+#else
+constexpr uint8_t render_workers = 1;
+#endif
+
+// Notification bits that wake render workers before their period is over
+constexpr uint32_t input_received = 1 << 0;
+constexpr uint32_t note_started = 1 << 1;
+TaskHandle_t workers[render_workers];
 
 void input(void *) {
-  MidiChannelMessage msg;
-  MidiParser parser([&](const MidiChannelMessage msg) {
-    auto now = Duration64::micros(esp_timer_get_time());
-    playback.handle(msg, now);
-  });
-  uint8_t buffer[256];
+  uint8_t buffer[devices::midi::max_chunk];
   while (true) {
-    size_t read = xStreamBufferReceive(stream, buffer, sizeof(buffer), portMAX_DELAY);
+    size_t read = xMessageBufferReceive(stream, buffer, sizeof(buffer), portMAX_DELAY);
+    if (read == 0)
+      continue;
 
-    if (read) {
-      playback.acquire();
-      parser.feed(buffer, read);
-      playback.release();
-    }
+    ScopeTimer<CpuCycles> timer(playback.profile().timing(Stage::Parse));
+    bool received = false, starts = false;
+    // Every event keeps the time its transport stamped it with
+    read_frames(buffer, read, [&](const TimedChannelMessage &e) {
+      if (!events.push(e))
+        playback.profile().input_dropped.fetch_add(1, std::memory_order_relaxed);
+      received = true;
+      starts |= e.message.type == MidiMessageType::NoteOn && e.message.data1 > 0;
+    });
+    if (!received)
+      continue;
+    // Workers are woken once per chunk rather than once per message
+    for (auto worker : workers)
+      if (worker != nullptr)
+        xTaskNotify(worker, input_received | (starts ? note_started : 0), eSetBits);
+  }
+}
+
+#if CONFIG_TESLASYNTH_RMT_PULL
+// Each output's transmissions run one at a time, so they share a cursor
+std::array<OutputCursor<RmtSymbolCompiler>, OutputConfig::size> cursors = [] {
+  std::array<OutputCursor<RmtSymbolCompiler>, OutputConfig::size> res;
+  for (uint8_t ch = 0; ch < OutputConfig::size; ch++)
+    res[ch] = OutputCursor<RmtSymbolCompiler>(ch);
+  return res;
+}();
+
+size_t pull(uint8_t ch, Duration32 length, size_t written, RmtSymbolCompiler::Symbol *symbols,
+            size_t free, bool &done) {
+  auto &cursor = cursors[ch];
+  if (written == 0)
+    cursor.start(length);
+  auto &profile = playback.profile();
+  ScopeTimer<CpuCycles> timer(profile.timing(Stage::Render));
+  const size_t res = playback.pull(cursor, symbols, free);
+  done = cursor.done();
+  profile.symbols.record(res);
+  return res;
+}
+#else
+constexpr size_t render_depth = CONFIG_TESLASYNTH_RENDER_BUFFERS;
+static_assert(render_depth <= devices::rmt::queue_depth,
+              "every rendered block fits in the RMT queue, none is dropped");
+static_assert(render_depth >= 2, "a block is rendered while the one before it still plays");
+
+// Each output renders into its next free buffer while the hardware still reads
+// the others. Workers only touch the channels of their own range.
+std::array<PulseBuffer<OutputConfig::size, 64, RmtSymbolCompiler>, render_depth> buffers;
+std::array<TransmitSlots<render_depth>, OutputConfig::size> slots;
+SemaphoreHandle_t slot_freed[render_workers];
+
+uint8_t worker_of(uint8_t ch) {
+  for (uint8_t worker = 0; worker < render_workers; worker++)
+    if (partition_outputs(OutputConfig::size, render_workers, worker).contains(ch))
+      return worker;
+  return 0;
+}
+
+bool transmit_done(uint8_t ch) {
+  slots[ch].release();
+  BaseType_t woken = pdFALSE;
+  xSemaphoreGiveFromISR(slot_freed[worker_of(ch)], &woken);
+  return woken == pdTRUE;
+}
+
+/// The buffer output `ch` renders into next, waits while the hardware reads all of them
+PulseBuffer<OutputConfig::size, 64, RmtSymbolCompiler> &next_buffer(uint8_t worker, uint8_t ch) {
+  auto slot = slots[ch].next();
+  while (!slot) {
+    xSemaphoreTake(slot_freed[worker], pdMS_TO_TICKS(10));
+    slot = slots[ch].next();
   }
+  return buffers[*slot];
 }
+#endif
 
 void output(void *pvParams) {
+  const uint8_t worker = reinterpret_cast<uintptr_t>(pvParams);
+  const OutputRange range = partition_outputs(OutputConfig::size, render_workers, worker);
+
   ESP_ERROR_CHECK(esp_task_wdt_add(NULL));
   ESP_ERROR_CHECK(esp_task_wdt_status(NULL));
 
-  constexpr TickType_t loopTime = pdMS_TO_TICKS(10);
-  TickType_t lastTime = xTaskGetTickCount();
+  constexpr uint32_t min_period_us = CONFIG_TESLASYNTH_RENDER_MIN_PERIOD_MS * 1000;
+  constexpr TickType_t min_wait = std::max<TickType_t>(1, pdMS_TO_TICKS(min_period_us / 1000));
+  // Waiting for input, well within the task watchdog's timeout
+  constexpr TickType_t idle_wait = pdMS_TO_TICKS(500);
+  RenderCadence cadence({
+      .min_period = Duration16::micros(min_period_us),
+      .max_period = Duration16::micros(CONFIG_TESLASYNTH_RENDER_MAX_PERIOD_MS * 1000),
+  });
+  std::optional<Duration16> wait;
+  TickType_t last = xTaskGetTickCount();
 
-  int64_t processed = esp_timer_get_time();
-  PulseBuffer<OutputConfig::size, 64> buffer;
+  // Queued blocks last a minimum period longer than each wait
+  RenderAhead ahead(Duration16::micros(min_period_us));
+  bool saturated = false;
+  auto &profile = playback.profile();
 
   while (true) {
-    vTaskDelayUntil(&lastTime, loopTime);
+    // Input cuts the wait short, but blocks are never shorter than the minimum period
+    const TickType_t period =
+        wait ? std::max<TickType_t>(1, pdMS_TO_TICKS(wait->micros() / 1000)) : idle_wait;
+    uint32_t notified = 0;
+    const TickType_t waited = xTaskGetTickCount() - last;
+    if (waited < period)
+      xTaskNotifyWait(0, UINT32_MAX, &notified, period - waited);
+    const TickType_t early = xTaskGetTickCount() - last;
+    if (early < min_wait)
+      vTaskDelay(min_wait - early);
+    last = xTaskGetTickCount();
     esp_task_wdt_reset();
 
-    playback.acquire();
-    auto now = esp_timer_get_time();
-    auto left = now - processed;
-    auto budget = Duration16::micros(
-        static_cast<uint16_t>(std::min<int64_t>(left, std::numeric_limits<uint16_t>::max())));
-    playback.sample_all(budget, buffer);
-    playback.release();
+#if !CONFIG_TESLASYNTH_RMT_PULL
+    // Before taking any lock, as the hardware may be a whole pool of blocks behind
+    std::array<PulseBuffer<OutputConfig::size, 64, RmtSymbolCompiler> *, OutputConfig::size>
+        rendering{};
+    for (uint8_t ch = range.first; ch < range.end(); ch++)
+      rendering[ch] = &next_buffer(worker, ch);
+#endif
+    // Waiting for the hardware isn't making the block
+    const uint32_t started = CpuCycles::now();
 
-    for (uint8_t ch = 0; ch < buffer.outputs; ch++) {
-      devices::rmt::pulse_write(&buffer.data(ch), buffer.data_size(ch), ch);
+    // The first worker consumes the input queue. Applying messages touches every output, so it
+    // holds all the locks while it does, then only its own range like every other worker.
+    const bool drains = worker == 0;
+#if CONFIG_TESLASYNTH_RMT_PULL
+    // The locks are spinlocks that keep interrupts off, so they're taken one message at a time
+    if (drains) {
+      ScopeTimer<CpuCycles> timer(profile.timing(Stage::Handle));
+      events.drain([](const TimedChannelMessage &e) {
+        playback.acquire();
+        playback.handle(e.message, Duration64::micros(e.time_us));
+        playback.release();
+      });
+      // The notes a channel mode message released may have died out since
+      if (playback.stopping()) {
+        playback.acquire();
+        playback.stop_when_silent();
+        playback.release();
+      }
     }
+#else
+    // Only while handling, the other workers render their outputs meanwhile. The notes a channel
+    // mode message released may have died out since, which only stops the track with every lock.
+    if (drains && (!events.empty() || playback.stopping())) {
+      ScopeTimer<CpuCycles> timer(profile.timing(Stage::Handle));
+      playback.acquire();
+      events.drain([](const TimedChannelMessage &e) {
+        playback.handle(e.message, Duration64::micros(e.time_us));
+      });
+      playback.stop_when_silent();
+      playback.release();
+    }
+#endif
+    const OutputRange held = range;
+    playback.acquire(held);
+    // The next wait is picked before rendering, so the block can last through it
+    const auto now = static_cast<uint64_t>(esp_timer_get_time());
+#if !CONFIG_TESLASYNTH_RMT_PULL
+    // The slots know better than the clock when the hardware went idle
+    if (std::all_of(slots.begin() + range.first, slots.begin() + range.end(),
+                    [](const auto &slot) { return slot.in_flight() == 0; }))
+      ahead.drained();
+#endif
+    const auto next_edge = playback.next_edge(range);
+    const BlockReport report{
+        .playing = playback.is_playing(),
+        .note_started = (notified & note_started) != 0,
+        .saturated = saturated,
+        .next_edge = next_edge ? std::optional(Duration32::micros(
+                                     std::min<uint64_t>(next_edge->micros(), UINT32_MAX)))
+                               : std::nullopt,
+    };
+    wait = cadence.next(report);
+    // Nothing is queued while idle, the first block after it starts from now
+    const Duration16 budget = wait ? ahead.budget(now, *wait) : Duration16::zero();
+#if CONFIG_TESLASYNTH_RMT_PULL
+    playback.release(held);
 
-    uint32_t took = esp_timer_get_time() - processed;
-    processed = now;
-
-    static size_t counter = 0;
-    static uint32_t min_i, max_i, total = 0;
-    if (counter == 0) {
-      min_i = max_i = took;
-    } else {
-      min_i = std::min(took, min_i);
-      max_i = std::max(took, max_i);
+    // The RMT renders these as it plays them, however many pulses they take
+    bool queued = report.playing;
+    if (report.playing) {
+      ScopeTimer<CpuCycles> timer(profile.timing(Stage::Transmit));
+      for (uint8_t ch = range.first; ch < range.end(); ch++)
+        if (devices::rmt::connected(ch))
+          queued &= devices::rmt::stream_write(budget, ch);
     }
-    total += took;
+#else
+    {
+      ScopeTimer<CpuCycles> timer(profile.timing(Stage::Render));
+      for (uint8_t ch = range.first; ch < range.end(); ch++)
+        playback.sample_range(budget, *rendering[ch], {ch, 1});
+    }
+    playback.release(held);
 
-#if CONFIG_TESLASYNTH_DEBUG
-    if (counter++ % 100 == 0) {
-      ESP_LOGI(TAG, "Render stats, min: %u, max: %u, total: %u, avg: %u, ctr: %u", min_i, max_i,
-               total, total / counter, counter);
+    saturated = false;
+    bool queued = true;
+    {
+      ScopeTimer<CpuCycles> timer(profile.timing(Stage::Transmit));
+      for (uint8_t ch = range.first; ch < range.end(); ch++) {
+        auto &buffer = *rendering[ch];
+        saturated |= buffer.data_size(ch) + RmtSymbolCompiler::max_symbols > buffer.output_bufsize;
+        // Nothing to send takes no slot, so it's never mistaken for back-pressure
+        if (!devices::rmt::connected(ch) || buffer.data_size(ch) == 0)
+          continue;
+        slots[ch].submit();
+        if (!devices::rmt::symbols_write(&buffer.data(ch), buffer.data_size(ch), ch)) {
+          slots[ch].retract();
+          queued = false;
+        }
+      }
     }
+    if (report.playing)
+      for (uint8_t ch = range.first; ch < range.end(); ch++)
+        profile.symbols.record(rendering[ch]->data_size(ch));
 #endif
+    // A dropped block doesn't keep the hardware busy
+    if (wait)
+      wait = std::min(*wait, ahead.queue(now, queued ? budget : Duration16::zero()));
+
+    // Making a block must take less time than playing it, or the outputs fall behind
+    if (report.playing)
+      profile.block(CpuCycles::now() - started, budget.micros() * CpuCycles::per_us);
   }
 }
 } // namespace
 
 StreamBufferHandle_t init(PlaybackHandle handle) {
   ESP_LOGD(TAG, "init");
-  stream = xStreamBufferCreate(1024, 1);
+  stream = xMessageBufferCreate(1024);
   if (stream == nullptr) {
     ESP_LOGE(TAG, "Couldn't allocate BLE stream buffer!");
     return nullptr;
   }
   playback = handle;
+#if CONFIG_TESLASYNTH_RMT_PULL
+  devices::rmt::set_source(pull);
+#else
+  for (auto &freed : slot_freed)
+    freed = xSemaphoreCreateBinary();
+  devices::rmt::set_on_done(transmit_done);
+#endif
 
   constexpr BaseType_t app_core = CONFIG_FREERTOS_NUMBER_OF_CORES > 1 ? 1 : tskNO_AFFINITY;
   constexpr size_t stack_size = 8 * 1024;
@@ -110,10 +309,17 @@ StreamBufferHandle_t init(PlaybackHandle handle) {
     ESP_LOGE(TAG, "Couldn't create Input task!");
     return nullptr;
   }
-  if (xTaskCreatePinnedToCore(output, "Output", stack_size, nullptr, 10, nullptr, app_core) !=
-      pdPASS) {
-    ESP_LOGE(TAG, "Couldn't create Output task!");
-    return nullptr;
+  for (uint8_t worker = 0; worker < render_workers; worker++) {
+    // A single worker stays next to the input task; otherwise one per core
+    const BaseType_t core = render_workers > 1 ? worker : app_core;
+    char name[] = "Output0";
+    name[6] += worker;
+    if (xTaskCreatePinnedToCore(output, name, stack_size,
+                                reinterpret_cast<void *>(uintptr_t{worker}), 10, &workers[worker],
+                                core) != pdPASS) {
+      ESP_LOGE(TAG, "Couldn't create Output task!");
+      return nullptr;
+    }
   }
 
   return stream;
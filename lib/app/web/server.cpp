@@ -69,6 +69,55 @@ esp_err_t sysinfo_handler(httpd_req_t *req) {
   return ESP_OK;
 }
 
+helpers::JSONEncoder encode(const RenderProfile &profile) {
+  helpers::JSONEncoder encoder;
+  auto root = encoder.object();
+  auto stages = root.add_object("stages");
+  for (size_t i = 0; i < midisynth::stages; i++) {
+    const auto &timing = profile.timings[i];
+    auto stage = stages.add_object(midisynth::stage_names[i]);
+    stage.add("count", timing.count());
+    stage.add("p50-us", timing.percentile(50) / CpuCycles::per_us);
+    stage.add("p99-us", timing.percentile(99) / CpuCycles::per_us);
+    stage.add("max-us", timing.max() / CpuCycles::per_us);
+    // Bucket b counts cycles from 2^(b-1) to 2^b - 1
+    auto buckets = stage.add_array("buckets");
+    for (size_t b = 0; b < Histogram::buckets; b++)
+      buckets.add(static_cast<int>(timing.bucket(b)));
+  }
+  auto symbols = root.add_object("symbols");
+  symbols.add("p50", profile.symbols.percentile(50));
+  symbols.add("p99", profile.symbols.percentile(99));
+  symbols.add("max", profile.symbols.max());
+  root.add("cycles-per-us", CpuCycles::per_us);
+  root.add("deadline-misses", profile.deadline_misses.load());
+  root.add("input-dropped", profile.input_dropped.load());
+  if constexpr (EngineCounters::enabled) {
+    auto outputs = root.add_array("outputs");
+    for (uint8_t ch = 0; ch < configuration::hardware::OutputConfig::size; ch++) {
+      const auto stats = ui.engine_stats(ch);
+      auto output = outputs.add_object();
+      output.add("pulses", stats.pulses);
+      output.add("skipped", stats.skipped);
+      output.add("limited", stats.limited);
+      output.add("limited-on-us", static_cast<double>(stats.limited_on_us));
+      output.add("steals", stats.steals);
+      output.add("peak-voices", stats.peak_voices);
+      output.add("dropped", stats.dropped);
+    }
+  }
+  return encoder;
+}
+
+// The server only runs in maintenance mode, which never renders, so this profile stays empty.
+// Shows are profiled with the `stats` console command, as the console runs in both modes.
+esp_err_t sysstats_handler(httpd_req_t *req) {
+  httpd_resp_set_type(req, "application/json");
+  auto json = encode(ui.render_profile()).print();
+  httpd_resp_sendstr(req, json.value);
+  return ESP_OK;
+}
+
 esp_err_t sys_reboot_handler(httpd_req_t *) {
   esp_restart();
 }
@@ -274,6 +323,10 @@ constexpr Resource resources[] = {
         .uri = "/api/sys/info",
         .get = sysinfo_handler,
     },
+    {
+        .uri = "/api/sys/stats",
+        .get = sysstats_handler,
+    },
     {
         .uri = "/api/sys/reboot",
         .post = sys_reboot_handler,
@@ -0,0 +1,47 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ble_midi.hpp"
+#include <cstdint>
+
+namespace teslasynth::midi {
+
+int64_t BleMidiClock::unwrap(uint16_t timestamp, int64_t near) {
+  int64_t diff = ((timestamp - near) % timestamp_wrap + timestamp_wrap) % timestamp_wrap;
+  if (diff > timestamp_wrap / 2)
+    diff -= timestamp_wrap;
+  return near + diff;
+}
+
+void BleMidiClock::sync(uint16_t timestamp, uint64_t arrival_us) {
+  if (!_synced) {
+    _synced = true;
+    _sender_ms = timestamp % timestamp_wrap;
+    _arrival_us = arrival_us;
+    _leak = 0;
+    _offset_us = static_cast<int64_t>(arrival_us) - _sender_ms * 1000;
+    return;
+  }
+
+  // Where the time passed on our clock puts the sender now
+  const uint64_t elapsed_us = arrival_us > _arrival_us ? arrival_us - _arrival_us : 0;
+  _sender_ms = unwrap(timestamp, _sender_ms + static_cast<int64_t>(elapsed_us / 1000));
+  _arrival_us = arrival_us;
+
+  _leak += elapsed_us * _drift_ppm;
+  _offset_us += static_cast<int64_t>(_leak / 1'000'000);
+  _leak %= 1'000'000;
+
+  const int64_t observed = static_cast<int64_t>(arrival_us) - _sender_ms * 1000;
+  if (observed < _offset_us || observed - _offset_us > _max_delay_us) {
+    _offset_us = observed;
+    _leak = 0;
+  }
+}
+
+uint64_t BleMidiClock::map(uint16_t timestamp) const {
+  const int64_t res = unwrap(timestamp, _sender_ms) * 1000 + _offset_us;
+  return res > 0 ? static_cast<uint64_t>(res) : 0;
+}
+
+} // namespace teslasynth::midi
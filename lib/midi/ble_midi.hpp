@@ -0,0 +1,215 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "midi_core.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace teslasynth::midi {
+
+/**
+ * Maps the 13 bit millisecond timestamps of a BLE-MIDI sender onto our own
+ * microsecond clock.
+ *
+ * Timestamps are unwrapped using the time that passed between arrivals, so
+ * gaps longer than the 8192ms wrap are still placed right. A message can't
+ * arrive before it is sent, so the smallest arrival - send difference seen is
+ * the best estimate of the clock offset, and mapped times keep the sender's
+ * spacing instead of the connection interval's jitter. The estimate leaks up
+ * by `drift_ppm` of the elapsed time so it follows the two clocks drifting
+ * apart, and it is reset if the sender falls more than `max_delay_us` behind.
+ */
+class BleMidiClock {
+  int64_t _offset_us = 0, _sender_ms = 0;
+  uint64_t _arrival_us = 0, _leak = 0;
+  uint32_t _drift_ppm, _max_delay_us;
+  bool _synced = false;
+
+  /// The unwrapped sender time of `timestamp` closest to `near`
+  static int64_t unwrap(uint16_t timestamp, int64_t near);
+
+public:
+  static constexpr uint16_t timestamp_wrap = 1 << 13;
+
+  explicit BleMidiClock(uint32_t drift_ppm = 200, uint32_t max_delay_us = 500'000)
+      : _drift_ppm(drift_ppm), _max_delay_us(max_delay_us) {}
+
+  /**
+   * Updates the estimate with the newest timestamp of a packet
+   *
+   * @param timestamp Sender time in milliseconds, modulo timestamp_wrap
+   * @param arrival_us Our time when the packet arrived
+   */
+  void sync(uint16_t timestamp, uint64_t arrival_us);
+
+  /// Our time the sender sent `timestamp` at, for timestamps near the last synced one
+  uint64_t map(uint16_t timestamp) const;
+
+  constexpr bool synced() const { return _synced; }
+  /// Current estimate of our time minus the sender's, in microseconds
+  constexpr int64_t offset() const { return _offset_us; }
+  /// Forgets the sender, for a new connection
+  void reset() { _synced = false; }
+};
+
+/**
+ * Decodes BLE-MIDI packets ("MIDI over Bluetooth Low Energy" v1.0a) into
+ * channel messages stamped with the time they were sent on our clock.
+ *
+ * A packet is a header byte carrying the timestamp's upper 6 bits, then
+ * messages each preceded by a timestamp byte with its lower 7 bits. Running
+ * status messages may follow with or without their own timestamp byte. A
+ * lower timestamp smaller than the one before it in the packet means the
+ * timestamp wrapped. System exclusive may span packets and is skipped, like
+ * every other system message; real time messages don't cancel running
+ * status.
+ *
+ * ON_MESSAGE is called as on_message(timed_message) for every channel
+ * message, held by value and called directly like MidiParser's.
+ */
+template <class ON_MESSAGE> class BleMidiDecoder {
+  ON_MESSAGE _on_message;
+  BleMidiClock _clock;
+  MidiMessageType _type;
+  MidiChannelNumber _channel;
+  MidiData _data0;
+  bool _has_status = false, _has_data = false, _in_sysex = false;
+
+  constexpr bool single_data() const {
+    return _type == MidiMessageType::ProgramChange || _type == MidiMessageType::AfterTouchChannel;
+  }
+
+  inline void status(uint8_t byte);
+  inline void data(uint8_t byte, uint64_t time_us);
+
+  /**
+   * Splits a packet into timestamps, status and data bytes: after the header,
+   * a byte with bit 7 set is a timestamp unless it follows one
+   *
+   * @return false as soon as on_data does
+   */
+  template <class TIMESTAMP, class STATUS, class DATA>
+  static bool walk(const uint8_t *packet, size_t len, TIMESTAMP &&on_timestamp,
+                   STATUS &&on_status, DATA &&on_data);
+
+public:
+  explicit BleMidiDecoder(ON_MESSAGE on_message = {}, BleMidiClock clock = BleMidiClock())
+      : _on_message(std::move(on_message)), _clock(clock) {}
+
+  /**
+   * Decodes one characteristic write
+   *
+   * @param arrival_us Our time when the packet arrived
+   * @return false if it isn't a BLE-MIDI packet; messages decoded before a
+   * malformed byte are still delivered
+   */
+  bool decode(const uint8_t *packet, size_t len, uint64_t arrival_us);
+
+  const BleMidiClock &clock() const { return _clock; }
+
+  /// Forgets the running status, an unfinished sysex and the sender's clock
+  void reset() {
+    _clock.reset();
+    _has_status = _has_data = _in_sysex = false;
+  }
+};
+
+template <class ON_MESSAGE> void BleMidiDecoder<ON_MESSAGE>::status(uint8_t byte) {
+  const MidiStatus status(byte);
+  if (status.is_system_realtime())
+    return;
+  _in_sysex = byte == 0xF0;
+  _has_data = false;
+  _has_status = status.is_channel();
+  if (_has_status) {
+    _type = status.channel_status_type();
+    _channel = status.channel();
+  }
+}
+
+template <class ON_MESSAGE>
+void BleMidiDecoder<ON_MESSAGE>::data(uint8_t byte, uint64_t time_us) {
+  if (_in_sysex || !_has_status)
+    return;
+  if (!_has_data && !single_data()) {
+    _data0 = MidiData(byte);
+    _has_data = true;
+    return;
+  }
+  _on_message(TimedChannelMessage{
+      .time_us = time_us,
+      .message =
+          {
+              .type = _type,
+              .channel = _channel,
+              .data0 = _has_data ? _data0 : MidiData(byte),
+              .data1 = _has_data ? MidiData(byte) : MidiData(),
+          },
+  });
+  _has_data = false;
+}
+
+template <class ON_MESSAGE>
+template <class TIMESTAMP, class STATUS, class DATA>
+bool BleMidiDecoder<ON_MESSAGE>::walk(const uint8_t *packet, size_t len, TIMESTAMP &&on_timestamp,
+                                      STATUS &&on_status, DATA &&on_data) {
+  uint8_t high = packet[0] & 0x3F, last_low = 0;
+  bool has_timestamp = false, after_timestamp = false;
+  for (size_t i = 1; i < len; i++) {
+    const uint8_t byte = packet[i];
+    if (!MidiStatus::is_status(byte)) {
+      if (!on_data(byte, after_timestamp))
+        return false;
+      after_timestamp = false;
+    } else if (after_timestamp) {
+      on_status(byte);
+      after_timestamp = false;
+    } else {
+      const uint8_t low = byte & 0x7F;
+      if (has_timestamp && low < last_low)
+        high = (high + 1) & 0x3F;
+      last_low = low;
+      has_timestamp = after_timestamp = true;
+      on_timestamp(static_cast<uint16_t>(high << 7 | low));
+    }
+  }
+  return true;
+}
+
+template <class ON_MESSAGE>
+bool BleMidiDecoder<ON_MESSAGE>::decode(const uint8_t *packet, size_t len, uint64_t arrival_us) {
+  // The header has bit 7 set and bit 6 clear
+  if (len < 2 || (packet[0] & 0xC0) != 0x80)
+    return false;
+
+  // The last message of a packet is the latest sent, so it is the one that
+  // tells the most about the clock offset
+  bool has_timestamp = false;
+  uint16_t last = 0;
+  walk(
+      packet, len,
+      [&](uint16_t timestamp) {
+        has_timestamp = true;
+        last = timestamp;
+      },
+      [](uint8_t) {}, [](uint8_t, bool) { return true; });
+  if (has_timestamp)
+    _clock.sync(last, arrival_us);
+
+  uint64_t time_us = has_timestamp ? _clock.map(last) : arrival_us;
+  return walk(
+      packet, len, [&](uint16_t timestamp) { time_us = _clock.map(timestamp); },
+      [&](uint8_t byte) { status(byte); },
+      [&](uint8_t byte, bool after_timestamp) {
+        // A timestamp can't split a message
+        if (after_timestamp && _has_data)
+          return false;
+        data(byte, time_us);
+        return true;
+      });
+}
+
+} // namespace teslasynth::midi
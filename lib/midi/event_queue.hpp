@@ -0,0 +1,76 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "midi_core.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace teslasynth::midi {
+
+/**
+ * Wait-free single-producer/single-consumer ring of timed channel messages.
+ *
+ * Exactly one task may push and exactly one task may pop. Neither side ever
+ * blocks: push fails when the ring is full (and counts the drop), pop fails
+ * when it is empty. CAPACITY must be a power of two; indices run freely and
+ * are masked on access.
+ */
+template <size_t CAPACITY> class EventQueue {
+  static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0,
+                "capacity must be a power of two");
+  static constexpr uint32_t mask = CAPACITY - 1;
+
+  TimedChannelMessage _events[CAPACITY];
+  std::atomic<uint32_t> _head{0}; // written by the consumer only
+  std::atomic<uint32_t> _tail{0}; // written by the producer only
+  std::atomic<uint32_t> _dropped{0};
+
+public:
+  static constexpr size_t capacity = CAPACITY;
+
+  /// Producer side; false if the ring is full and the message was dropped
+  bool push(const TimedChannelMessage &event) {
+    const uint32_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail - _head.load(std::memory_order_acquire) == CAPACITY) {
+      _dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    _events[tail & mask] = event;
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Consumer side; false if the ring is empty
+  bool pop(TimedChannelMessage &event) {
+    const uint32_t head = _head.load(std::memory_order_relaxed);
+    if (head == _tail.load(std::memory_order_acquire))
+      return false;
+    event = _events[head & mask];
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Consumer side; hands every message queued so far to `f`, returns how many
+  template <class F> size_t drain(F &&f) {
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    const uint32_t tail = _tail.load(std::memory_order_acquire);
+    const size_t count = tail - head;
+    for (; head != tail; head++) {
+      f(static_cast<const TimedChannelMessage &>(_events[head & mask]));
+      _head.store(head + 1, std::memory_order_release);
+    }
+    return count;
+  }
+
+  /// Approximate when read from the producer side
+  size_t size() const {
+    return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+  }
+  bool empty() const { return size() == 0; }
+  uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+};
+
+} // namespace teslasynth::midi
@@ -229,4 +229,10 @@ struct MidiChannelMessage {
   constexpr bool is_channel_mode_control() const { return is_control() && data0 >= 120; }
 };
 
+/// Channel message stamped with its absolute time in microseconds
+struct TimedChannelMessage {
+  uint64_t time_us;
+  MidiChannelMessage message;
+};
+
 } // namespace teslasynth::midi
@@ -0,0 +1,138 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "midi_core.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace teslasynth::midi {
+
+/**
+ * Compact framing of timed channel messages, so a transport can hand a chunk
+ * of them to the synth task with the time each one arrived.
+ *
+ * A frame is the time since the previous frame of the chunk in microseconds,
+ * as an unsigned LEB128 varint, followed by the message's status byte and its
+ * one or two data bytes. The first frame counts from zero, so it carries the
+ * absolute time and every chunk stands on its own. Messages close together
+ * take a one byte delta, a whole note on takes four bytes.
+ */
+class FrameWriter {
+  uint8_t *_out;
+  size_t _capacity, _size = 0;
+  uint64_t _last_us = 0;
+
+public:
+  /// A 64 bit varint, a status and two data bytes
+  static constexpr size_t max_frame_size = 13;
+
+  FrameWriter(uint8_t *out, size_t capacity) : _out(out), _capacity(capacity) {}
+
+  /**
+   * Appends a frame. An event older than the one before it is placed at the
+   * same time, since a delta can't go back.
+   *
+   * @return false, leaving the chunk as it was, if the frame doesn't fit
+   */
+  inline bool append(const TimedChannelMessage &event);
+
+  constexpr const uint8_t *data() const { return _out; }
+  constexpr size_t size() const { return _size; }
+  constexpr bool empty() const { return _size == 0; }
+
+  /// Starts a new chunk
+  void clear() {
+    _size = 0;
+    _last_us = 0;
+  }
+};
+
+/// Data bytes that follow the status of a channel message
+constexpr size_t data_size(MidiMessageType type) {
+  return type == MidiMessageType::ProgramChange || type == MidiMessageType::AfterTouchChannel ? 1
+                                                                                              : 2;
+}
+
+bool FrameWriter::append(const TimedChannelMessage &event) {
+  uint8_t frame[max_frame_size];
+  size_t len = 0;
+  uint64_t delta = event.time_us > _last_us ? event.time_us - _last_us : 0;
+  do {
+    frame[len] = delta & 0x7F;
+    delta >>= 7;
+    if (delta != 0)
+      frame[len] |= 0x80;
+    len++;
+  } while (delta != 0);
+
+  const auto &msg = event.message;
+  frame[len++] = MidiStatus(msg.type, msg.channel);
+  frame[len++] = msg.data0;
+  if (data_size(msg.type) == 2)
+    frame[len++] = msg.data1;
+
+  if (len > _capacity - _size)
+    return false;
+  std::memcpy(_out + _size, frame, len);
+  _size += len;
+  if (event.time_us > _last_us)
+    _last_us = event.time_us;
+  return true;
+}
+
+/**
+ * Reads a chunk written by FrameWriter
+ *
+ * ON_EVENT is called as on_event(timed_message) for every frame.
+ *
+ * @return false if the chunk ends inside a frame or a frame isn't a channel
+ * message; frames before it are still delivered
+ */
+template <class ON_EVENT>
+bool read_frames(const uint8_t *data, size_t len, ON_EVENT &&on_event) {
+  uint64_t time_us = 0;
+  size_t at = 0;
+  while (at < len) {
+    uint64_t delta = 0;
+    for (uint8_t shift = 0;; shift += 7) {
+      if (at == len || shift >= 64)
+        return false;
+      const uint8_t byte = data[at++];
+      delta |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+        break;
+    }
+    time_us += delta;
+
+    if (at == len || !MidiStatus::is_status(data[at]))
+      return false;
+    const MidiStatus status(data[at++]);
+    if (!status.is_channel())
+      return false;
+    const MidiMessageType type = status.channel_status_type();
+    const size_t size = data_size(type);
+    if (len - at < size)
+      return false;
+    for (size_t i = 0; i < size; i++)
+      if (MidiStatus::is_status(data[at + i]))
+        return false;
+
+    on_event(TimedChannelMessage{
+        .time_us = time_us,
+        .message =
+            {
+                .type = type,
+                .channel = status.channel(),
+                .data0 = data[at],
+                .data1 = size == 2 ? data[at + 1] : 0,
+            },
+    });
+    at += size;
+  }
+  return true;
+}
+
+} // namespace teslasynth::midi
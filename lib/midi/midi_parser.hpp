@@ -7,22 +7,121 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <utility>
 
 namespace teslasynth::midi {
+/// Type erased message callback, for owners that pick it at runtime
 using ChannelMessageCallback = std::function<void(const MidiChannelMessage &)>;
 
-class MidiParser {
+/// Drops every message, for parsers that are only fed in batches
+struct IgnoreMessages {
+  constexpr void operator()(const MidiChannelMessage &) const {}
+};
+
+/**
+ * Decodes a MIDI byte stream into channel messages, with running status.
+ *
+ * ON_MESSAGE is called as on_message(message) for every complete channel
+ * message. It is held by value and called directly, so a lambda is inlined
+ * into feed() without an allocation or indirect call; the type is deduced
+ * from the constructor argument. MidiParser<> erases it behind a
+ * std::function instead.
+ */
+template <class ON_MESSAGE = ChannelMessageCallback> class MidiParser {
   MidiChannelNumber _current_status_channel;
   MidiMessageType _current_status_type;
   MidiData _data0;
   bool _has_status = false, _waiting_for_data = false, _has_data = false;
-  ChannelMessageCallback _on_channel_message;
+  ON_MESSAGE _on_channel_message;
+
+  /// Consumes one byte, returns true and sets `out` if it completed a message
+  inline bool decode(uint8_t byte, MidiChannelMessage &out);
 
 public:
-  MidiParser(ChannelMessageCallback on_channel_message);
+  MidiParser(ON_MESSAGE on_channel_message = {})
+      : _on_channel_message(std::move(on_channel_message)) {}
   void feed(const uint8_t *input, size_t len);
+
+  /**
+   * Decodes `input` into `out` instead of calling the callback, so a whole
+   * received buffer is parsed in one loop and applied in bulk. Parser state
+   * carries over between feed and feed_batch calls.
+   *
+   * Every message takes at least one byte, so `capacity >= len` always
+   * decodes the whole input; otherwise decoding stops once `out` is full.
+   *
+   * @param consumed Set to the number of bytes decoded, if given
+   * @return number of messages written to `out`
+   */
+  size_t feed_batch(const uint8_t *input, size_t len, MidiChannelMessage *out, size_t capacity,
+                    size_t *consumed = nullptr);
+
   MidiStatus status() const { return MidiStatus(_current_status_type, _current_status_channel); }
   bool has_status() const { return _has_status; }
 };
 
+/// Parser that only decodes with feed_batch
+using BatchMidiParser = MidiParser<IgnoreMessages>;
+
+template <class ON_MESSAGE>
+bool MidiParser<ON_MESSAGE>::decode(uint8_t byte, MidiChannelMessage &out) {
+  if (MidiStatus::is_status(byte)) {
+    auto status = MidiStatus(byte);
+    if (status.is_channel()) {
+      _current_status_channel = status.channel();
+      _current_status_type = status.channel_status_type();
+      _has_status = true;
+      _waiting_for_data = _current_status_type != MidiMessageType::ProgramChange &&
+                          _current_status_type != MidiMessageType::AfterTouchChannel;
+      _has_data = false;
+    } else if (status.is_system_realtime()) {
+
+    } else if (status.is_system()) {
+      _has_status = false;
+    }
+    return false;
+  }
+  if (!_has_status)
+    return false;
+  if (_waiting_for_data) {
+    _data0 = MidiData(byte);
+    _waiting_for_data = false;
+    _has_data = true;
+    return false;
+  }
+  MidiData data0 = _has_data ? _data0 : MidiData(byte),
+           data1 = _has_data ? MidiData(byte) : MidiData();
+  _waiting_for_data = _current_status_type != MidiMessageType::ProgramChange &&
+                      _current_status_type != MidiMessageType::AfterTouchChannel;
+  _has_data = false;
+  out = {
+      .type = _current_status_type,
+      .channel = _current_status_channel,
+      .data0 = data0,
+      .data1 = data1,
+  };
+  return true;
+}
+
+template <class ON_MESSAGE> void MidiParser<ON_MESSAGE>::feed(const uint8_t *input, size_t len) {
+  MidiChannelMessage msg;
+  for (size_t i = 0; i < len; i++)
+    if (decode(input[i], msg))
+      _on_channel_message(msg);
+}
+
+template <class ON_MESSAGE>
+size_t MidiParser<ON_MESSAGE>::feed_batch(const uint8_t *input, size_t len,
+                                          MidiChannelMessage *out, size_t capacity,
+                                          size_t *consumed) {
+  size_t i = 0, count = 0;
+  MidiChannelMessage msg;
+  for (; i < len && count < capacity; i++)
+    if (decode(input[i], msg))
+      out[count++] = msg;
+  if (consumed != nullptr)
+    *consumed = i;
+  return count;
+}
+
 } // namespace teslasynth::midi
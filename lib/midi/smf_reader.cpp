@@ -0,0 +1,260 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "midi_core.hpp"
+#include "smf_reader.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace teslasynth::midi {
+namespace {
+constexpr uint32_t default_tempo = 500'000; // 120 BPM
+
+constexpr uint8_t meta_status = 0xFF;
+constexpr uint8_t meta_tempo = 0x51;
+constexpr uint8_t meta_end_of_track = 0x2F;
+
+class ByteReader {
+  const uint8_t *_pos, *_end;
+
+public:
+  constexpr ByteReader(const uint8_t *begin, const uint8_t *end) : _pos(begin), _end(end) {}
+
+  constexpr const uint8_t *position() const { return _pos; }
+  constexpr size_t remaining() const { return static_cast<size_t>(_end - _pos); }
+  constexpr bool at_end() const { return _pos >= _end; }
+
+  bool u8(uint8_t &out) {
+    if (at_end())
+      return false;
+    out = *_pos++;
+    return true;
+  }
+
+  bool big_endian(size_t bytes, uint32_t &out) {
+    if (remaining() < bytes)
+      return false;
+    out = 0;
+    for (size_t i = 0; i < bytes; i++)
+      out = out << 8 | *_pos++;
+    return true;
+  }
+
+  /// Variable length quantity, at most 4 bytes
+  bool vlq(uint32_t &out) {
+    out = 0;
+    for (int i = 0; i < 4; i++) {
+      uint8_t b;
+      if (!u8(b))
+        return false;
+      out = out << 7 | (b & 0x7F);
+      if (!(b & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  bool skip(size_t bytes) {
+    if (remaining() < bytes)
+      return false;
+    _pos += bytes;
+    return true;
+  }
+};
+
+/// Converts absolute ticks to microseconds, one tempo segment at a time
+class TempoMap {
+  uint64_t _tick = 0, _micros = 0;
+  uint64_t _num, _den;
+  bool _fixed;
+
+  constexpr TempoMap(uint64_t num, uint64_t den, bool fixed)
+      : _num(num), _den(den), _fixed(fixed) {}
+
+public:
+  static constexpr TempoMap metrical(uint16_t ticks_per_beat) {
+    return TempoMap(default_tempo, ticks_per_beat, false);
+  }
+
+  /// SMPTE time ignores tempo events; 29 means 29.97 drop-frame
+  static constexpr TempoMap timecode(uint8_t fps, uint8_t ticks_per_frame) {
+    if (fps == 29)
+      return TempoMap(1'001'000'000, 30'000ull * ticks_per_frame, true);
+    return TempoMap(1'000'000, static_cast<uint64_t>(fps) * ticks_per_frame, true);
+  }
+
+  constexpr uint64_t micros(uint64_t tick) const {
+    return _micros + (tick - _tick) * _num / _den;
+  }
+
+  constexpr void set_tempo(uint64_t tick, uint32_t tempo) {
+    if (_fixed)
+      return;
+    _micros = micros(tick);
+    _tick = tick;
+    _num = tempo;
+  }
+};
+
+struct TrackCursor {
+  ByteReader data;
+  uint64_t tick = 0;
+  uint8_t running_status = 0;
+  bool done = false;
+
+  SmfError advance() {
+    if (data.at_end()) {
+      done = true;
+      return SmfError::None;
+    }
+    uint32_t delta;
+    if (!data.vlq(delta))
+      return SmfError::Truncated;
+    tick += delta;
+    return SmfError::None;
+  }
+
+  SmfError read_event(TempoMap &tempo, const TimedMessageCallback &on_message) {
+    uint8_t status;
+    if (!data.u8(status))
+      return SmfError::Truncated;
+
+    uint8_t first_data = 0;
+    bool has_first_data = false;
+    if (!MidiStatus::is_status(status)) {
+      if (running_status == 0)
+        return SmfError::BadEvent;
+      first_data = status;
+      has_first_data = true;
+      status = running_status;
+    }
+
+    if (status == meta_status) {
+      uint8_t type;
+      uint32_t len;
+      if (!data.u8(type) || !data.vlq(len) || data.remaining() < len)
+        return SmfError::Truncated;
+      if (type == meta_tempo && len >= 3) {
+        const uint8_t *p = data.position();
+        tempo.set_tempo(tick, p[0] << 16 | p[1] << 8 | p[2]);
+      } else if (type == meta_end_of_track) {
+        done = true;
+      }
+      data.skip(len);
+      running_status = 0;
+      return SmfError::None;
+    }
+
+    if (status == 0xF0 || status == 0xF7) {
+      uint32_t len;
+      if (!data.vlq(len) || !data.skip(len))
+        return SmfError::Truncated;
+      running_status = 0;
+      return SmfError::None;
+    }
+
+    const MidiStatus st(status);
+    if (!st.is_channel())
+      return SmfError::BadEvent;
+    running_status = status;
+
+    const auto type = st.channel_status_type();
+    const bool two_bytes =
+        type != MidiMessageType::ProgramChange && type != MidiMessageType::AfterTouchChannel;
+    uint8_t data0 = first_data, data1 = 0;
+    if (!has_first_data && !data.u8(data0))
+      return SmfError::Truncated;
+    if (two_bytes && !data.u8(data1))
+      return SmfError::Truncated;
+
+    on_message({
+        .time_us = tempo.micros(tick),
+        .message = {.type = type, .channel = st.channel(), .data0 = data0, .data1 = data1},
+    });
+    return SmfError::None;
+  }
+};
+} // namespace
+
+const char *smf_error_message(SmfError error) {
+  switch (error) {
+  case SmfError::None:
+    return "no error";
+  case SmfError::NotMidiFile:
+    return "not a standard MIDI file";
+  case SmfError::UnsupportedFormat:
+    return "unsupported MIDI file format";
+  case SmfError::Truncated:
+    return "truncated MIDI file";
+  case SmfError::BadEvent:
+    return "malformed MIDI event";
+  }
+  return "unknown error";
+}
+
+SmfError read_smf(const uint8_t *data, size_t len, const TimedMessageCallback &on_message) {
+  ByteReader file(data, data + len);
+
+  uint32_t header_len, format, tracks_count, division;
+  if (file.remaining() < 4 || std::memcmp(file.position(), "MThd", 4) != 0)
+    return SmfError::NotMidiFile;
+  if (!file.skip(4) || !file.big_endian(4, header_len) || header_len < 6)
+    return SmfError::Truncated;
+  if (!file.big_endian(2, format) || !file.big_endian(2, tracks_count) ||
+      !file.big_endian(2, division) || !file.skip(header_len - 6))
+    return SmfError::Truncated;
+
+  if (format > 1)
+    return SmfError::UnsupportedFormat;
+
+  TempoMap tempo = TempoMap::metrical(1);
+  if (division & 0x8000) {
+    const uint8_t fps = static_cast<uint8_t>(-static_cast<int8_t>(division >> 8));
+    const uint8_t ticks_per_frame = division & 0xFF;
+    if ((fps != 24 && fps != 25 && fps != 29 && fps != 30) || ticks_per_frame == 0)
+      return SmfError::UnsupportedFormat;
+    tempo = TempoMap::timecode(fps, ticks_per_frame);
+  } else {
+    if (division == 0)
+      return SmfError::NotMidiFile;
+    tempo = TempoMap::metrical(division);
+  }
+
+  std::vector<TrackCursor> tracks;
+  tracks.reserve(tracks_count);
+  while (tracks.size() < tracks_count && file.remaining() >= 8) {
+    const bool is_track = std::memcmp(file.position(), "MTrk", 4) == 0;
+    uint32_t chunk_len;
+    if (!file.skip(4) || !file.big_endian(4, chunk_len))
+      return SmfError::Truncated;
+    const uint8_t *chunk = file.position();
+    if (!file.skip(chunk_len))
+      return SmfError::Truncated;
+    if (is_track)
+      tracks.push_back({.data = ByteReader(chunk, chunk + chunk_len)});
+  }
+
+  for (auto &track : tracks)
+    if (auto err = track.advance(); err != SmfError::None)
+      return err;
+
+  // Track counts are small, so a linear scan for the earliest track beats a heap.
+  for (;;) {
+    TrackCursor *next = nullptr;
+    for (auto &track : tracks)
+      if (!track.done && (next == nullptr || track.tick < next->tick))
+        next = &track;
+    if (next == nullptr)
+      return SmfError::None;
+
+    if (auto err = next->read_event(tempo, on_message); err != SmfError::None)
+      return err;
+    if (!next->done)
+      if (auto err = next->advance(); err != SmfError::None)
+        return err;
+  }
+}
+
+} // namespace teslasynth::midi
@@ -0,0 +1,38 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "midi_core.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace teslasynth::midi {
+using TimedMessageCallback = std::function<void(const TimedChannelMessage &)>;
+
+enum class SmfError : uint8_t {
+  None,
+  NotMidiFile,
+  UnsupportedFormat,
+  Truncated,
+  BadEvent,
+};
+
+const char *smf_error_message(SmfError error);
+
+/**
+ * Reads a Standard MIDI File (format 0 or 1) held in memory.
+ *
+ * All tracks are merged in one pass; events on the same tick keep track
+ * order. Tempo changes apply to every track, and times are accumulated per
+ * tempo segment in integer microseconds. Meta events other than tempo and
+ * end-of-track, and sysex, are skipped.
+ *
+ * @param on_message Called for every channel message, in time order
+ * @return SmfError::None on success; messages read before an error are
+ * still delivered
+ */
+SmfError read_smf(const uint8_t *data, size_t len, const TimedMessageCallback &on_message);
+
+} // namespace teslasynth::midi
@@ -12,7 +12,7 @@ using namespace teslasynth::core;
 struct ChannelState {
   PitchBend pitch_bend;
   EnvelopeLevel amplitude = core::EnvelopeLevel::max();
-  float smoothing = 0.1;
+  Arithmetic::Level smoothing = Arithmetic::level(0.1f);
 };
 
 } // namespace teslasynth::synth
@@ -10,62 +10,78 @@
 #include <stdint.h>
 #include <string>
 #include "duration.hpp"
+#include "numeric.hpp"
 
 namespace teslasynth::core {
 
-class EnvelopeLevel {
-  float _value;
+template <class A> class BasicEnvelopeLevel {
+  using Raw = typename A::Level;
+  static constexpr Raw _one = A::level_one;
+  Raw _value;
+
+  static constexpr Raw clamp(Raw v) { return v > _one ? _one : v < 0 ? 0 : v; }
 
 public:
-  constexpr explicit EnvelopeLevel() : _value(0) {}
-  constexpr explicit EnvelopeLevel(float level)
-      : _value(level > 1   ? 1.f
-               : level < 0 ? 0.f
-                           : level) {}
+  constexpr explicit BasicEnvelopeLevel() : _value(0) {}
+  constexpr explicit BasicEnvelopeLevel(float level)
+      : _value(level > 1   ? _one
+               : level < 0 ? 0
+                           : A::level(level)) {}
 
-  constexpr static EnvelopeLevel zero() { return EnvelopeLevel(); }
-  constexpr static EnvelopeLevel max() { return EnvelopeLevel(1); }
-  static EnvelopeLevel logscale(uint8_t value) { return EnvelopeLevel(log2f(1.f + value) / 8.f); }
+  constexpr static BasicEnvelopeLevel zero() { return BasicEnvelopeLevel(); }
+  constexpr static BasicEnvelopeLevel max() { return BasicEnvelopeLevel(1); }
+  static BasicEnvelopeLevel logscale(uint8_t value) {
+    return BasicEnvelopeLevel(log2f(1.f + value) / 8.f);
+  }
+  /// Level from its raw policy representation, clamped to [0, 1]
+  constexpr static BasicEnvelopeLevel from_raw(Raw raw) {
+    BasicEnvelopeLevel l;
+    l._value = clamp(raw);
+    return l;
+  }
+  constexpr Raw raw() const { return _value; }
 
   constexpr bool is_zero() const { return _value == 0; }
-  constexpr EnvelopeLevel operator+(const EnvelopeLevel &b) const {
-    return EnvelopeLevel(_value + b._value);
+  constexpr BasicEnvelopeLevel operator+(const BasicEnvelopeLevel &b) const {
+    return from_raw(_value + b._value);
   }
-  constexpr EnvelopeLevel operator+(float b) const { return EnvelopeLevel(_value + b); }
-  EnvelopeLevel &operator+=(const EnvelopeLevel &b) {
-    if (1.f - _value < b._value)
-      _value = 1.f;
+  constexpr BasicEnvelopeLevel operator+(float b) const {
+    return BasicEnvelopeLevel(A::level_to_float(_value) + b);
+  }
+  BasicEnvelopeLevel &operator+=(const BasicEnvelopeLevel &b) {
+    if (_one - _value < b._value)
+      _value = _one;
     else
       _value += b._value;
     return *this;
   }
-  EnvelopeLevel &operator+=(float b) {
-    _value += b;
-    if (_value > 1.f)
-      _value = 1.f;
-    else if (_value < 0)
-      _value = 0.f;
+  BasicEnvelopeLevel &operator+=(float b) {
+    _value = clamp(_value + A::level(b));
     return *this;
   }
-  float operator-(const EnvelopeLevel &b) const { return _value - b._value; }
+  float operator-(const BasicEnvelopeLevel &b) const {
+    return A::level_to_float(_value - b._value);
+  }
 
   template <typename T> constexpr SimpleDuration<T> operator*(const SimpleDuration<T> &b) const {
-    return b * _value;
+    return SimpleDuration<T>::micros(A::scale(b.micros(), _value));
   }
-  constexpr EnvelopeLevel operator*(const EnvelopeLevel &b) const {
-    return EnvelopeLevel(b._value * _value);
+  constexpr BasicEnvelopeLevel operator*(const BasicEnvelopeLevel &b) const {
+    return from_raw(A::level_mul(_value, b._value));
   }
-  constexpr bool operator<(const EnvelopeLevel &b) const { return _value < b._value; }
-  constexpr bool operator>(const EnvelopeLevel &b) const { return _value > b._value; }
-  constexpr bool operator==(const EnvelopeLevel &b) const {
-    float d = _value - b._value;
+  constexpr bool operator<(const BasicEnvelopeLevel &b) const { return _value < b._value; }
+  constexpr bool operator>(const BasicEnvelopeLevel &b) const { return _value > b._value; }
+  constexpr bool operator==(const BasicEnvelopeLevel &b) const {
+    float d = A::level_to_float(_value - b._value);
     return (d < 0 ? -d : d) < 1e-3f;
   }
-  constexpr bool operator!=(const EnvelopeLevel &b) const { return _value != b._value; }
-  constexpr bool operator<=(const EnvelopeLevel &b) const { return _value <= b._value; }
-  constexpr bool operator>=(const EnvelopeLevel &b) const { return _value >= b._value; }
+  constexpr bool operator!=(const BasicEnvelopeLevel &b) const { return _value != b._value; }
+  constexpr bool operator<=(const BasicEnvelopeLevel &b) const { return _value <= b._value; }
+  constexpr bool operator>=(const BasicEnvelopeLevel &b) const { return _value >= b._value; }
 
-  constexpr operator float() const { return _value; }
-  inline operator std::string() const { return std::to_string(_value); }
+  constexpr operator float() const { return A::level_to_float(_value); }
+  inline operator std::string() const { return std::to_string(A::level_to_float(_value)); }
 };
+
+using EnvelopeLevel = BasicEnvelopeLevel<Arithmetic>;
 } // namespace teslasynth::core
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "duration.hpp"
+#include "numeric.hpp"
 #include <cmath>
 #include <cstdint>
 #include <limits>
@@ -13,50 +14,62 @@
 
 namespace teslasynth::core {
 
-class Hertz {
-  float _value;
+template <class A> class BasicHertz {
+  using Raw = typename A::Frequency;
+  Raw _value;
 
   static constexpr uint32_t _coef_kilo = 1000;
   static constexpr uint32_t _coef_mega = 1000 * _coef_kilo;
 
+  struct RawTag {};
+  constexpr BasicHertz(Raw raw, RawTag) : _value(raw) {}
+
 public:
-  explicit constexpr Hertz(float v) : _value(v) {}
-  static constexpr Hertz kilohertz(uint32_t v) { return Hertz(v * 1000); }
-  static constexpr Hertz megahertz(uint32_t v) { return Hertz(v * 1'000'000); }
+  explicit constexpr BasicHertz(float v) : _value(A::frequency(v)) {}
+  static constexpr BasicHertz kilohertz(uint32_t v) { return BasicHertz(v * 1000); }
+  static constexpr BasicHertz megahertz(uint32_t v) { return BasicHertz(v * 1'000'000); }
+  /// Frequency from its raw policy representation
+  static constexpr BasicHertz from_raw(Raw raw) { return BasicHertz(raw, RawTag{}); }
+  constexpr Raw raw() const { return _value; }
 
-  constexpr Hertz operator+(const Hertz b) const { return Hertz(_value + b._value); }
-  constexpr Hertz operator-(const Hertz b) const { return Hertz(_value - b._value); }
-  constexpr Hertz operator-() const { return Hertz(-_value); }
-  constexpr Hertz operator*(const int b) const { return Hertz(_value * b); }
-  constexpr Hertz operator*(const float b) const { return Hertz(_value * b); }
-  constexpr operator float() const { return _value; }
+  constexpr BasicHertz operator+(const BasicHertz b) const { return from_raw(_value + b._value); }
+  constexpr BasicHertz operator-(const BasicHertz b) const { return from_raw(_value - b._value); }
+  constexpr BasicHertz operator-() const { return from_raw(-_value); }
+  constexpr BasicHertz operator*(const int b) const { return from_raw(_value * b); }
+  constexpr BasicHertz operator*(const float b) const {
+    return from_raw(A::frequency_mul(_value, b));
+  }
+  constexpr operator float() const { return A::frequency_to_float(_value); }
 
-  constexpr bool operator<(const Hertz &b) const { return _value < b._value; }
-  constexpr bool operator>(const Hertz &b) const { return _value > b._value; }
-  constexpr bool operator==(const Hertz &b) const {
-    float d = _value - b._value;
+  constexpr bool operator<(const BasicHertz &b) const { return _value < b._value; }
+  constexpr bool operator>(const BasicHertz &b) const { return _value > b._value; }
+  constexpr bool operator==(const BasicHertz &b) const {
+    float d = A::frequency_to_float(_value - b._value);
     return (d < 0 ? -d : d) < 0.001f;
   }
-  constexpr bool operator!=(const Hertz &b) const {
-    float d = _value - b._value;
+  constexpr bool operator!=(const BasicHertz &b) const {
+    float d = A::frequency_to_float(_value - b._value);
     return (d < 0 ? -d : d) > 0.001f;
   }
-  constexpr bool operator<=(const Hertz &b) const { return _value <= b._value; }
-  constexpr bool operator>=(const Hertz &b) const { return _value >= b._value; }
+  constexpr bool operator<=(const BasicHertz &b) const { return _value <= b._value; }
+  constexpr bool operator>=(const BasicHertz &b) const { return _value >= b._value; }
   constexpr bool is_zero() const { return _value == 0; }
-  constexpr Duration32 period() const { return Duration32::micros(1e6 / _value); }
+  constexpr Duration32 period() const { return Duration32::micros(A::period_us(_value)); }
 
   inline operator std::string() const {
-    if (_value > _coef_mega) {
-      return std::to_string(_value / static_cast<float>(_coef_mega)) + "MHz";
-    } else if (_value > _coef_kilo) {
-      return std::to_string(_value / static_cast<float>(_coef_kilo)) + "KHz";
+    const float value = A::frequency_to_float(_value);
+    if (value > _coef_mega) {
+      return std::to_string(value / static_cast<float>(_coef_mega)) + "MHz";
+    } else if (value > _coef_kilo) {
+      return std::to_string(value / static_cast<float>(_coef_kilo)) + "KHz";
     } else {
-      return std::to_string(_value) + "Hz";
+      return std::to_string(value) + "Hz";
     }
   }
 };
 
+using Hertz = BasicHertz<Arithmetic>;
+
 inline constexpr Hertz operator""_hz(unsigned long long n) {
   return Hertz(static_cast<float>(n));
 }
@@ -0,0 +1,153 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <cstdint>
+
+namespace teslasynth::core {
+
+/**
+ * Arithmetic policies for the synthesis value types.
+ *
+ * A policy defines the raw representation of levels (EnvelopeLevel,
+ * Probability) and frequencies (Hertz), and the few operations the render
+ * path needs on them. Floats stay the default; FixedArithmetic keeps the
+ * per-pulse math in integers for targets without an FPU.
+ */
+
+/// Plain float math, for targets with an FPU and for host tools
+struct FloatArithmetic {
+  using Level = float;
+  using Frequency = float;
+  using Ratio = float;
+  using Slope = float; // Level per microsecond
+
+  static constexpr Level level_one = 1.f;
+
+  static constexpr Level level(float v) { return v; }
+  static constexpr float level_to_float(Level v) { return v; }
+  static constexpr Level level_mul(Level a, Level b) { return a * b; }
+  template <typename T> static constexpr T scale(T value, Level level) {
+    return static_cast<T>(value * level);
+  }
+  /// v times a Q30 fraction
+  static constexpr Level level_fraction(Level v, uint32_t q30) {
+    return v * (q30 * (1.f / (1 << 30)));
+  }
+  /// n / d as a level
+  static constexpr Level level_ratio(uint32_t n, uint32_t d) { return static_cast<float>(n) / d; }
+  static constexpr Slope level_slope(Level from, Level to, uint32_t us) { return (to - from) / us; }
+  /// Level dt further along a ramp of slope s, which reaches target in left microseconds
+  static constexpr Level level_ramp(Level current, [[maybe_unused]] Level target, Slope s,
+                                    uint32_t dt, [[maybe_unused]] uint32_t left) {
+    return current + s * dt;
+  }
+
+  static constexpr Frequency frequency(float hz) { return hz; }
+  static constexpr float frequency_to_float(Frequency f) { return f; }
+  static constexpr Frequency frequency_mul(Frequency f, float b) { return f * b; }
+  /// f times a signed Q15 fraction
+  static constexpr Frequency frequency_fraction(Frequency f, int32_t q15) {
+    return f * (q15 * (1.f / (1 << 15)));
+  }
+  /// a + (b - a) * t
+  static constexpr Frequency frequency_lerp(Frequency a, Frequency b, Level t) {
+    return a * (1.f - t) + b * t;
+  }
+  static constexpr Ratio ratio(float r) { return r; }
+  static constexpr float ratio_to_float(Ratio r) { return r; }
+  static constexpr Frequency frequency_scale(Frequency f, Ratio r) { return f * r; }
+  static constexpr uint32_t period_us(Frequency f) { return 1e6 / f; }
+  /// Phase step per microsecond of an oscillator at f, where 2^64 is a full cycle. Kept in
+  /// double, a float step drifts by milliseconds of phase over hours
+  static constexpr uint64_t phase_step(Frequency f) {
+    return f > 0 ? static_cast<uint64_t>(static_cast<double>(f) * 18446744073709.551616) : 0;
+  }
+};
+
+/// Q15 levels, Q23.8 frequencies and Q4.28 ratios; integer only once values are built
+struct FixedArithmetic {
+  using Level = int32_t;
+  using Frequency = int32_t;
+  using Ratio = int32_t;
+  using Slope = int64_t; // Level per microsecond in Q16
+
+  static constexpr int level_bits = 15;
+  static constexpr int frequency_bits = 8;
+  static constexpr int ratio_bits = 28;
+  static constexpr int slope_bits = 16;
+  static constexpr Level level_one = 1 << level_bits;
+
+  /// Saturates at the int32 range, where converting a float is undefined
+  static constexpr int32_t round(float v) {
+    if (!(v < 2147483648.f))
+      return INT32_MAX;
+    if (v <= -2147483648.f)
+      return INT32_MIN;
+    return static_cast<int32_t>(v < 0 ? v - 0.5f : v + 0.5f);
+  }
+
+  static constexpr Level level(float v) { return round(v * level_one); }
+  static constexpr float level_to_float(Level v) { return v / static_cast<float>(level_one); }
+  static constexpr Level level_mul(Level a, Level b) {
+    return static_cast<Level>((static_cast<int64_t>(a) * b + (1 << (level_bits - 1))) >>
+                              level_bits);
+  }
+  template <typename T> static constexpr T scale(T value, Level level) {
+    return static_cast<T>((static_cast<uint64_t>(value) * static_cast<uint32_t>(level)) >>
+                          level_bits);
+  }
+  static constexpr Level level_fraction(Level v, uint32_t q30) {
+    return static_cast<Level>((static_cast<int64_t>(v) * q30 + (1 << 29)) >> 30);
+  }
+  static constexpr Level level_ratio(uint32_t n, uint32_t d) {
+    return static_cast<Level>(((static_cast<uint64_t>(n) << level_bits) + d / 2) / d);
+  }
+  static constexpr Slope level_slope(Level from, Level to, uint32_t us) {
+    return (static_cast<Slope>(to - from) << slope_bits) / us;
+  }
+  /// Measured back from the target, so rounding doesn't pile up over the pulses of a ramp
+  static constexpr Level level_ramp([[maybe_unused]] Level current, Level target, Slope s,
+                                    [[maybe_unused]] uint32_t dt, uint32_t left) {
+    return target - static_cast<Level>((s * left) >> slope_bits);
+  }
+
+  static constexpr Frequency frequency(float hz) { return round(hz * (1 << frequency_bits)); }
+  static constexpr float frequency_to_float(Frequency f) {
+    return f / static_cast<float>(1 << frequency_bits);
+  }
+  static constexpr Frequency frequency_mul(Frequency f, float b) { return round(f * b); }
+  static constexpr Frequency frequency_fraction(Frequency f, int32_t q15) {
+    return static_cast<Frequency>((static_cast<int64_t>(f) * q15 + (1 << 14)) >> 15);
+  }
+  static constexpr Frequency frequency_lerp(Frequency a, Frequency b, Level t) {
+    return a + frequency_fraction(b - a, t);
+  }
+  static constexpr Ratio ratio(float r) { return round(r * (1 << ratio_bits)); }
+  static constexpr float ratio_to_float(Ratio r) {
+    return r / static_cast<float>(1 << ratio_bits);
+  }
+  static constexpr Frequency frequency_scale(Frequency f, Ratio r) {
+    return static_cast<Frequency>(
+        (static_cast<int64_t>(f) * r + (1 << (ratio_bits - 1))) >> ratio_bits);
+  }
+  static constexpr uint32_t period_us(Frequency f) {
+    if (f <= 0)
+      return UINT32_MAX;
+    return static_cast<uint32_t>((uint64_t{1'000'000} << frequency_bits) /
+                                 static_cast<uint32_t>(f));
+  }
+  static constexpr uint64_t phase_step(Frequency f) {
+    // 2^64 / 1e6 per Hz, which is 2^56 / 1e6 per raw step
+    return f > 0 ? static_cast<uint64_t>(f) * 72'057'594'038ull : 0;
+  }
+};
+
+#ifdef CONFIG_TESLASYNTH_FIXED_POINT
+using Arithmetic = FixedArithmetic;
+#else
+using Arithmetic = FloatArithmetic;
+#endif
+
+} // namespace teslasynth::core
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "numeric.hpp"
 #include <cmath>
 #include <cstdint>
 #include <limits>
@@ -11,52 +12,66 @@
 
 namespace teslasynth::core {
 
-class Probability {
-  float _value;
+template <class A> class BasicProbability {
+  using Raw = typename A::Level;
+  static constexpr Raw _one = A::level_one;
+  Raw _value;
+
+  static constexpr Raw clamp(Raw v) { return v > _one ? _one : v < 0 ? 0 : v; }
 
 public:
-  constexpr explicit Probability() : _value(0) {}
-  constexpr explicit Probability(float level) : _value(level > 1 ? 1.f : level < 0 ? 0.f : level) {}
+  constexpr explicit BasicProbability() : _value(0) {}
+  constexpr explicit BasicProbability(float level)
+      : _value(level > 1 ? _one : level < 0 ? 0 : A::level(level)) {}
 
-  constexpr static Probability zero() { return Probability(); }
-  constexpr static Probability max() { return Probability(1); }
+  constexpr static BasicProbability zero() { return BasicProbability(); }
+  constexpr static BasicProbability max() { return BasicProbability(1); }
+  /// Probability from its raw policy representation, clamped to [0, 1]
+  constexpr static BasicProbability from_raw(Raw raw) {
+    BasicProbability p;
+    p._value = clamp(raw);
+    return p;
+  }
+  constexpr Raw raw() const { return _value; }
 
   constexpr bool is_zero() const { return _value == 0; }
-  constexpr Probability operator+(const Probability &b) const {
-    return Probability(_value + b._value);
+  constexpr BasicProbability operator+(const BasicProbability &b) const {
+    return from_raw(_value + b._value);
+  }
+  constexpr BasicProbability operator+(float b) const {
+    return BasicProbability(A::level_to_float(_value) + b);
   }
-  constexpr Probability operator+(float b) const { return Probability(_value + b); }
-  Probability &operator+=(const Probability &b) {
-    if (1.f - _value < b._value)
-      _value = 1.f;
+  BasicProbability &operator+=(const BasicProbability &b) {
+    if (_one - _value < b._value)
+      _value = _one;
     else
       _value += b._value;
     return *this;
   }
-  Probability &operator+=(float b) {
-    _value += b;
-    if (_value > 1.f)
-      _value = 1.f;
-    else if (_value < 0)
-      _value = 0.f;
+  BasicProbability &operator+=(float b) {
+    _value = clamp(_value + A::level(b));
     return *this;
   }
-  float operator-(const Probability &b) const { return _value - b._value; }
+  float operator-(const BasicProbability &b) const { return A::level_to_float(_value - b._value); }
 
-  constexpr Probability operator*(const Probability &b) const {
-    return Probability(b._value * _value);
+  constexpr BasicProbability operator*(const BasicProbability &b) const {
+    return from_raw(A::level_mul(_value, b._value));
   }
-  constexpr bool operator<(const Probability &b) const { return _value < b._value; }
-  constexpr bool operator>(const Probability &b) const { return _value > b._value; }
-  constexpr bool operator==(const Probability &b) const {
-    float d = _value - b._value;
+  constexpr bool operator<(const BasicProbability &b) const { return _value < b._value; }
+  constexpr bool operator>(const BasicProbability &b) const { return _value > b._value; }
+  constexpr bool operator==(const BasicProbability &b) const {
+    float d = A::level_to_float(_value - b._value);
     return (d < 0 ? -d : d) < 1e-3f;
   }
-  constexpr bool operator!=(const Probability &b) const { return _value != b._value; }
-  constexpr bool operator<=(const Probability &b) const { return _value <= b._value; }
-  constexpr bool operator>=(const Probability &b) const { return _value >= b._value; }
+  constexpr bool operator!=(const BasicProbability &b) const { return _value != b._value; }
+  constexpr bool operator<=(const BasicProbability &b) const { return _value <= b._value; }
+  constexpr bool operator>=(const BasicProbability &b) const { return _value >= b._value; }
 
-  constexpr operator float() const { return _value; }
-  inline operator std::string() const { return std::to_string(_value * 100) + "%"; }
+  constexpr operator float() const { return A::level_to_float(_value); }
+  inline operator std::string() const {
+    return std::to_string(A::level_to_float(_value) * 100) + "%";
+  }
 };
+
+using Probability = BasicProbability<Arithmetic>;
 } // namespace teslasynth::core
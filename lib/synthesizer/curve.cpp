@@ -3,14 +3,50 @@
 
 #include "core.hpp"
 #include "envelope.hpp"
+#include <array>
 #include <cmath>
+#include <cstdint>
 #include <optional>
 
 namespace teslasynth::synth {
 using namespace teslasynth::core;
 
 // -log_e(0.001)
-constexpr float logfactor = 6.907755278982137;
+constexpr double logfactor = 6.907755278982137;
+constexpr uint64_t logfactor_q40 = static_cast<uint64_t>(logfactor * (1ull << 40) + 0.5);
+
+namespace {
+constexpr int decay_step_bits = 6;
+constexpr int decay_frac_bits = 32 - decay_step_bits;
+constexpr uint32_t decay_one = 1u << 30;
+
+// exp(-i / 64) in Q30; a curve never runs past logfactor, the tail is headroom
+constexpr std::array<uint32_t, 8 << decay_step_bits> decay_table = [] {
+  // exp(-1/64) from its Taylor series, the rest are powers of it
+  double step = 0, term = 1;
+  for (int n = 1; n < 12; n++) {
+    step += term;
+    term *= -1.0 / (1 << decay_step_bits) / n;
+  }
+  std::array<uint32_t, 8 << decay_step_bits> table{};
+  double value = 1;
+  for (auto &entry : table) {
+    entry = static_cast<uint32_t>(value * decay_one + 0.5);
+    value *= step;
+  }
+  return table;
+}();
+} // namespace
+
+uint32_t exp_decay(uint64_t x) {
+  const uint64_t i = x >> decay_frac_bits;
+  if (i >= decay_table.size())
+    return 0;
+  // exp(-i/64 - b) = table[i] * exp(-b), with b < 1/64 close enough to 1 - b + b^2/2
+  const uint64_t b = (x & ((1u << decay_frac_bits) - 1)) >> 2;
+  const uint64_t fine = decay_one - b + ((b * b) >> 31);
+  return static_cast<uint32_t>((decay_table[i] * fine + (decay_one >> 1)) >> 30);
+}
 
 Curve::Curve(EnvelopeLevel start, EnvelopeLevel target, Duration32 total, CurveType type)
     : _target(target), _type(type), _total(total), _current(start), _const(false) {
@@ -21,10 +57,10 @@ Curve::Curve(EnvelopeLevel start, EnvelopeLevel target, Duration32 total, CurveT
   } else
     switch (type) {
     case Exp:
-      _state.tau = (float)t / logfactor;
+      _state.rate = logfactor_q40 / t;
       break;
     case Lin:
-      _state.slope = (target - start) / t;
+      _state.slope = Arithmetic::level_slope(start.raw(), target.raw(), t);
       break;
     }
 }
@@ -48,10 +84,18 @@ EnvelopeLevel Curve::update(Duration32 delta) {
     _current = _target;
   } else {
     const auto dt = delta.micros();
-    if (_type == Exp)
-      _current += (_target - _current) * (1 - expf(-(float)dt / _state.tau));
-    else if (_type == Lin)
-      _current += _state.slope * dt;
+    if (_type == Exp) {
+      // The distance to the target shrinks by exp(-dt / tau) on every update
+      if (dt != _last_dt) {
+        _last_dt = dt;
+        _last_keep = exp_decay((dt * _state.rate) >> 8);
+      }
+      _current = EnvelopeLevel::from_raw(
+          _target.raw() - Arithmetic::level_fraction(_target.raw() - _current.raw(), _last_keep));
+    } else if (_type == Lin)
+      _current = EnvelopeLevel::from_raw(
+          Arithmetic::level_ramp(_current.raw(), _target.raw(), _state.slope, dt,
+                                 _total.micros() - _elapsed.micros() - dt));
 
     _elapsed += delta;
     _target_reached = _elapsed >= _total;
@@ -14,10 +14,13 @@ using namespace teslasynth::core;
 
 enum CurveType { Lin, Exp };
 union CurveState {
-  float tau;   // Exp
-  float slope; // Lin
+  uint64_t rate;           // Exp, dt/tau per microsecond in Q40
+  Arithmetic::Slope slope; // Lin
 };
 
+/// exp(-x) for x in Q32, in Q30. Error stays below 1e-6 for x in [0, 8)
+uint32_t exp_decay(uint64_t x);
+
 class Curve {
   EnvelopeLevel _target;
   CurveType _type;
@@ -26,6 +29,8 @@ class Curve {
   Duration32 _elapsed;
   EnvelopeLevel _current;
   CurveState _state;
+  // Pulses of a held note repeat the same period, so the last decay factor is reused
+  uint32_t _last_dt = 0, _last_keep = 1u << 30;
   bool _target_reached = false, _const;
 
 public:
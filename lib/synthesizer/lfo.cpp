@@ -2,18 +2,75 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include "lfo.hpp"
-#include <cmath>
-#include <math.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 
 namespace teslasynth::synth {
 using namespace teslasynth::core;
 
-constexpr float _2pi = 6.2831853071795864769;
+namespace {
+constexpr int sine_bits = 8;
+constexpr double pi = 3.14159265358979323846;
 
-Hertz Vibrato::offset(const Duration &now) {
-  float t = (now.micros() / 1e6f);
-  float phase = fmod(freq * _2pi * t, _2pi);
-  return depth * sinf(phase);
+// One sine cycle in Q15, with the first entry repeated at the end for interpolation
+constexpr std::array<int16_t, (1 << sine_bits) + 1> sine_table = [] {
+  std::array<int16_t, (1 << sine_bits) + 1> table{};
+  for (size_t i = 0; i < table.size(); i++) {
+    double x = 2 * pi * i / (1 << sine_bits);
+    if (x > pi)
+      x -= 2 * pi;
+    double sum = 0, term = x;
+    for (int n = 1; n < 30; n += 2) {
+      sum += term;
+      term *= -x * x / ((n + 1) * (n + 2));
+    }
+    table[i] = static_cast<int16_t>(sum * 32767 + (sum < 0 ? -0.5 : 0.5));
+  }
+  return table;
+}();
+
+Hertz scaled(Hertz depth, int32_t wave) {
+  return Hertz::from_raw(Arithmetic::frequency_fraction(depth.raw(), wave));
+}
+
+uint64_t phase_step(Hertz freq) { return Arithmetic::phase_step(freq.raw()); }
+} // namespace
+
+int32_t lfo_wave(LfoShape shape, uint32_t phase) {
+  switch (shape) {
+  case LfoShape::Sine: {
+    const uint32_t i = phase >> (32 - sine_bits);
+    const int32_t frac = (phase >> (16 - sine_bits)) & 0xFFFF;
+    const int32_t a = sine_table[i], b = sine_table[i + 1];
+    return a + (((b - a) * frac) >> 16);
+  }
+  case LfoShape::Triangle: {
+    // Shifted a quarter cycle so it starts at zero rising, like the sine
+    const int64_t d = static_cast<int64_t>(static_cast<uint32_t>(phase + (1u << 30))) - (1ll << 31);
+    return 32767 - static_cast<int32_t>(((d < 0 ? -d : d) * 32767) >> 30);
+  }
+  case LfoShape::Square:
+    return phase < (1u << 31) ? 32767 : -32767;
+  case LfoShape::SawUp:
+    return std::max(static_cast<int32_t>(phase) >> 16, -32767);
+  case LfoShape::SawDown:
+    return -std::max(static_cast<int32_t>(phase) >> 16, -32767);
+  }
+  return 0;
+}
+
+void Lfo::start(const Vibrato &vibrato) {
+  _phase = 0;
+  _step = phase_step(vibrato.freq);
+  _depth = vibrato.depth;
+  _shape = vibrato.shape;
+}
+
+Hertz Lfo::offset() const {
+  if (!is_active())
+    return 0_hz;
+  return scaled(_depth, lfo_wave(_shape, phase()));
 }
 
 } // namespace teslasynth::synth
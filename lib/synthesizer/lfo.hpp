@@ -4,25 +4,56 @@
 #pragma once
 
 #include "core.hpp"
+#include <cstdint>
+#include <string>
 
 namespace teslasynth::synth {
 using namespace teslasynth::core;
 
+enum class LfoShape : uint8_t { Sine, Triangle, Square, SawUp, SawDown };
+
+/// Value of a shape at a phase, where 2^32 is a full cycle, in Q15 [-32767, 32767]
+int32_t lfo_wave(LfoShape shape, uint32_t phase);
+
 struct Vibrato {
   Hertz freq = 0_hz;
   Hertz depth = 0_hz;
-
-  Hertz offset(const Duration &now);
+  LfoShape shape = LfoShape::Sine;
 
   constexpr static Vibrato none() { return {}; }
 
-  constexpr bool operator==(const Vibrato &b) const { return freq == b.freq && depth == b.depth; }
+  constexpr bool operator==(const Vibrato &b) const {
+    return freq == b.freq && depth == b.depth && shape == b.shape;
+  }
 
-  constexpr bool operator!=(const Vibrato &b) const { return freq != b.freq || depth != b.depth; }
+  constexpr bool operator!=(const Vibrato &b) const { return !(*this == b); }
 
   inline operator std::string() const {
-    return std::string("F: ") + std::string(freq) + std::string(" D: ") + std::string(depth);
+    constexpr const char *shapes[] = {"sine", "triangle", "square", "saw up", "saw down"};
+    return std::string("F: ") + std::string(freq) + std::string(" D: ") + std::string(depth) +
+           " " + shapes[static_cast<uint8_t>(shape)];
   }
 };
 
+/**
+ * Per-note vibrato oscillator.
+ *
+ * The phase is an integer accumulator where 2^64 is a full cycle, advanced by
+ * each pulse period. Wrap around is the modulo, so it stays exact no matter
+ * how long a note or track runs.
+ */
+class Lfo {
+  uint64_t _phase = 0, _step = 0; // step is per microsecond
+  Hertz _depth = 0_hz;
+  LfoShape _shape = LfoShape::Sine;
+
+public:
+  /// Restarts the oscillator at phase zero
+  void start(const Vibrato &vibrato);
+  void advance(Duration32 dt) { _phase += _step * dt.micros(); }
+  Hertz offset() const;
+  bool is_active() const { return _step != 0 && !_depth.is_zero(); }
+  uint32_t phase() const { return static_cast<uint32_t>(_phase >> 32); }
+};
+
 }; // namespace teslasynth::synth
@@ -13,6 +13,14 @@
 namespace teslasynth::synth {
 using namespace teslasynth::core;
 
+/// Where a hit starts its noise from
+enum class HitSeed : uint8_t {
+  /// The state left in the hit, a fixed seed when it is fresh
+  Carried,
+  /// Its note and start time, so a hit sounds the same however a render got there
+  NoteAndTime,
+};
+
 struct Percussion {
   Duration32 burst = 0_us;
   Hertz prf = 0_hz;
@@ -5,39 +5,85 @@
 
 #include "core.hpp"
 #include "core/hertz.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <string>
+#include <type_traits>
 
 namespace teslasynth::synth {
 using namespace teslasynth::core;
 
+namespace tables {
+// Semitones of a full bend
+constexpr int bend_range = 2;
+
+// 2^(i / 32 * range / 12) in Q28 for i in [-32, 32], a full bend either way in 64 steps
+constexpr std::array<int32_t, 65> bend_ratios = [] {
+  constexpr double ln2 = 0.69314718055994530942;
+  std::array<int32_t, 65> ratios{};
+  for (int i = 0; i < 65; i++) {
+    const double x = (i - 32) / 32.0 * bend_range / 12 * ln2;
+    double sum = 0, term = 1;
+    for (int n = 1; n < 12; n++) {
+      sum += term;
+      term *= x / n;
+    }
+    ratios[i] = static_cast<int32_t>(sum * (1 << 28) + 0.5);
+  }
+  return ratios;
+}();
+} // namespace tables
+
 class PitchBend {
-  float normalized = 0.0f;
+  // The 14 bit MIDI value centred on zero, a full bend is 8192 either way
+  int16_t _value = 0;
+  // Computed once per bend message, notes read it on every pulse
+  Arithmetic::Ratio _multiplier = Arithmetic::ratio(1.0f);
 
   // Note: Can become a dynamic parameter later
-  constexpr static float range = 2.0f;
+  constexpr static float range = tables::bend_range;
+
+  /// Interpolated from the table in integers, so a bend message costs no float math
+  static constexpr Arithmetic::Ratio table_ratio(int32_t value) {
+    const int32_t i = (value >> 8) + 32, frac = value & 0xFF;
+    const int32_t a = tables::bend_ratios[i], b = tables::bend_ratios[i + 1];
+    return a + static_cast<int32_t>((static_cast<int64_t>(b - a) * frac) >> 8);
+  }
 
 public:
   constexpr PitchBend() = default;
-  constexpr PitchBend(float value) : normalized(value > 1 ? 1 : value < -1 ? -1 : value) {}
-
-  constexpr static PitchBend midi(uint16_t v) { return PitchBend((float(v) - 8192.0f) / 8192.0f); }
-
-  constexpr bool operator==(const PitchBend &b) const {
-    return normalized == b.normalized && range == b.range;
+  /// Float builds take every bend through here, so their ratios stay exact exp2f results. It
+  /// runs once per bend message, never per pulse
+  PitchBend(float value) {
+    const float normalized = value > 1 ? 1 : value < -1 ? -1 : value;
+    _value = static_cast<int16_t>(normalized * 8192);
+    _multiplier = Arithmetic::ratio(exp2f(normalized * range / 12.0f));
   }
 
-  constexpr bool operator!=(const PitchBend &b) const {
-    return normalized != b.normalized || range != b.range;
+  static PitchBend midi(uint16_t v) {
+    if constexpr (std::is_floating_point_v<Arithmetic::Ratio>)
+      return PitchBend((float(v) - 8192.0f) / 8192.0f);
+    else {
+      PitchBend pb;
+      pb._value = static_cast<int16_t>(std::min<uint16_t>(v, 16383) - 8192);
+      pb._multiplier = table_ratio(pb._value);
+      return pb;
+    }
   }
 
-  constexpr bool is_zero() const { return normalized == 0; }
+  constexpr bool operator==(const PitchBend &b) const { return _value == b._value; }
 
-  float multiplier() const {
-    float semitones = normalized * range;
-    return exp2f(semitones / 12.0f);
-  }
+  constexpr bool operator!=(const PitchBend &b) const { return _value != b._value; }
+
+  constexpr bool is_zero() const { return _value == 0; }
 
-  Hertz operator*(const Hertz &f) const { return f * multiplier(); }
+  float multiplier() const { return Arithmetic::ratio_to_float(_multiplier); }
+
+  Hertz operator*(const Hertz &f) const {
+    return Hertz::from_raw(Arithmetic::frequency_scale(f.raw(), _multiplier));
+  }
 
   inline operator std::string() const {
     return std::string("Bend: ") + std::to_string(multiplier());
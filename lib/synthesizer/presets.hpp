@@ -5,6 +5,7 @@
 
 #include <bank/instruments.hpp>
 #include <percussion.hpp>
+#include <tuning.hpp>
 #include <stddef.h>
 #include <variant>
 
@@ -12,6 +13,8 @@ namespace teslasynth::synth {
 struct PitchPreset {
   const Instrument *instrument;
   Hertz tuning;
+  // Precomputed notes for `tuning`, when the caller keeps one
+  const TuningTable *table = nullptr;
 
   constexpr bool operator==(const PitchPreset &b) const {
     return tuning == b.tuning && instrument == b.instrument;
@@ -22,6 +25,7 @@ struct PitchPreset {
 };
 struct PercussivePreset {
   const Percussion *percussion;
+  HitSeed seed = HitSeed::Carried;
 
   constexpr bool operator==(const PercussivePreset &b) const { return percussion == b.percussion; }
   constexpr bool operator!=(const PercussivePreset &b) const { return percussion != b.percussion; }
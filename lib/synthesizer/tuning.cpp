@@ -0,0 +1,35 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "tuning.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace teslasynth::synth {
+using namespace teslasynth::core;
+
+namespace {
+// log2f is not constexpr, so this one is filled once at startup
+const std::array<EnvelopeLevel, 128> velocity_levels = [] {
+  std::array<EnvelopeLevel, 128> levels;
+  for (int v = 0; v < 128; v++)
+    levels[v] = EnvelopeLevel::logscale(static_cast<uint8_t>(v * 2 + 1));
+  return levels;
+}();
+} // namespace
+
+EnvelopeLevel velocity_level(uint8_t velocity) {
+  return velocity_levels[std::min<uint8_t>(velocity, 127)];
+}
+
+void TuningTable::retune(Hertz tuning) {
+  _tuning = tuning;
+  for (size_t i = 0; i < _frequencies.size(); i++) {
+    const Hertz frequency = tuning * tables::semitone_ratios[i];
+    _frequencies[i] = frequency.raw();
+    _periods[i] = frequency.period();
+  }
+}
+
+} // namespace teslasynth::synth
@@ -0,0 +1,63 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "core.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace teslasynth::synth {
+using namespace teslasynth::core;
+
+namespace tables {
+// 2^((n - 69) / 12) for every MIDI note, stepped out from A4 by the twelfth root of two
+constexpr std::array<float, 128> semitone_ratios = [] {
+  constexpr double semitone = 1.0594630943592952646;
+  std::array<float, 128> ratios{};
+  double up = 1, down = 1;
+  for (int i = 0; i < 128; i++) {
+    if (69 + i < 128)
+      ratios[69 + i] = static_cast<float>(up);
+    if (69 - i >= 0)
+      ratios[69 - i] = static_cast<float>(down);
+    up *= semitone;
+    down /= semitone;
+  }
+  return ratios;
+}();
+} // namespace tables
+
+/// Frequency ratio of a MIDI note to A4; notes above 127 are clamped
+constexpr float semitone_ratio(uint8_t number) {
+  return tables::semitone_ratios[std::min<uint8_t>(number, 127)];
+}
+
+/// Note-on amplitude for a MIDI velocity, same curve as EnvelopeLevel::logscale(2v + 1)
+EnvelopeLevel velocity_level(uint8_t velocity);
+
+/**
+ * Note frequencies and pulse periods for one concert tuning.
+ *
+ * Rebuilt only when the tuning changes, so starting a note is two lookups
+ * instead of an exp2f and a division.
+ */
+class TuningTable {
+  Hertz _tuning = 0_hz;
+  std::array<Arithmetic::Frequency, 128> _frequencies{};
+  std::array<Duration32, 128> _periods{};
+
+public:
+  explicit TuningTable(Hertz tuning = 440_hz) { retune(tuning); }
+
+  void retune(Hertz tuning);
+
+  Hertz tuning() const { return _tuning; }
+  Hertz frequency(uint8_t number) const {
+    return Hertz::from_raw(_frequencies[std::min<uint8_t>(number, 127)]);
+  }
+  Duration32 period(uint8_t number) const { return _periods[std::min<uint8_t>(number, 127)]; }
+};
+
+} // namespace teslasynth::synth
@@ -6,6 +6,7 @@
 #include "core/envelope_level.hpp"
 #include "presets.hpp"
 #include "voice_event.hpp"
+#include "voice_scheduler.hpp"
 #include <algorithm>
 #include <array>
 #include <cstddef>
@@ -20,25 +21,18 @@
 namespace teslasynth::synth {
 using namespace teslasynth::core;
 
-template <std::uint8_t MAX_NOTES = CONFIG_MAX_NOTES, class ELEMENT = VoiceEvent> class Voice final {
+#ifdef CONFIG_TESLASYNTH_VOICE_HEAP_SCHEDULER
+template <std::uint8_t MAX_NOTES> using DefaultScheduler = HeapScheduler<MAX_NOTES>;
+#else
+template <std::uint8_t MAX_NOTES> using DefaultScheduler = ScanScheduler<MAX_NOTES>;
+#endif
+
+template <std::uint8_t MAX_NOTES = CONFIG_MAX_NOTES, class ELEMENT = VoiceEvent,
+          template <std::uint8_t> class SCHEDULER = DefaultScheduler>
+class Voice final {
   uint8_t _size = MAX_NOTES;
   std::array<ELEMENT, MAX_NOTES> _notes;
-  std::array<uint8_t, MAX_NOTES> _numbers;
-
-  uint8_t find_free(uint8_t id) {
-    for (uint8_t i = 0; i < _size; i++) {
-      if (_notes[i].is_active() && _numbers[i] != id)
-        continue;
-      return i;
-    }
-
-    uint8_t quietest_idx = 0;
-    for (uint8_t i = 1; i < _size; i++) {
-      if (_notes[i].current().volume < _notes[quietest_idx].current().volume)
-        quietest_idx = i;
-    }
-    return quietest_idx;
-  }
+  SCHEDULER<MAX_NOTES> _schedule;
 
 public:
   Voice() {}
@@ -50,54 +44,58 @@ public:
 
   ELEMENT &start(uint8_t number, EnvelopeLevel amplitude, Duration time, const SoundPreset &preset,
                  const ChannelState *channel = nullptr) {
-    const auto idx = find_free(number);
+    const auto idx = _schedule.slot_for(number, _notes, _size);
     _notes[idx].start(number, amplitude, time, preset, channel);
-    _numbers[idx] = number;
+    _schedule.started(idx, number, _notes);
     return _notes[idx];
   }
 
   void release(uint8_t number, Duration time) {
-    for (uint8_t i = 0; i < _size; i++) {
-      if (_notes[i].is_active() && _numbers[i] == number) {
+    _schedule.playing(number, _notes, _size, [&](uint8_t i) { _notes[i].release(time); });
+  }
+
+  /// Releases every sounding note of `channel` at `time`, notes started after it are left alone
+  void release_all(Duration time, const ChannelState *channel) {
+    for (uint8_t i = 0; i < _size; i++)
+      if (_notes[i].is_active() && _notes[i].channel() == channel)
         _notes[i].release(time);
-      }
-    }
+  }
+
+  /// Whether starting `number` now would cut off another sounding note
+  bool would_steal(uint8_t number) {
+    bool playing = false;
+    _schedule.playing(number, _notes, _size, [&](uint8_t) { playing = true; });
+    return !playing && active() == _size;
   }
 
   void off() {
     for (uint8_t i = 0; i < _size; i++)
       _notes[i].off();
+    _schedule.clear();
   }
 
-  ELEMENT &next() {
-    uint8_t out = 0;
-    Duration min = Duration::max();
-    for (uint8_t i = 0; i < _size; i++) {
-      if (!_notes[i].is_active())
-        continue;
-      Duration time = _notes[i].current().start;
-      if (time < min) {
-        out = i;
-        min = time;
-      }
-    }
-    return _notes[out];
+  /// Silences every sounding note of `channel` from `time` on
+  void off(Duration time, const ChannelState *channel) {
+    for (uint8_t i = 0; i < _size; i++)
+      if (_notes[i].is_active() && _notes[i].channel() == channel)
+        _notes[i].off(time);
   }
 
+  /**
+   * The active note with the earliest next pulse
+   *
+   * The caller may advance the returned note in place; the scheduler picks
+   * that up on the next call.
+   */
+  ELEMENT &next() { return _notes[_schedule.earliest(_notes, _size)]; }
+
   void adjust_size(uint8_t size) {
     if (size <= MAX_NOTES && size > 0 && size != _size) {
       off();
       _size = size;
     }
   }
-  uint8_t active() const {
-    uint8_t active = 0;
-    for (uint8_t i = 0; i < _size; i++) {
-      if (_notes[i].is_active())
-        active++;
-    }
-    return active;
-  }
+  uint8_t active() const { return _schedule.active(_notes, _size); }
   uint8_t size() const { return _size; }
   constexpr uint8_t max_size() const { return MAX_NOTES; }
 };
@@ -57,12 +57,17 @@ void VoiceEvent::start(uint8_t number, EnvelopeLevel amplitude, Duration time,
   std::visit(Overload{
                  [&](const PitchPreset &arg) {
                    state = Note{};
-                   std::get<Note>(state).start(number, amplitude, time, *arg.instrument, arg.tuning,
-                                               channel);
+                   if (arg.table != nullptr)
+                     std::get<Note>(state).start(number, amplitude, time, *arg.instrument,
+                                                 *arg.table, channel);
+                   else
+                     std::get<Note>(state).start(number, amplitude, time, *arg.instrument,
+                                                 arg.tuning, channel);
                  },
                  [&](const PercussivePreset &arg) {
                    state = Hit{};
-                   std::get<Hit>(state).start(number, amplitude, time, *arg.percussion, channel);
+                   std::get<Hit>(state).start(number, amplitude, time, *arg.percussion, channel,
+                                              arg.seed);
                  },
              },
              preset);
@@ -76,6 +81,12 @@ void VoiceEvent::release(Duration time) {
 void VoiceEvent::off() {
   state = std::monostate{};
 }
+void VoiceEvent::off(Duration time) {
+  if (std::holds_alternative<Note>(state))
+    std::get<Note>(state).off(time);
+  else if (std::holds_alternative<Hit>(state))
+    std::get<Hit>(state).off(time);
+}
 
 struct TypeVisitor {
   constexpr VoiceEvent::Type operator()(const std::monostate &) const {
@@ -88,4 +99,14 @@ struct TypeVisitor {
 VoiceEvent::Type VoiceEvent::type() const {
   return std::visit(TypeVisitor{}, state);
 }
+
+struct ChannelVisitor {
+  const ChannelState *operator()(const std::monostate &) const { return nullptr; }
+  const ChannelState *operator()(const Note &n) const { return n.channel(); }
+  const ChannelState *operator()(const Hit &h) const { return h.channel(); }
+};
+
+const ChannelState *VoiceEvent::channel() const {
+  return std::visit(ChannelVisitor{}, state);
+}
 } // namespace teslasynth::synth
@@ -37,10 +37,14 @@ public:
 
   void release(Duration time);
   void off();
+  /// Silences the sound from `time` on, pulses before it still play
+  void off(Duration time);
 
   bool next();
   const NotePulse &current() const;
   bool is_active() const;
   Type type() const;
+  /// The state of the channel that started it, none if nothing plays
+  const ChannelState *channel() const;
 };
 } // namespace teslasynth::synth
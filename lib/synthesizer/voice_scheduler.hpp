@@ -0,0 +1,239 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "core/duration.hpp"
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace teslasynth::synth {
+using namespace teslasynth::core;
+
+/**
+ * Scheduling policies for Voice.
+ *
+ * A scheduler decides which slot a new note goes to, which slots play a
+ * note number, and which active slot has the earliest next pulse. Voice
+ * hands it the slot array; the scheduler only keeps indices.
+ */
+
+namespace schedulers {
+/// The quietest of the first `size` slots, the one a new note steals when all are busy
+template <class Notes> uint8_t quietest(const Notes &notes, uint8_t size) {
+  uint8_t quietest_idx = 0;
+  for (uint8_t i = 1; i < size; i++) {
+    if (notes[i].current().volume < notes[quietest_idx].current().volume)
+      quietest_idx = i;
+  }
+  return quietest_idx;
+}
+} // namespace schedulers
+
+/// Linear scans over every slot; the cheapest choice for a handful of notes
+template <std::uint8_t MAX_NOTES> class ScanScheduler {
+  std::array<uint8_t, MAX_NOTES> _numbers;
+
+public:
+  template <class Notes> uint8_t slot_for(uint8_t number, const Notes &notes, uint8_t size) {
+    for (uint8_t i = 0; i < size; i++) {
+      if (notes[i].is_active() && _numbers[i] != number)
+        continue;
+      return i;
+    }
+    return schedulers::quietest(notes, size);
+  }
+
+  template <class Notes> void started(uint8_t idx, uint8_t number, const Notes &) {
+    _numbers[idx] = number;
+  }
+
+  template <class Notes, class F>
+  void playing(uint8_t number, const Notes &notes, uint8_t size, F &&f) {
+    for (uint8_t i = 0; i < size; i++) {
+      if (notes[i].is_active() && _numbers[i] == number)
+        f(i);
+    }
+  }
+
+  template <class Notes> uint8_t earliest(const Notes &notes, uint8_t size) {
+    uint8_t out = 0;
+    Duration min = Duration::max();
+    for (uint8_t i = 0; i < size; i++) {
+      if (!notes[i].is_active())
+        continue;
+      Duration time = notes[i].current().start;
+      if (time < min) {
+        out = i;
+        min = time;
+      }
+    }
+    return out;
+  }
+
+  template <class Notes> uint8_t active(const Notes &notes, uint8_t size) const {
+    uint8_t active = 0;
+    for (uint8_t i = 0; i < size; i++) {
+      if (notes[i].is_active())
+        active++;
+    }
+    return active;
+  }
+
+  void clear() {}
+};
+
+/**
+ * Indexed min-heap of active slots, keyed on (next pulse, slot).
+ *
+ * The caller advances the slot returned by earliest() in place, so that slot
+ * is re-sifted lazily on the next call. Picking the next pulse is O(log N),
+ * free and playing slots are found from a bitmask of the active ones, and the
+ * heap's size counts the active notes. Every choice is the one ScanScheduler
+ * makes, so both render the same pulses.
+ */
+template <std::uint8_t MAX_NOTES> class HeapScheduler {
+  static_assert(MAX_NOTES <= 32, "busy slots are tracked in a 32 bit mask");
+  static constexpr uint8_t none = 0xFF;
+
+  std::array<uint8_t, MAX_NOTES> _heap;
+  std::array<uint8_t, MAX_NOTES> _position; // heap index of each slot, none when idle
+  std::array<uint8_t, MAX_NOTES> _numbers;
+  uint32_t _busy = 0;
+  uint8_t _count = 0, _dirty = none;
+
+  template <class Notes> static bool before(const Notes &notes, uint8_t a, uint8_t b) {
+    const Duration ta = notes[a].current().start, tb = notes[b].current().start;
+    return ta < tb || (ta == tb && a < b);
+  }
+
+  void place(uint8_t at, uint8_t slot) {
+    _heap[at] = slot;
+    _position[slot] = at;
+  }
+
+  template <class Notes> void sift_up(uint8_t at, const Notes &notes) {
+    const uint8_t slot = _heap[at];
+    while (at > 0) {
+      const uint8_t parent = (at - 1) / 2;
+      if (!before(notes, slot, _heap[parent]))
+        break;
+      place(at, _heap[parent]);
+      at = parent;
+    }
+    place(at, slot);
+  }
+
+  template <class Notes> void sift_down(uint8_t at, const Notes &notes) {
+    const uint8_t slot = _heap[at];
+    while (true) {
+      uint8_t child = 2 * at + 1;
+      if (child >= _count)
+        break;
+      if (child + 1 < _count && before(notes, _heap[child + 1], _heap[child]))
+        child++;
+      if (!before(notes, _heap[child], slot))
+        break;
+      place(at, _heap[child]);
+      at = child;
+    }
+    place(at, slot);
+  }
+
+  template <class Notes> void remove(uint8_t slot, const Notes &notes) {
+    const uint8_t at = _position[slot];
+    _position[slot] = none;
+    _busy &= ~(1u << slot);
+    if (at == --_count)
+      return;
+    const uint8_t moved = _heap[_count];
+    place(at, moved);
+    sift_up(at, notes);
+    sift_down(_position[moved], notes);
+  }
+
+  /// Brings a slot whose note may have changed back in line with the heap
+  template <class Notes> void fix(uint8_t slot, const Notes &notes) {
+    const bool active = notes[slot].is_active();
+    if (_position[slot] == none) {
+      if (!active)
+        return;
+      _busy |= 1u << slot;
+      place(_count++, slot);
+      sift_up(_position[slot], notes);
+    } else if (!active) {
+      remove(slot, notes);
+    } else {
+      sift_up(_position[slot], notes);
+      sift_down(_position[slot], notes);
+    }
+  }
+
+  static constexpr uint32_t mask(uint8_t size) { return size >= 32 ? ~0u : (1u << size) - 1; }
+
+  template <class Notes> void refresh(const Notes &notes) {
+    if (_dirty != none) {
+      fix(_dirty, notes);
+      _dirty = none;
+    }
+  }
+
+public:
+  HeapScheduler() { clear(); }
+
+  /// The lowest slot that is idle or plays `number`, like ScanScheduler
+  template <class Notes> uint8_t slot_for(uint8_t number, const Notes &notes, uint8_t size) {
+    refresh(notes);
+    const uint32_t idle = ~_busy & mask(size);
+    // Every slot below the first idle one is busy
+    const uint8_t first_idle = idle ? static_cast<uint8_t>(__builtin_ctz(idle)) : size;
+    for (uint8_t i = 0; i < first_idle; i++)
+      if (_numbers[i] == number)
+        return i;
+    if (idle)
+      return first_idle;
+    return schedulers::quietest(notes, size);
+  }
+
+  template <class Notes> void started(uint8_t idx, uint8_t number, const Notes &notes) {
+    _numbers[idx] = number;
+    fix(idx, notes);
+  }
+
+  template <class Notes, class F>
+  void playing(uint8_t number, const Notes &notes, uint8_t size, F &&f) {
+    refresh(notes);
+    for (uint32_t busy = _busy & mask(size); busy != 0; busy &= busy - 1) {
+      const uint8_t i = static_cast<uint8_t>(__builtin_ctz(busy));
+      if (_numbers[i] == number)
+        f(i);
+    }
+  }
+
+  template <class Notes> uint8_t earliest(const Notes &notes, [[maybe_unused]] uint8_t size) {
+    refresh(notes);
+    if (_count == 0)
+      return 0;
+    // Voice clears the scheduler when it shrinks, so no slot past `size` is left
+    assert(_heap[0] < size);
+    _dirty = _heap[0];
+    return _heap[0];
+  }
+
+  /// Counted by the heap, less the slot handed out last if it has finished since
+  template <class Notes> uint8_t active(const Notes &notes, uint8_t) const {
+    return _count - (_dirty != none && !notes[_dirty].is_active() ? 1 : 0);
+  }
+
+  void clear() {
+    _position.fill(none);
+    _numbers.fill(none);
+    _busy = 0;
+    _count = 0;
+    _dirty = none;
+  }
+};
+
+} // namespace teslasynth::synth
@@ -3,45 +3,102 @@
 
 #include "hit.hpp"
 #include "core/duration.hpp"
+#include <algorithm>
 #include <core/envelope_level.hpp>
 #include <core/functions.hpp>
 #include <core/hertz.hpp>
+#include <type_traits>
 
 namespace teslasynth::synth {
 namespace {
 // fast PRNG using Xorshift32 algorithm
 // Read this: https://en.wikipedia.org/wiki/Xorshift
-float frand(uint32_t &x) {
+uint32_t xorshift(uint32_t &x) {
   x ^= x << 13;
   x ^= x >> 17;
   x ^= x << 5;
+  return x;
+}
+
+// A draw as a float in [0, 1)
+float unit(uint32_t x) {
   return (x >> 8) * (1.0f / 16777216.0f);
 }
 
+// Hits of different notes, or the same note retriggered, still vary
+uint32_t seed(uint8_t number, Duration time) {
+  uint32_t x = (number + 1) * 0x9E3779B9u ^ static_cast<uint32_t>(time.micros());
+  x ^= x >> 16;
+  x *= 0x85EBCA6Bu;
+  x ^= x >> 13;
+  x *= 0xC2B2AE35u;
+  x ^= x >> 16;
+  // Xorshift relies on its state not being zero
+  return x != 0 ? x : 0x12345678;
+}
+
+// Float builds draw floats as they always did, so their percussion doesn't change
+constexpr bool float_draws = std::is_floating_point_v<Arithmetic::Level>;
+
 constexpr Hertz min_prf = 20_hz, max_prf = 4_khz;
+constexpr Arithmetic::Level three_quarters = Arithmetic::level(0.75f),
+                            quarter = Arithmetic::level(0.25f),
+                            noise_boost = Arithmetic::level(0.3f);
 } // namespace
 
-float Hit::random() {
-  return frand(rng_state);
+uint32_t Hit::random() {
+  return xorshift(rng_state);
+}
+
+bool Hit::skipped() {
+  if constexpr (float_draws)
+    return skip_ > 0 && unit(random()) < skip_;
+  else
+    return !skip_.is_zero() &&
+           Arithmetic::level_fraction(Arithmetic::level_one, random() >> 2) < skip_.raw();
+}
+
+EnvelopeLevel Hit::variation() {
+  if constexpr (float_draws)
+    return EnvelopeLevel(0.75 + 0.25 * unit(random()));
+  else
+    return EnvelopeLevel::from_raw(three_quarters +
+                                   Arithmetic::level_fraction(quarter, random() >> 2));
 }
 
 bool Hit::next() {
-  if (envelope_.is_off())
+  if (envelope_.is_off() || now >= cut)
     now = end;
   const bool active = is_active();
   if (active) {
-    float jitter = (2.0f * random() - 1.0f) * float(noise_) * volume_;
-
-    Duration32 period = prf.is_zero() ? Duration32::micros(50 + random() * 2000)
-                                      : clip(prf * (1 + jitter), min_prf, max_prf).period();
+    Duration32 period;
+    if constexpr (float_draws) {
+      float jitter = (2.0f * unit(random()) - 1.0f) * float(noise_) * volume_;
+      period = prf.is_zero() ? Duration32::micros(50 + unit(random()) * 2000)
+                             : clip(prf * (1 + jitter), min_prf, max_prf).period();
+    } else {
+      // Draws are used as Q30 fractions, so the per-pulse math stays in integers
+      if (prf.is_zero())
+        period = Duration32::micros(50 + ((static_cast<uint64_t>(random()) * 2000) >> 32));
+      else {
+        // Up to noise times volume off the PRF either way, in Q15
+        const uint32_t r = random();
+        const int32_t spread = static_cast<int32_t>(
+            Arithmetic::scale(Arithmetic::scale(r >> 17, noise_.raw()), volume_.raw()));
+        const int32_t jitter = (r & (1u << 16)) ? -spread : spread;
+        const Hertz jittered =
+            Hertz::from_raw(Arithmetic::frequency_fraction(prf.raw(), (1 << 15) + jitter));
+        period = clip(jittered, min_prf, max_prf).period();
+      }
+    }
 
     current_.start = now;
     current_.period = period;
     auto level = envelope_.update(period, true);
-    if (skip_ > 0 && random() < skip_)
+    if (skipped())
       current_.volume = EnvelopeLevel(0);
     else
-      current_.volume = volume_ * level * EnvelopeLevel(0.75 + 0.25 * random()) *
+      current_.volume = volume_ * level * variation() *
                         (_channel != nullptr ? _channel->amplitude : EnvelopeLevel::max());
 
     now += period;
@@ -49,21 +106,39 @@ bool Hit::next() {
   return active;
 }
 
+void Hit::off(Duration time) {
+  cut = std::min(cut, time);
+  // The pulse already lined up is played silent
+  if (current_.start >= cut)
+    current_.volume = EnvelopeLevel(0);
+}
+
 void Hit::start(uint8_t number, EnvelopeLevel amplitude, Duration time, const Percussion &params,
-                const ChannelState *channel) {
+                const ChannelState *channel, HitSeed mode) {
+  if (mode == HitSeed::NoteAndTime)
+    rng_state = seed(number, time);
   // Xorshift relies on rng_state not be zero
-  // Reset it if zero, otherwise use whatever value in memory (possibly some
-  // garbage from other colocated data)
-  if (rng_state == 0)
+  else if (rng_state == 0)
     rng_state = 0x12345678;
 
   now = time;
-  auto scaled_burst = params.burst * (0.5f + 0.5f * amplitude);
-  end = time + scaled_burst;
+  cut = Duration::max();
   envelope_ = params.envelope;
   volume_ = amplitude;
   prf = params.prf;
-  noise_ = Probability(lerp(float(params.noise), 1.0f, amplitude * 0.3f));
+  if constexpr (float_draws) {
+    end = time + params.burst * (0.5f + 0.5f * amplitude);
+    noise_ = Probability(lerp(float(params.noise), 1.0f, amplitude * 0.3f));
+  } else {
+    // From half the burst for the softest hit to all of it for the loudest
+    end = time +
+          EnvelopeLevel::from_raw((Arithmetic::level_one + amplitude.raw()) / 2) * params.burst;
+    // Harder hits are noisier, up to 30% of the way to full noise
+    noise_ = Probability::from_raw(
+        params.noise.raw() +
+        Arithmetic::level_mul(Arithmetic::level_one - params.noise.raw(),
+                              Arithmetic::level_mul(amplitude.raw(), noise_boost)));
+  }
   skip_ = params.skip;
   _channel = channel;
 
@@ -17,8 +17,8 @@ namespace teslasynth::synth {
 using namespace teslasynth::core;
 
 class Hit {
-  uint32_t rng_state;
-  Duration end, now;
+  uint32_t rng_state = 0;
+  Duration end, now, cut;
   Hertz prf = 0_hz;
   Probability noise_ = Probability(), skip_ = Probability();
   EnvelopeLevel volume_;
@@ -26,14 +26,21 @@ class Hit {
   NotePulse current_;
 
   ChannelState const *_channel;
-  inline float random();
+  inline uint32_t random();
+  /// Whether the next pulse is dropped
+  bool skipped();
+  /// Random loudness of the next pulse, from 75% to full
+  EnvelopeLevel variation();
 
 public:
   void start(uint8_t number, EnvelopeLevel amplitude, Duration time, const Percussion &params,
-             const ChannelState *channel = nullptr);
+             const ChannelState *channel = nullptr, HitSeed mode = HitSeed::Carried);
   bool next();
+  /// Stops the hit before its first pulse at or after `time`
+  void off(Duration time);
   const NotePulse &current() const { return current_; }
   bool is_active() const { return now < end; }
+  const ChannelState *channel() const { return _channel; }
 };
 
 } // namespace teslasynth::synth
@@ -18,6 +18,11 @@ namespace teslasynth::synth {
 
 void Note::start(Hertz prf, EnvelopeLevel amplitude, Duration time, const Envelope &env,
                  const Vibrato &vibrato, const ChannelState *channel) {
+  start(prf, prf.period(), amplitude, time, env, vibrato, channel);
+}
+
+void Note::start(Hertz prf, Duration32 period, EnvelopeLevel amplitude, Duration time,
+                 const Envelope &env, const Vibrato &vibrato, const ChannelState *channel) {
   if (prf < MIN_FREQUENCY || prf > MAX_FREQUENCY) {
     off();
     return;
@@ -25,13 +30,15 @@ void Note::start(Hertz prf, EnvelopeLevel amplitude, Duration time, const Envelo
   if (_active && amplitude.is_zero())
     return release(time);
   _current_freq = _freq = prf;
+  _period = period;
   _envelope = env;
-  _vibrato = vibrato;
+  _lfo.start(vibrato);
   _active = true;
   _released = false;
   _level = _envelope.update(0_us, true);
   _volume = amplitude;
   _now = time;
+  _end = Duration::max();
   _channel = channel;
   next();
 }
@@ -51,7 +58,17 @@ void Note::start(uint8_t number, EnvelopeLevel amplitude, Duration time, const E
   start(number, amplitude, time, env, Vibrato::none(), tuning, channel);
 }
 
+void Note::start(uint8_t number, EnvelopeLevel amplitude, Duration time,
+                 const Instrument &instrument, const TuningTable &tuning,
+                 const ChannelState *channel) {
+  start(tuning.frequency(number), tuning.period(number), amplitude, time, instrument.envelope,
+        instrument.vibrato, channel);
+}
+
 void Note::release(Duration time) {
+  // Releasing again can't bring a note back to its sustain
+  if (_released && _release <= time)
+    return;
   _released = true;
   _release = time;
 }
@@ -60,11 +77,19 @@ void Note::off() {
   _active = false;
 }
 
+void Note::off(Duration time) {
+  _end = std::min(_end, time);
+  // The pulse already lined up is played silent
+  if (_pulse.start >= _end)
+    _pulse.volume = EnvelopeLevel(0);
+}
+
 bool Note::next() {
-  if (_envelope.is_off())
+  if (_envelope.is_off() || _now >= _end)
     _active = false;
   if (_active) {
-    Duration32 period = (_current_freq + _vibrato.offset(now())).period();
+    Duration32 period = _lfo.is_active() ? (_current_freq + _lfo.offset()).period() : _period;
+    _lfo.advance(period);
     _pulse.start = _now;
     _pulse.volume =
         _level * _volume * (_channel != nullptr ? _channel->amplitude : EnvelopeLevel::max());
@@ -85,7 +110,12 @@ bool Note::next() {
     _now = next_tick;
     if (_channel != nullptr) {
       if (!_channel->pitch_bend.is_zero()) {
-        _current_freq = lerp(_current_freq, _channel->pitch_bend * _freq, _channel->smoothing);
+        const Hertz bent = Hertz::from_raw(Arithmetic::frequency_lerp(
+            _current_freq.raw(), (_channel->pitch_bend * _freq).raw(), _channel->smoothing));
+        if (bent.raw() != _current_freq.raw()) {
+          _current_freq = bent;
+          _period = bent.period();
+        }
       }
     }
   }
@@ -11,6 +11,7 @@
 #include "bank/instruments.hpp"
 #include "lfo.hpp"
 #include "pulse.hpp"
+#include "tuning.hpp"
 #include <algorithm>
 #include <array>
 #include <cstddef>
@@ -23,16 +24,21 @@ using namespace teslasynth::core;
 
 class Note final {
   Hertz _freq = Hertz(0), _current_freq = Hertz(0);
+  // Period of _current_freq, so steady notes skip the division on every pulse
+  Duration32 _period;
   Envelope _envelope;
-  Vibrato _vibrato;
+  Lfo _lfo;
   NotePulse _pulse;
   EnvelopeLevel _level, _volume;
-  Duration _release, _now;
+  Duration _release, _now, _end;
   bool _active = false;
   bool _released = false;
 
   ChannelState const *_channel;
 
+  void start(Hertz prf, Duration32 period, EnvelopeLevel amplitude, Duration time,
+             const Envelope &env, const Vibrato &vibrato, const ChannelState *channel);
+
 public:
   void start(Hertz prf, EnvelopeLevel amplitude, Duration time, const Envelope &env,
              const Vibrato &vibrato, const ChannelState *channel = nullptr);
@@ -45,21 +51,27 @@ public:
 
   void start(uint8_t number, EnvelopeLevel amplitude, Duration time, const Envelope &env,
              Hertz tuning, const ChannelState *channel = nullptr);
+
+  void start(uint8_t number, EnvelopeLevel amplitude, Duration time, const Instrument &instrument,
+             const TuningTable &tuning, const ChannelState *channel = nullptr);
   void release(Duration time);
 
   void off();
+  /// Stops the note before its first pulse at or after `time`
+  void off(Duration time);
 
   bool next();
   const NotePulse &current() const { return _pulse; }
 
   bool is_active() const { return _active; }
   bool is_released() const { return _released; }
+  const ChannelState *channel() const { return _channel; }
   const Duration &now() const { return _now; }
   const Hertz &frequency() const { return _freq; }
   const EnvelopeLevel &max_volume() const { return _volume; }
 
   static constexpr Hertz frequency_for(uint8_t number, Hertz tuning = 440_hz) {
-    return tuning * exp2f((number - 69) / 12.0f);
+    return tuning * semitone_ratio(number);
   }
 
   static constexpr Hertz MIN_FREQUENCY = 20_hz;
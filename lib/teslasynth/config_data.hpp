@@ -13,7 +13,9 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <functional>
+#include <type_traits>
 
 #ifndef CONFIG_DEFAULT_MAX_DUTY
 #define CONFIG_DEFAULT_MAX_DUTY 100
@@ -51,6 +53,8 @@ public:
   constexpr static DutyCycle min() { return DutyCycle(0); }
   constexpr uint8_t value() const { return value_; }
   constexpr uint8_t inverse() const { return max_value - value_; }
+  /// The duty's share of a value, in integers
+  constexpr uint32_t of(uint32_t v) const { return v * value_ / max_value; }
   constexpr operator float() const { return value_ / static_cast<float>(max_value); }
   constexpr float percent() const { return 100 * static_cast<float>(*this); }
   inline operator std::string() const {
@@ -85,16 +89,21 @@ struct ChannelConfig {
 };
 
 struct SynthConfig {
+  static constexpr Duration16 max_latency = 50_ms;
+
   Hertz tuning = 440_hz;
   std::optional<uint8_t> instrument = {};
+  // Fixed delay for live input, traded for jitter; zero plays messages as soon as handled
+  Duration16 latency = 0_ms;
 
   constexpr bool operator==(const SynthConfig &other) const {
-    return tuning == other.tuning && instrument == other.instrument;
+    return tuning == other.tuning && instrument == other.instrument && latency == other.latency;
   }
 
   inline operator std::string() const {
     return std::string("Tuning: ") + std::string(tuning) +
-           "\nInstrument: " + (instrument ? std::to_string(*instrument) : "-");
+           "\nInstrument: " + (instrument ? std::to_string(*instrument) : "-") +
+           "\nLatency: " + std::string(latency);
   }
 };
 
@@ -105,7 +114,12 @@ template <std::uint8_t OUTPUTS = 1> struct MidiRoutingConfig final {
 
 template <std::uint8_t OUTPUTS = 1> class Configuration {
 public:
-  static constexpr uint32_t current_version = 1;
+  /// Bumped whenever a stored field changes its meaning
+  static constexpr uint32_t layout_version = 3;
+  /// Marks a configuration stored by a fixed point build, whose frequencies are Q23.8
+  static constexpr uint32_t fixed_point_flag = 1u << 31;
+  static constexpr uint32_t current_version =
+      layout_version | (std::is_same_v<Arithmetic, FixedArithmetic> ? fixed_point_flag : 0);
 
 private:
   uint32_t version_ = current_version;
@@ -113,9 +127,47 @@ private:
   std::array<ChannelConfig, OUTPUTS> channels_{};
   MidiRoutingConfig<OUTPUTS> routing_{};
 
+  static constexpr bool is_tuning(float hz) { return hz >= 1 && hz <= 20'000; }
+
+  /// Tuning from raw bits stored by either arithmetic, the default if it makes no sense
+  Hertz stored_tuning(uint32_t version) const {
+    static_assert(sizeof(Hertz) == sizeof(uint32_t));
+    uint32_t bits;
+    std::memcpy(&bits, &synth_.tuning, sizeof(bits));
+    float as_float;
+    std::memcpy(&as_float, &bits, sizeof(as_float));
+    const float as_fixed = FixedArithmetic::frequency_to_float(static_cast<int32_t>(bits));
+
+    float hz;
+    if ((version & ~fixed_point_flag) == 1)
+      // Layout 1 didn't record which arithmetic wrote it; each reads the other as nonsense
+      hz = is_tuning(as_float) ? as_float : as_fixed;
+    else
+      hz = version & fixed_point_flag ? as_fixed : as_float;
+    return is_tuning(hz) ? Hertz(hz) : SynthConfig().tuning;
+  }
+
 public:
   constexpr uint32_t version() const { return version_; }
 
+  /**
+   * Brings a configuration read back from storage to the current version,
+   * converting what an older layout or the other arithmetic stored.
+   *
+   * @return false if the version is unknown and the configuration can't be used
+   */
+  bool upgrade() {
+    const uint32_t layout = version_ & ~fixed_point_flag;
+    if (layout == 0 || layout > layout_version)
+      return false;
+    synth_.tuning = stored_tuning(version_);
+    // Latency took over padding in layout 3, older ones hold whatever was there
+    if (layout < 3 || synth_.latency > SynthConfig::max_latency)
+      synth_.latency = SynthConfig().latency;
+    version_ = current_version;
+    return true;
+  }
+
   constexpr Configuration() {}
   constexpr Configuration(const SynthConfig &synth_config,
                           const std::array<ChannelConfig, OUTPUTS> &channel_configs)
@@ -81,6 +81,15 @@ Parser<DutyCycle> duty(const ConfigPath &path, const ConfigValue value) {
   }
 }
 
+Parser<Duration16> latency(const ConfigPath &path, const ConfigValue value) {
+  auto d = parse_duration16(value);
+  if (d && *d <= SynthConfig::max_latency)
+    return *d;
+  return invalid_value(path, value,
+                       "Valid values are durations up to 50ms, "
+                       "unsigned integers followed by an optional time unit [us (default), ms]");
+}
+
 Parser<std::optional<uint8_t>> instrument(const ConfigPath &path, const ConfigValue value) {
   auto d = parser::parse_number<int8_t>(value);
   if (value == "-" || *d < 1) {
@@ -109,6 +118,11 @@ Parser<Unit> update(const ConfigPath &path, const ConfigValue value, SynthConfig
     if (!_r)
       return _r.error();
     config.instrument = _r.value();
+  } else if (key == "latency") {
+    auto _r = latency(path, value);
+    if (!_r)
+      return _r.error();
+    config.latency = _r.value();
   } else {
     return invalid_key(path, 1);
   }
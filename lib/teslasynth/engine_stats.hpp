@@ -0,0 +1,72 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "core/duration.hpp"
+#include <algorithm>
+#include <cstdint>
+
+namespace teslasynth::midisynth {
+using teslasynth::core::Duration16;
+
+/// What one output played, and what it lost, since its counters were reset
+struct EngineStats {
+  /// Pulses that reached the output with some on time
+  uint32_t pulses = 0;
+  /// Pulses of notes that fell behind the playback clock and were never played
+  uint32_t skipped = 0;
+  /// Pulses the duty limiter silenced, and the on time they lost
+  uint32_t limited = 0;
+  uint64_t limited_on_us = 0;
+  /// Notes that took the slot of another sounding note
+  uint32_t steals = 0;
+  /// Most notes sounding at once
+  uint8_t peak_voices = 0;
+  /// Scheduled messages that never took effect, as the schedule was full or the track stopped
+  uint32_t dropped = 0;
+};
+
+/**
+ * Per output engine counters, updated by whoever holds that output.
+ *
+ * Built with CONFIG_TESLASYNTH_ENGINE_STATS only; otherwise every update is
+ * an empty inline call and stats() is always zero, so the engine pays
+ * nothing for them.
+ */
+class EngineCounters {
+#if CONFIG_TESLASYNTH_ENGINE_STATS
+  EngineStats _stats;
+
+public:
+  static constexpr bool enabled = true;
+
+  void pulse() { _stats.pulses++; }
+  void skip() { _stats.skipped++; }
+  void limit(Duration16 on) {
+    _stats.limited++;
+    _stats.limited_on_us += on.micros();
+  }
+  void steal() { _stats.steals++; }
+  void voices(uint8_t active) { _stats.peak_voices = std::max(_stats.peak_voices, active); }
+  void drop(uint32_t messages = 1) { _stats.dropped += messages; }
+
+  const EngineStats &stats() const { return _stats; }
+  void reset() { _stats = {}; }
+#else
+public:
+  static constexpr bool enabled = false;
+
+  void pulse() {}
+  void skip() {}
+  void limit(Duration16) {}
+  void steal() {}
+  void voices(uint8_t) {}
+  void drop(uint32_t = 1) {}
+
+  EngineStats stats() const { return {}; }
+  void reset() {}
+#endif
+};
+
+} // namespace teslasynth::midisynth
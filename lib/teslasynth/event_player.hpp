@@ -0,0 +1,88 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "../midi/midi_core.hpp"
+#include "core.hpp"
+#include "midi_synth.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace teslasynth::midisynth {
+using teslasynth::midi::TimedChannelMessage;
+
+/**
+ * Plays a time-sorted list of events into a synth without a live input task.
+ *
+ * Events are applied in windows and the outputs are sampled once per window,
+ * the same interleaving the firmware input/output tasks produce, so a whole
+ * file can be rendered in one call.
+ */
+template <std::uint8_t OUTPUTS = 1, class N = Voice<>> class EventPlayer final {
+  Teslasynth<OUTPUTS, N> &_synth;
+  const TimedChannelMessage *_events;
+  size_t _size;
+  size_t _next;
+
+public:
+  /**
+   * @param events Events sorted by time, borrowed for the lifetime of the player
+   * @param from Index of the first event to play
+   */
+  EventPlayer(Teslasynth<OUTPUTS, N> &synth, const TimedChannelMessage *events, size_t size,
+              size_t from = 0)
+      : _synth(synth), _events(events), _size(size), _next(std::min(from, size)) {}
+
+  /// Index of the next event to be applied
+  constexpr size_t position() const { return _next; }
+  constexpr bool done() const { return _next >= _size; }
+
+  /// Time of the last event, or zero if there are none
+  constexpr Duration end_time() const {
+    return _size == 0 ? Duration::zero() : Duration::micros(_events[_size - 1].time_us);
+  }
+
+  /**
+   * Applies every pending event that happens strictly before `end`
+   * @return number of events applied
+   */
+  size_t handle_until(Duration end) {
+    const size_t start = _next;
+    for (; _next < _size && _events[_next].time_us < end.micros(); _next++)
+      _synth.handle(_events[_next].message, Duration::micros(_events[_next].time_us));
+    return _next - start;
+  }
+
+  /**
+   * Plays the remaining events from the window of the next one, one `step`
+   * window at a time, and keeps sampling for one more step after the last
+   * event. Windows stay aligned to multiples of `step`, so a player built
+   * `from` a later event renders the same windows as a full playback would.
+   *
+   * @param capacity Maximum number of pulses per output per step
+   * @param write Called as write(ch, pulse) for every rendered pulse, in order
+   * @return rendered duration
+   */
+  template <typename Writer> Duration render(Duration16 step, size_t capacity, Writer &&write) {
+    if (step.is_zero() || done())
+      return Duration::zero();
+    const uint64_t step_us = step.micros();
+    const Duration start = Duration::micros(_events[_next].time_us / step_us * step_us);
+    const Duration last = end_time() + step;
+    Duration time = start;
+    for (; time <= last; time += step) {
+      handle_until(time + step);
+      if (!_synth.track().is_playing())
+        continue;
+      for (uint8_t ch = 0; ch < OUTPUTS; ch++)
+        _synth.sample_channel(ch, step, capacity,
+                              [&write, ch](size_t, const Pulse &p) { write(ch, p); });
+      _synth.stop_when_silent();
+    }
+    return Duration::micros(time.micros() - start.micros());
+  }
+};
+
+} // namespace teslasynth::midisynth
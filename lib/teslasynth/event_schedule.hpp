@@ -0,0 +1,62 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "../midi/midi_core.hpp"
+#include "core/duration.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace teslasynth::midisynth {
+using teslasynth::core::Duration;
+using teslasynth::midi::MidiChannelMessage;
+
+struct ScheduledMessage {
+  Duration time; // track time
+  MidiChannelMessage message;
+};
+
+/**
+ * Messages waiting for an output's playback clock to reach their time.
+ *
+ * Kept sorted by time; messages with equal times keep their arrival order.
+ * MIDI arrives in time order, so insertion is O(1) in practice.
+ */
+template <size_t CAPACITY = 32> class EventSchedule {
+  std::array<ScheduledMessage, CAPACITY> _events;
+  size_t _head = 0, _size = 0;
+
+  ScheduledMessage &at(size_t i) { return _events[(_head + i) % CAPACITY]; }
+  const ScheduledMessage &at(size_t i) const { return _events[(_head + i) % CAPACITY]; }
+
+public:
+  static constexpr size_t capacity = CAPACITY;
+
+  constexpr bool empty() const { return _size == 0; }
+  constexpr bool full() const { return _size == CAPACITY; }
+  constexpr size_t size() const { return _size; }
+  /// Time of the earliest message, only valid if not empty
+  Duration next_time() const { return at(0).time; }
+  const ScheduledMessage &front() const { return at(0); }
+  /// The i-th earliest message
+  const ScheduledMessage &operator[](size_t i) const { return at(i); }
+
+  /// Requires !full()
+  void push(const ScheduledMessage &event) {
+    size_t i = _size++;
+    for (; i > 0 && event.time < at(i - 1).time; i--)
+      at(i) = at(i - 1);
+    at(i) = event;
+  }
+
+  void pop() {
+    _head = (_head + 1) % CAPACITY;
+    _size--;
+  }
+
+  void clear() { _head = _size = 0; }
+};
+
+} // namespace teslasynth::midisynth
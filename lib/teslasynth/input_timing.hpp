@@ -0,0 +1,47 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace teslasynth::midisynth {
+
+/// Running statistics of how late messages reach an output's playback clock
+struct LatenessStats {
+  uint32_t count = 0, late = 0, max_us = 0;
+  uint64_t sum_us = 0, sum_sq_us = 0;
+
+  /// Records a message that was `us` late, zero if it arrived ahead of playback
+  void record(uint32_t us) {
+    count++;
+    if (us > 0)
+      late++;
+    max_us = std::max(max_us, us);
+    sum_us += us;
+    sum_sq_us += static_cast<uint64_t>(us) * us;
+  }
+
+  float mean_us() const { return count ? static_cast<float>(sum_us) / count : 0; }
+  /// Standard deviation of lateness, the rhythmic jitter heard on the output
+  float jitter_us() const {
+    if (count == 0)
+      return 0;
+    const float mean = mean_us();
+    return sqrtf(std::max(0.f, static_cast<float>(sum_sq_us) / count - mean * mean));
+  }
+};
+
+/**
+ * Lateness of live input, measured both as it is rendered with the
+ * configured lookahead latency and as it would have been without it.
+ */
+struct InputTiming {
+  LatenessStats unbuffered, buffered;
+
+  void reset() { *this = InputTiming(); }
+};
+
+} // namespace teslasynth::midisynth
@@ -9,32 +9,55 @@
 #include "config_data.hpp"
 #include "core/envelope_level.hpp"
 #include "bank/instruments.hpp"
+#include "engine_stats.hpp"
+#include "event_schedule.hpp"
+#include "input_timing.hpp"
 #include "pitchbend.hpp"
+#include "pulse_encoder.hpp"
+#include "render_partition.hpp"
+#include "tuning.hpp"
 #include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <optional>
+#include <utility>
 
 namespace teslasynth::midisynth {
+/// Ignores playback changes, the default for track state callbacks
+struct IgnorePlayback {
+  constexpr void operator()(bool) const {}
+};
+/// Type erased track state callback, for owners that pick it at runtime
 using TrackStateCallback = std::function<void(bool)>;
 
 using namespace teslasynth::synth;
 using namespace teslasynth::midi;
 
-template <unsigned int OUTPUTS = 1> class TrackState {
+/**
+ * Receive and playback clocks of a track
+ *
+ * ON_PLAYBACK is called as on_playback(playing) whenever the track starts or
+ * stops. It is held by value and called directly, so a lambda costs no
+ * allocation or indirect call the way a std::function would.
+ */
+template <unsigned int OUTPUTS = 1, class ON_PLAYBACK = IgnorePlayback> class TrackState {
   Duration _started;
   std::array<Duration, OUTPUTS> _received, _played;
   bool _playing = false;
-  TrackStateCallback _cb;
+  ON_PLAYBACK _cb;
+  InputTiming _timing;
 
 public:
-  TrackState(TrackStateCallback cb = [](bool) {}) : _cb(cb) {}
+  TrackState(ON_PLAYBACK cb = {}) : _cb(std::move(cb)) {}
   constexpr bool is_playing() const { return _playing; }
   constexpr Duration started_time() const { return _started; }
   constexpr Duration received_time(uint8_t ch) const { return _received[ch]; }
   constexpr Duration played_time(uint8_t ch) const { return _played[ch]; }
+  constexpr const InputTiming &timing() const { return _timing; }
+  void reset_timing() { _timing.reset(); }
 
   /**
    * Stops and resets both track's clocks
@@ -51,10 +74,18 @@ public:
   /**
    * Advances the receive clock, starts playing if not already playing
    *
+   * The track starts at the first message's time, and every message is placed
+   * `latency` after its own time. A latency longer than the input's delays
+   * keeps messages ahead of playback, so they play at exactly their time
+   * instead of whenever they were handled. A message that playback already
+   * went past is placed at the playback clock, so it plays late instead of
+   * losing what it was due to play meanwhile.
+   *
    * @param time Absolute current time
+   * @param latency Fixed delay from receiving to playing
    * @return the absolute time of relative to track start time
    */
-  Duration on_receive(uint8_t ch, Duration time) {
+  Duration on_receive(uint8_t ch, Duration time, Duration16 latency = Duration16::zero()) {
     if (!_playing) {
       _playing = true;
       _started = time;
@@ -62,10 +93,20 @@ public:
     }
 
     if (auto d = time - _started) {
-      _received[ch] = *d;
+      const Duration unbuffered = *d, buffered = unbuffered + latency;
+      _timing.unbuffered.record(lateness(ch, unbuffered));
+      _timing.buffered.record(lateness(ch, buffered));
+      _received[ch] = std::max(buffered, _played[ch]);
       return _received[ch];
     }
-    return Duration::zero();
+    return _played[ch];
+  }
+
+  /// How far the playback clock is past `time`, zero if it isn't there yet
+  uint32_t lateness(uint8_t ch, Duration time) const {
+    if (auto d = _played[ch] - time)
+      return std::min<uint64_t>(d->micros(), UINT32_MAX);
+    return 0;
   }
 
   /**
@@ -84,35 +125,30 @@ public:
   }
 };
 
-struct Pulse {
-  Duration16 on, off;
-
-  constexpr bool is_zero() const { return on.is_zero(); }
-  constexpr Duration32 length() const { return on + off; }
-
-  inline operator std::string() const {
-    return std::string("Pulse[on:") + std::string(on) + ", off:" + std::string(off) + "]";
-  }
-};
-
-template <std::uint8_t OUTPUTS = 1, std::size_t OUTPUT_BUFSIZE = 64> struct PulseBuffer {
+/// Rendered output of every channel, stored as the symbols ENCODER makes of its pulses
+template <std::uint8_t OUTPUTS = 1, std::size_t OUTPUT_BUFSIZE = 64,
+          class ENCODER = PulseEncoder>
+struct PulseBuffer {
+  using Encoder = ENCODER;
+  using Symbol = typename ENCODER::Symbol;
   constexpr static uint8_t outputs = OUTPUTS;
   constexpr static size_t output_bufsize = OUTPUT_BUFSIZE;
   constexpr static size_t size = OUTPUTS * OUTPUT_BUFSIZE;
+  static_assert(OUTPUT_BUFSIZE <= UINT8_MAX, "Pulse counts and indices are kept in a uint8_t");
 
   std::array<uint8_t, outputs> written{};
-  std::array<Pulse, size> pulses;
+  std::array<Symbol, size> pulses;
 
   inline void clean() {
     for (uint8_t ch = 0; ch < outputs; ch++) {
       written[ch] = 0;
     }
   }
-  inline Pulse &at(uint8_t ch, uint8_t idx) {
+  inline Symbol &at(uint8_t ch, uint8_t idx) {
     assert(ch < outputs);
     return pulses[ch * output_bufsize + idx];
   }
-  inline Pulse &data(uint8_t ch) {
+  inline Symbol &data(uint8_t ch) {
     assert(ch < outputs);
     return pulses[ch * output_bufsize];
   }
@@ -129,7 +165,7 @@ class DutyLimiter final {
 public:
   DutyLimiter() : duty_(DutyCycle::max()) {}
   DutyLimiter(const DutyCycle &duty, const Duration16 window = 10_ms)
-      : max_budget_(window.micros() * duty), budget_(max_budget_), duty_(duty) {}
+      : max_budget_(duty.of(window.micros())), budget_(max_budget_), duty_(duty) {}
   DutyLimiter(const ChannelConfig &config) : DutyLimiter(config.max_duty) {}
 
   bool can_use(const Duration16 &on) {
@@ -143,7 +179,7 @@ public:
   }
 
   void replenish(const Duration16 &off) {
-    uint32_t total = replenishing_ + (off.micros() * duty_);
+    uint32_t total = replenishing_ + duty_.of(off.micros());
     if (total >= max_budget_) {
       budget_ = max_budget_;
       replenishing_ = 0;
@@ -155,34 +191,155 @@ public:
   constexpr Duration16 budget() const { return Duration16::micros(budget_); }
 };
 
-template <std::uint8_t OUTPUTS = 1, class N = Voice<>> class Teslasynth final {
+/**
+ * The synth engine, with OUTPUTS outputs that each play up to N's notes.
+ *
+ * ON_PLAYBACK is told whenever playback starts or stops, see TrackState.
+ */
+template <std::uint8_t OUTPUTS = 1, class N = Voice<>, class ON_PLAYBACK = IgnorePlayback>
+class Teslasynth final {
   Configuration<OUTPUTS> config_;
-  TrackState<OUTPUTS> _track;
+  TrackState<OUTPUTS, ON_PLAYBACK> _track;
   Instrument const *_instruments = instruments.data();
   size_t _instruments_size = instruments.size();
   std::array<N, OUTPUTS> _voices;
   std::array<DutyLimiter, OUTPUTS> _limiters;
   InstrumentMapping current_instrument_;
   MidiChannels channels_;
+  TuningTable tuning_;
+  std::array<EventSchedule<>, OUTPUTS> _schedules;
+  std::array<EngineCounters, OUTPUTS> _counters;
+  // A channel mode message asked for the track to stop once nothing sounds
+  bool _stopping = false;
+  HitSeed _hit_seed = HitSeed::Carried;
+
+  /**
+   * Channel state that notes read while rendering (volume, pitch bend) and
+   * program changes must take effect exactly when its output's playback
+   * reaches the message time, or messages fed ahead of time would apply
+   * early. Messages already due are applied right away. A message that
+   * doesn't fit in the schedule is dropped and counted, since applying it
+   * early changes what the notes before it play.
+   */
+  void schedule(const MidiChannelMessage &msg, Duration time) {
+    auto output_id = config_.routing().mapping[msg.channel].value();
+    if (!output_id || !_track.is_playing()) {
+      apply(msg);
+      return;
+    }
+    Duration delta = _track.on_receive(*output_id, time, config_.synth().latency);
+    auto &events = _schedules[*output_id];
+    if (delta <= _track.played_time(*output_id) && events.empty()) {
+      apply(msg);
+      return;
+    }
+    if (events.full()) {
+      _counters[*output_id].drop();
+      return;
+    }
+    events.push({delta, msg});
+  }
+
+  void apply(const MidiChannelMessage &msg) {
+    switch (msg.type) {
+    case MidiMessageType::ControlChange:
+      if (static_cast<ControlChange>(msg.data0.value) == ControlChange::RESET_ALL_CONTROLLERS)
+        pitchbend(msg.channel, 8192);
+      else
+        channel_volume(msg.channel, msg.data1);
+      break;
+    case MidiMessageType::ProgramChange:
+      change_instrument(msg.channel, msg.data0);
+      break;
+    case MidiMessageType::PitchBend:
+      pitchbend(msg.channel, (msg.data1 & 0x7F) << 7 | (msg.data0 & 0x7F));
+      break;
+    default:
+      break;
+    }
+  }
+
+  /// The program of `ch` when `output` plays `time`, changes scheduled until then included
+  uint8_t program_at(MidiChannelNumber ch, uint8_t output, Duration time) const {
+    uint8_t program = current_instrument_[ch];
+    const auto &events = _schedules[output];
+    for (size_t i = 0; i < events.size() && events[i].time <= time; i++) {
+      const auto &msg = events[i].message;
+      if (msg.type == MidiMessageType::ProgramChange && msg.channel == ch)
+        program = std::min<uint8_t>(_instruments_size, msg.data0);
+    }
+    return program;
+  }
+
+  constexpr uint8_t instrument_number(MidiChannelNumber ch, uint8_t program) const {
+    return config_.channel(ch).instrument.value_or(config_.synth().instrument.value_or(program));
+  }
+
+  const Instrument &instrument_of(uint8_t nr) const {
+    return nr < _instruments_size ? _instruments[nr] : default_instrument();
+  }
+
+  void reload_outputs() {
+    if (_track.is_playing())
+      off();
+    for (auto i = 0; i < OUTPUTS; i++) {
+      _voices[i].adjust_size(config_.channel(i).notes);
+      _limiters[i] = DutyLimiter(config_.channel(i).max_duty, config_.channel(i).duty_window);
+    }
+  }
+
+  /// Nothing sounds or is scheduled to on any output
+  bool silent() const {
+    for (uint8_t i = 0; i < OUTPUTS; i++)
+      if (_voices[i].active() > 0 || !_schedules[i].empty())
+        return false;
+    return true;
+  }
+
+  /// Applies the messages that are due, returns how long until the next one
+  Duration16 apply_due(uint8_t ch, Duration16 max) {
+    auto &events = _schedules[ch];
+    const Duration now = _track.played_time(ch);
+    while (!events.empty() && events.next_time() <= now) {
+      apply(events.front().message);
+      events.pop();
+    }
+    if (!events.empty() && events.next_time() < now + max)
+      return Duration16::micros(events.next_time().micros() - now.micros());
+    return max;
+  }
 
 public:
-  Teslasynth(
-      const Configuration<OUTPUTS> &config, TrackStateCallback onPlaybackChanged = [](bool) {})
-      : config_(config), _track(onPlaybackChanged) {
+  Teslasynth(const Configuration<OUTPUTS> &config, ON_PLAYBACK onPlaybackChanged = {})
+      : config_(config), _track(std::move(onPlaybackChanged)) {
     reload_config();
   }
 
-  Teslasynth(TrackStateCallback onPlaybackChanged = [](bool) {})
-      : Teslasynth(Configuration<OUTPUTS>(), onPlaybackChanged) {}
+  Teslasynth(ON_PLAYBACK onPlaybackChanged = {})
+      : Teslasynth(Configuration<OUTPUTS>(), std::move(onPlaybackChanged)) {}
 
   inline constexpr auto &configuration() { return config_; }
 
+  /// How hits seed their noise, see HitSeed
+  void seed_hits(HitSeed mode) { _hit_seed = mode; }
+
   template <std::size_t INSTRUMENTS>
   void use_instruments(const std::array<Instrument, INSTRUMENTS> &instruments) {
     _instruments = instruments.data();
     _instruments_size = instruments.size();
   }
 
+  /**
+   * Handles a message stamped with its absolute time
+   *
+   * Notes, all notes off and all sound off are placed on the track timeline,
+   * and volume, pitch bend, reset and program changes are scheduled on it, so
+   * messages can be fed ahead of playback and render the same as if they were
+   * fed when due. All notes/sound off act on the notes of their channel that
+   * started before them, reset all controllers centers the pitch bend. These
+   * channel mode messages also stop the track once nothing sounds anymore,
+   * see stop_when_silent.
+   */
   void handle(MidiChannelMessage msg, Duration time) {
     switch (msg.type) {
     case MidiMessageType::NoteOff:
@@ -196,46 +353,85 @@ public:
     case MidiMessageType::ControlChange:
       switch (static_cast<ControlChange>(msg.data0.value)) {
       case ControlChange::ALL_SOUND_OFF:
-      case ControlChange::RESET_ALL_CONTROLLERS:
+        sound_off(msg.channel, time);
+        _stopping = true;
+        break;
       case ControlChange::ALL_NOTES_OFF:
-        off();
+        notes_off(msg.channel, time);
+        _stopping = true;
+        break;
+      case ControlChange::RESET_ALL_CONTROLLERS:
+        schedule(msg, time);
+        _stopping = true;
         break;
       case ControlChange::CHANNEL_VOLUME_MSB:
-        channel_volume(msg.channel, msg.data1);
+        schedule(msg, time);
         break;
       default:
         break;
       }
+      stop_when_silent();
       break;
     case MidiMessageType::ProgramChange:
-      change_instrument(msg.channel, msg.data0);
+      schedule(msg, time);
       break;
     case MidiMessageType::AfterTouchChannel:
       break;
     case MidiMessageType::PitchBend:
-      pitchbend(msg.channel, (msg.data1 & 0x7F) << 7 | (msg.data0 & 0x7F));
+      schedule(msg, time);
       break;
     }
   }
 
   inline void off() {
+    _stopping = false;
     _track.stop();
     for (auto &note : _voices) {
       note.off();
     }
+    // Their times were on the track that stopped
+    for (uint8_t i = 0; i < OUTPUTS; i++) {
+      _counters[i].drop(_schedules[i].size());
+      _schedules[i].clear();
+    }
   }
 
-  inline void reload_config() {
-    if (_track.is_playing())
+  /// A channel mode message is waiting for every output to go silent, a hint without the locks
+  constexpr bool stopping() const { return _stopping; }
+
+  /**
+   * Stops the track if a channel mode message asked for it and nothing sounds
+   * or is scheduled on any output anymore. This touches every output, so a
+   * caller that renders outputs separately calls it with all of them held;
+   * handle and sample_all already do.
+   */
+  inline void stop_when_silent() {
+    if (_stopping && silent())
       off();
-    for (auto i = 0; i < OUTPUTS; i++) {
-      _voices[i].adjust_size(config_.channel(i).notes);
-      _limiters[i] = DutyLimiter(config_.channel(i).max_duty, config_.channel(i).duty_window);
-    }
+  }
+
+  inline void reload_config() {
+    tuning_.retune(config_.synth().tuning);
+    reload_outputs();
+  }
+
+  /**
+   * Replaces the configuration and its tuning table, built beforehand, without
+   * reloading the outputs. It only copies, so it is short enough for a spinlock.
+   */
+  inline void set_config(const Configuration<OUTPUTS> &config, const TuningTable &tuning) {
+    config_ = config;
+    tuning_ = tuning;
+  }
+
+  /// Same as set_config, then reloads the outputs
+  inline void load_config(const Configuration<OUTPUTS> &config, const TuningTable &tuning) {
+    set_config(config, tuning);
+    reload_outputs();
   }
 
   inline void channel_volume(MidiChannelNumber ch, uint8_t volume) {
-    channels_[ch].amplitude = EnvelopeLevel(volume / 127.f);
+    channels_[ch].amplitude = EnvelopeLevel::from_raw(Arithmetic::level_ratio(volume, 127));
   }
 
   inline void pitchbend(MidiChannelNumber ch, uint16_t value) {
@@ -247,38 +443,66 @@ public:
   }
 
   inline constexpr uint8_t instrument_number(MidiChannelNumber ch) const {
-    return config_.channel(ch).instrument.value_or(
-        config_.synth().instrument.value_or(current_instrument_[ch]));
+    return instrument_number(ch, current_instrument_[ch]);
   }
 
   inline const Instrument &instrument(MidiChannelNumber ch) const {
-    const auto nr = instrument_number(ch);
-    return nr < _instruments_size ? _instruments[nr] : default_instrument();
+    return instrument_of(instrument_number(ch));
   }
 
   inline void note_off(MidiChannelNumber ch, uint8_t number, Duration time) {
     if (_track.is_playing()) {
       if (auto output_id = config_.routing().mapping[ch].value()) {
-        Duration delta = _track.on_receive(*output_id, time);
+        Duration delta = _track.on_receive(*output_id, time, config_.synth().latency);
         _voices[*output_id].release(number, delta);
       }
     }
   }
 
+  inline void notes_off(MidiChannelNumber ch, Duration time) {
+    if (_track.is_playing()) {
+      if (auto output_id = config_.routing().mapping[ch].value()) {
+        Duration delta = _track.on_receive(*output_id, time, config_.synth().latency);
+        _voices[*output_id].release_all(delta, &channels_[ch]);
+      }
+    }
+  }
+
+  inline void sound_off(MidiChannelNumber ch, Duration time) {
+    if (_track.is_playing()) {
+      if (auto output_id = config_.routing().mapping[ch].value()) {
+        Duration delta = _track.on_receive(*output_id, time, config_.synth().latency);
+        _voices[*output_id].off(delta, &channels_[ch]);
+      }
+    }
+  }
+
   inline void note_on(MidiChannelNumber ch, uint8_t number, uint8_t velocity, Duration time) {
     if (velocity == 0)
       note_off(ch, number, time);
     else if (auto output_id = config_.routing().mapping[ch].value()) {
-      Duration delta = _track.on_receive(*output_id, time);
-      auto amplitude = EnvelopeLevel::logscale(velocity * 2 + 1);
+      Duration delta = _track.on_receive(*output_id, time, config_.synth().latency);
+      auto amplitude = velocity_level(velocity);
+      auto &voice = _voices[*output_id];
+      if constexpr (EngineCounters::enabled)
+        if (voice.would_steal(number))
+          _counters[*output_id].steal();
 
       if (ch == 9 && config_.routing().percussion) {
-        PercussivePreset preset{&bank::percussion_from_midi_note(number)};
-        _voices[*output_id].start(number, amplitude, delta, preset, &channels_[ch]);
+        PercussivePreset preset{&bank::percussion_from_midi_note(number), _hit_seed};
+        voice.start(number, amplitude, delta, preset, &channels_[ch]);
       } else {
-        PitchPreset preset{&instrument(ch), config_.synth().tuning};
-        _voices[*output_id].start(number, amplitude, delta, preset, &channels_[ch]);
+        // The configuration is mutable in place, and a tuning edited there until
+        // the next reload is computed per note instead of from the table
+        const Hertz tuning = config_.synth().tuning;
+        const TuningTable *table = tuning.raw() == tuning_.tuning().raw() ? &tuning_ : nullptr;
+        // Program changes scheduled before the note count, the later ones don't
+        const auto nr = instrument_number(ch, program_at(ch, *output_id, delta));
+        PitchPreset preset{&instrument_of(nr), tuning, table};
+        voice.start(number, amplitude, delta, preset, &channels_[ch]);
       }
+      if constexpr (EngineCounters::enabled)
+        _counters[*output_id].voices(voice.active());
     }
   }
 
@@ -286,13 +510,26 @@ public:
     note_on(ch, number, 127, time);
   }
 
+  /// Time from an output's playback clock to its next pulse, none if nothing sounds on it
+  std::optional<Duration> next_edge(uint8_t ch) {
+    assert(ch < OUTPUTS);
+    const auto &note = _voices[ch].next();
+    if (!_track.is_playing() || !note.is_active())
+      return std::nullopt;
+    if (auto left = note.current().start - _track.played_time(ch))
+      return *left;
+    return Duration::zero();
+  }
+
   Pulse sample(uint8_t ch, Duration16 max) {
     assert(ch < OUTPUTS);
     Pulse res;
+    max = apply_due(ch, max);
 
     auto *note = &_voices[ch].next();
     Duration next_edge = note->current().start;
     while (next_edge < _track.played_time(ch) && note->is_active()) {
+      _counters[ch].skip();
       note->next();
       note = &_voices[ch].next();
       next_edge = note->current().start;
@@ -319,8 +556,11 @@ public:
     }
 
     if (!_limiters[ch].can_use(effective_on)) {
+      _counters[ch].limit(res.on);
       res.off.add_saturating(res.on);
       res.on = 0_us;
+    } else if (!res.on.is_zero()) {
+      _counters[ch].pulse();
     }
 
     _limiters[ch].replenish(res.off);
@@ -329,26 +569,88 @@ public:
     return res;
   }
 
-  template <size_t BUFSIZE> void sample_all(Duration16 max, PulseBuffer<OUTPUTS, BUFSIZE> &output) {
-    if (!_track.is_playing()) {
-      output.clean();
-      return;
+  /**
+   * Renders up to `max` worth of pulses for a single output
+   *
+   * @param capacity Maximum number of pulses to produce
+   * @param write Called as `write(index, pulse)` for every rendered pulse
+   * @return the number of pulses written
+   */
+  template <typename Writer>
+  size_t sample_channel(uint8_t ch, Duration16 max, size_t capacity, Writer &&write) {
+    const uint32_t now = max.micros();
+    uint32_t processed = 0;
+    size_t i = 0;
+    for (; processed < now && i < capacity; i++) {
+      const Pulse pulse = sample(ch, Duration16::micros(now - processed));
+      write(i, pulse);
+      processed += pulse.length().micros();
     }
-    uint16_t now = max.micros();
-    for (uint8_t ch = 0; ch < OUTPUTS; ch++) {
-      uint16_t processed = 0;
-      uint8_t i = 0;
-      const size_t start = static_cast<size_t>(ch) * BUFSIZE;
-      for (; processed < now && i < BUFSIZE; i++) {
-        auto left = Duration16::micros(now - processed);
-        output.pulses[start + i] = sample(ch, left);
-        processed += output.pulses[start + i].length().micros();
-      }
-      output.written[ch] = i;
+    return i;
+  }
+
+  /**
+   * Renders pulses of a single output after the first `size` symbols of `out`, until `max`
+   * is covered or `out` can't take another pulse's symbols
+   *
+   * @param size Updated to the number of symbols in `out`
+   * @return the time rendered, which may run past `max` by a pulse's dead-time
+   */
+  template <class ENCODER>
+  Duration32 sample_symbols(uint8_t ch, Duration32 max, typename ENCODER::Symbol *out,
+                            size_t capacity, size_t &size) {
+    const uint32_t now = max.micros();
+    uint32_t processed = 0;
+    while (processed < now && size + ENCODER::max_symbols <= capacity) {
+      const uint32_t left = std::min<uint32_t>(now - processed, UINT16_MAX);
+      const Pulse pulse = sample(ch, Duration16::micros(left));
+      size = ENCODER::append(out, size, pulse);
+      processed += pulse.length().micros();
     }
+    return Duration32::micros(processed);
   }
 
-  const TrackState<OUTPUTS> &track() const { return _track; }
+  /**
+   * Renders up to `max` worth of pulses for a range of outputs
+   *
+   * An output stops early once its buffer can't take another pulse's symbols.
+   * Rendering an output applies its due messages, which write the channel
+   * state and instrument selection of the MIDI channels routed to it, and
+   * reads the rest only. So disjoint ranges may be rendered concurrently into
+   * the same buffer, as long as nothing handles messages or reloads the
+   * configuration meanwhile.
+   */
+  template <size_t BUFSIZE, class ENCODER>
+  void sample_range(Duration16 max, PulseBuffer<OUTPUTS, BUFSIZE, ENCODER> &output,
+                    OutputRange range) {
+    const uint8_t end = std::min<uint8_t>(range.end(), OUTPUTS);
+    for (uint8_t ch = range.first; ch < end; ch++) {
+      size_t size = 0;
+      if (_track.is_playing())
+        sample_symbols<ENCODER>(ch, max, &output.data(ch), BUFSIZE, size);
+      output.written[ch] = size;
+    }
+  }
+
+  /// Renders every output, pulses encoded by the buffer's encoder as they are rendered
+  template <size_t BUFSIZE, class ENCODER>
+  void sample_all(Duration16 max, PulseBuffer<OUTPUTS, BUFSIZE, ENCODER> &output) {
+    sample_range(max, output, {0, OUTPUTS});
+    stop_when_silent();
+  }
+
+  const TrackState<OUTPUTS, ON_PLAYBACK> &track() const { return _track; }
+  const InputTiming &input_timing() const { return _track.timing(); }
+  void reset_input_timing() { _track.reset_timing(); }
+  /// Always zero unless built with CONFIG_TESLASYNTH_ENGINE_STATS
+  EngineStats stats(uint8_t ch) const {
+    assert(ch < OUTPUTS);
+    return _counters[ch].stats();
+  }
+  void reset_stats() {
+    for (auto &counters : _counters)
+      counters.reset();
+  }
   const N &voice(uint8_t i = 0) const {
     auto ch = OutputNumber<OUTPUTS>::from(i);
     assert(ch.has_value());
@@ -0,0 +1,47 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "core/duration.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace teslasynth::midisynth {
+using teslasynth::core::Duration32;
+
+/**
+ * Renders one output on demand, for consumers that ask for more symbols as
+ * they free up room, instead of taking fixed blocks from a PulseBuffer.
+ *
+ * A cursor is started with how long to play, then pulled into whatever room
+ * the consumer has until it is done. Pulls only touch the cursor's output, so
+ * they need that output's lock and nothing else.
+ */
+template <class ENCODER> class OutputCursor {
+  uint8_t _ch = 0;
+  uint32_t _left = 0;
+
+public:
+  using Symbol = typename ENCODER::Symbol;
+
+  constexpr OutputCursor(uint8_t ch = 0) : _ch(ch) {}
+
+  constexpr uint8_t output() const { return _ch; }
+  constexpr bool done() const { return _left == 0; }
+  constexpr Duration32 left() const { return Duration32::micros(_left); }
+
+  void start(Duration32 length) { _left = length.micros(); }
+
+  /// Renders the next symbols into `out`, returns how many it wrote
+  template <class SYNTH> size_t pull(SYNTH &synth, Symbol *out, size_t capacity) {
+    size_t size = 0;
+    const Duration32 played =
+        synth.template sample_symbols<ENCODER>(_ch, left(), out, capacity, size);
+    _left -= std::min(played.micros(), _left);
+    return size;
+  }
+};
+
+} // namespace teslasynth::midisynth
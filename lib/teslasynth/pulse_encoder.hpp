@@ -0,0 +1,150 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "core/duration.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace teslasynth::midisynth {
+using teslasynth::core::Duration16;
+using teslasynth::core::Duration32;
+
+struct Pulse {
+  Duration16 on, off;
+
+  constexpr bool is_zero() const { return on.is_zero(); }
+  constexpr Duration32 length() const { return on + off; }
+
+  inline operator std::string() const {
+    return std::string("Pulse[on:") + std::string(on) + ", off:" + std::string(off) + "]";
+  }
+};
+
+/**
+ * Output encoders turn rendered pulses into the symbols an output consumes,
+ * while they are rendered. An encoder names its `Symbol` type and provides
+ * `static size_t append(Symbol *out, size_t size, const Pulse &)`, which
+ * writes the pulse after the first `size` symbols and returns the new size.
+ * It may rewrite the last symbol, but never appends more than `max_symbols`.
+ */
+
+/// Keeps pulses as they are
+struct PulseEncoder {
+  using Symbol = Pulse;
+  static constexpr size_t max_symbols = 1;
+
+  static constexpr Symbol encode(const Pulse &pulse) { return pulse; }
+  static constexpr size_t append(Symbol *out, size_t size, const Pulse &pulse) {
+    out[size] = encode(pulse);
+    return size + 1;
+  }
+};
+
+/**
+ * ESP32 RMT symbols at 1 MHz, bit compatible with `rmt_symbol_word_t`:
+ * duration0 in bits 0-14, level0 in bit 15, duration1 in bits 16-30 and
+ * level1 in bit 31.
+ *
+ * Durations are 15 bits wide. Silences are split between both halves so
+ * they can reach 65534us; on and off times of a pulse are clamped.
+ */
+struct RmtSymbolEncoder {
+  using Symbol = uint32_t;
+  static constexpr uint16_t max_duration = 0x7FFF;
+  static constexpr size_t max_symbols = 1;
+
+  static constexpr Symbol symbol(uint16_t duration0, bool level0, uint16_t duration1,
+                                 bool level1) {
+    return static_cast<Symbol>(duration0 & max_duration) |
+           static_cast<Symbol>(level0) << 15 |
+           static_cast<Symbol>(duration1 & max_duration) << 16 |
+           static_cast<Symbol>(level1) << 31;
+  }
+
+  static constexpr Symbol encode(const Pulse &pulse) {
+    if (pulse.is_zero()) {
+      const uint16_t off = std::max<uint16_t>(2, pulse.off.micros());
+      const uint16_t first = std::min<uint16_t>(max_duration, off - off / 2);
+      return symbol(first, false, off / 2, false);
+    }
+    const uint16_t on = std::min<uint16_t>(max_duration, pulse.on.micros());
+    const uint16_t off = std::clamp<uint16_t>(pulse.off.micros(), 1, max_duration);
+    return symbol(on, true, off, false);
+  }
+
+  static constexpr size_t append(Symbol *out, size_t size, const Pulse &pulse) {
+    out[size] = encode(pulse);
+    return size + 1;
+  }
+
+  static constexpr uint16_t duration0(Symbol s) { return s & max_duration; }
+  static constexpr bool level0(Symbol s) { return s >> 15 & 1; }
+  static constexpr uint16_t duration1(Symbol s) { return s >> 16 & max_duration; }
+  static constexpr bool level1(Symbol s) { return s >> 31; }
+};
+
+/**
+ * Compiles pulses into as few RMT symbols as it can, in the same format as
+ * RmtSymbolEncoder.
+ *
+ * Every symbol ends low, so a pulse's dead-time and all the silences after it
+ * share a single symbol until it is full; gaps longer than that are chained
+ * over more symbols instead of being clamped. Sparse music then costs about a
+ * symbol per pulse, no matter how often it is sampled.
+ *
+ * Total duration is kept exactly, except where a symbol can't be made that
+ * short: a pulse without dead-time gets 1us, and a 1us silence that has
+ * nothing to join takes 2us.
+ */
+struct RmtSymbolCompiler {
+  using Symbol = RmtSymbolEncoder::Symbol;
+  static constexpr uint16_t max_duration = RmtSymbolEncoder::max_duration;
+  static constexpr size_t max_symbols = 2;
+
+  static constexpr size_t append(Symbol *out, size_t size, const Pulse &pulse) {
+    if (pulse.is_zero())
+      return silence(out, size, pulse.off.micros());
+    const uint16_t on = std::min<uint16_t>(max_duration, pulse.on.micros());
+    out[size++] = RmtSymbolEncoder::symbol(on, true, 1, false);
+    return silence(out, size, pulse.off.micros() > 0 ? pulse.off.micros() - 1 : 0);
+  }
+
+  /// Extends the last symbol by `us` of silence, chaining new symbols once it is full
+  static constexpr size_t silence(Symbol *out, size_t size, uint32_t us) {
+    if (us > 0 && size > 0) {
+      Symbol &last = out[size - 1];
+      const bool silent = !RmtSymbolEncoder::level0(last);
+      const uint32_t held = RmtSymbolEncoder::duration1(last) +
+                            (silent ? RmtSymbolEncoder::duration0(last) : 0);
+      const uint32_t room = (silent ? 2u : 1u) * max_duration - held;
+      uint32_t add = std::min(us, room);
+      // Leave at least 2us to a new symbol, it can't be any shorter
+      if (us - add == 1 && add > 0)
+        add--;
+      last = silent ? silent_symbol(held + add)
+                    : RmtSymbolEncoder::symbol(RmtSymbolEncoder::duration0(last), true,
+                                               held + add, false);
+      us -= add;
+    }
+    while (us > 0) {
+      uint32_t chunk = std::min<uint32_t>(us, 2u * max_duration);
+      if (us - chunk == 1)
+        chunk--;
+      out[size++] = silent_symbol(chunk);
+      us -= chunk;
+    }
+    return size;
+  }
+
+private:
+  static constexpr Symbol silent_symbol(uint32_t us) {
+    const uint16_t total = std::max<uint32_t>(2, us);
+    return RmtSymbolEncoder::symbol(total - total / 2, false, total / 2, false);
+  }
+};
+
+} // namespace teslasynth::midisynth
@@ -0,0 +1,120 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "core/duration.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+
+namespace teslasynth::midisynth {
+using teslasynth::core::Duration16;
+using teslasynth::core::Duration32;
+
+struct CadenceConfig {
+  /// Render period right after a note starts, the attack latency
+  Duration16 min_period = Duration16::micros(2'000);
+  /// Render period while notes only sustain, the CPU saving
+  Duration16 max_period = Duration16::micros(20'000);
+};
+
+/// What the render loop saw in the block it just rendered
+struct BlockReport {
+  bool playing = false;
+  /// A note started since the previous block
+  bool note_started = false;
+  /// An output ran out of room for symbols before the end of the block
+  bool saturated = false;
+  /// Time until the next pulse of any rendered output, none if nothing sounds
+  std::optional<Duration32> next_edge;
+};
+
+/**
+ * Picks how long the render loop waits before its next block.
+ *
+ * Blocks are short right after a note starts, so its attack goes out without
+ * waiting for a long block, and the period doubles back up to the maximum
+ * while notes just sustain. Running out of symbol room counts as an attack,
+ * since shorter blocks need fewer symbols each. When the next pulse is
+ * further away than the period, the loop sleeps until then instead.
+ *
+ * While the track isn't playing there is nothing to render, and the loop
+ * should wait for input instead.
+ */
+class RenderCadence {
+  CadenceConfig _config;
+  uint32_t _period;
+
+public:
+  explicit RenderCadence(const CadenceConfig &config = {})
+      : _config(config), _period(config.min_period.micros()) {}
+
+  constexpr const CadenceConfig &config() const { return _config; }
+  constexpr Duration16 period() const { return Duration16::micros(_period); }
+
+  /// The wait before the next block, none when idle
+  std::optional<Duration16> next(const BlockReport &block) {
+    const uint32_t min = _config.min_period.micros();
+    const uint32_t max = std::max<uint32_t>(min, _config.max_period.micros());
+    if (!block.playing) {
+      _period = min;
+      return std::nullopt;
+    }
+    if (block.note_started || block.saturated)
+      _period = min;
+    else
+      _period = std::min(max, _period * 2);
+
+    const uint32_t edge = block.next_edge ? std::min(block.next_edge->micros(), max) : max;
+    return Duration16::micros(std::max(_period, edge));
+  }
+};
+
+/**
+ * Keeps what the render loop queued ahead of the hardware playing it.
+ *
+ * Each block is rendered far enough ahead for the queue to last through the
+ * loop's next wait plus a margin, which covers late wake ups and the time
+ * rendering takes, and the wait is cut to what the queue covers. So the
+ * hardware doesn't run dry while notes sound, and the track clock stays with
+ * the loop's clock. Input handled meanwhile plays after what was already
+ * queued, so the backlog is also the delay of a note starting mid block.
+ */
+class RenderAhead {
+  uint64_t _until = 0; // When the queue runs out, on the loop's clock
+  uint32_t _margin;
+
+public:
+  explicit RenderAhead(Duration16 margin) : _margin(margin.micros()) {}
+
+  /// Queued but not played yet at `now`
+  constexpr uint32_t backlog(uint64_t now) const {
+    return _until > now ? static_cast<uint32_t>(_until - now) : 0;
+  }
+
+  /// The block to render at `now` for the queue to last through `wait` and the margin
+  constexpr Duration16 budget(uint64_t now, Duration16 wait) const {
+    const uint32_t target = wait.micros() + _margin, queued = backlog(now);
+    return Duration16::micros(
+        static_cast<uint16_t>(std::min<uint32_t>(target > queued ? target - queued : 0,
+                                                 UINT16_MAX)));
+  }
+
+  /// The hardware is done with everything queued, it was dropped or played sooner
+  void drained() { _until = 0; }
+
+  /**
+   * Queues a block rendered at `now`
+   *
+   * @return the longest wait before the queue is down to the margin
+   */
+  Duration16 queue(uint64_t now, Duration16 block) {
+    _until = std::max(_until, now) + block.micros();
+    const uint32_t queued = backlog(now);
+    return Duration16::micros(static_cast<uint16_t>(
+        std::min<uint32_t>(queued > _margin ? queued - _margin : 0, UINT16_MAX)));
+  }
+};
+
+} // namespace teslasynth::midisynth
@@ -0,0 +1,39 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <cstdint>
+
+namespace teslasynth::midisynth {
+
+/// A contiguous run of outputs rendered by one worker
+struct OutputRange {
+  uint8_t first = 0;
+  uint8_t count = 0;
+
+  constexpr uint8_t end() const { return first + count; }
+  constexpr bool empty() const { return count == 0; }
+  constexpr bool contains(uint8_t ch) const { return ch >= first && ch < end(); }
+  constexpr bool operator==(const OutputRange &b) const {
+    return first == b.first && count == b.count;
+  }
+};
+
+/**
+ * Outputs rendered by one of `workers` workers
+ *
+ * Outputs are split into contiguous ranges whose sizes differ by at most one,
+ * the larger ones first. Workers beyond the number of outputs get an empty
+ * range. Ranges never overlap, so each worker can render its outputs with
+ * only their locks held.
+ */
+constexpr OutputRange partition_outputs(uint8_t outputs, uint8_t workers, uint8_t worker) {
+  if (workers == 0 || worker >= workers)
+    return {};
+  const uint8_t base = outputs / workers, extra = outputs % workers;
+  const uint8_t first = worker * base + (worker < extra ? worker : extra);
+  return {first, static_cast<uint8_t>(base + (worker < extra ? 1 : 0))};
+}
+
+} // namespace teslasynth::midisynth
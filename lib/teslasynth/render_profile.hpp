@@ -0,0 +1,137 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace teslasynth::midisynth {
+
+/**
+ * Lock-free histogram with power of two buckets.
+ *
+ * Bucket `b` counts values that are `b` bits wide, from 2^(b-1) to 2^b - 1,
+ * and bucket 0 counts zeros. Any number of tasks and interrupts may record
+ * concurrently; readers see each counter as of some recent moment.
+ */
+class Histogram {
+public:
+  static constexpr size_t buckets = 33;
+
+private:
+  std::array<std::atomic<uint32_t>, buckets> _buckets{};
+  std::atomic<uint32_t> _count{0}, _max{0};
+
+public:
+  static constexpr size_t bucket_of(uint32_t value) {
+    size_t width = 0;
+    for (; value != 0; value >>= 1)
+      width++;
+    return width;
+  }
+  /// Largest value bucket `b` counts
+  static constexpr uint32_t upper_bound(size_t b) {
+    return b >= 32 ? UINT32_MAX : (uint32_t{1} << b) - 1;
+  }
+
+  void record(uint32_t value) {
+    _buckets[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    uint32_t max = _max.load(std::memory_order_relaxed);
+    while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+      ;
+  }
+
+  uint32_t count() const { return _count.load(std::memory_order_relaxed); }
+  uint32_t max() const { return _max.load(std::memory_order_relaxed); }
+  uint32_t bucket(size_t b) const { return _buckets[b].load(std::memory_order_relaxed); }
+
+  /// Upper bound of the `percent`th percentile, zero if nothing was recorded
+  uint32_t percentile(uint8_t percent) const {
+    const uint32_t count = this->count();
+    if (count == 0)
+      return 0;
+    const uint64_t rank = (static_cast<uint64_t>(count) * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (size_t b = 0; b < buckets; b++) {
+      seen += bucket(b);
+      if (seen >= rank && seen > 0)
+        return std::min(upper_bound(b), max());
+    }
+    return max();
+  }
+
+  void reset() {
+    for (auto &b : _buckets)
+      b.store(0, std::memory_order_relaxed);
+    _count.store(0, std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+  }
+};
+
+/// Parts of the input to output path that are timed
+enum class Stage : uint8_t {
+  Parse,    // received frames to queued messages
+  Handle,   // applying messages to the synth
+  Render,   // sampling pulses and encoding them to symbols
+  Transmit, // queueing symbols to the hardware
+  Block,    // a whole render block, from handling to transmitting
+};
+
+constexpr size_t stages = 5;
+constexpr const char *stage_names[stages] = {"parse", "handle", "render", "transmit", "block"};
+
+/**
+ * Timings of the render loop, kept while it runs.
+ *
+ * Durations are in ticks of whatever clock the platform times them with, a
+ * CPU cycle counter on the device. A block misses its deadline when it takes
+ * longer to make than the time it covers.
+ */
+struct RenderProfile {
+  std::array<Histogram, stages> timings;
+  /// Symbols queued per output and block
+  Histogram symbols;
+  std::atomic<uint32_t> deadline_misses{0};
+  /// Input messages that arrived while the queue to the renderer was full
+  std::atomic<uint32_t> input_dropped{0};
+
+  Histogram &timing(Stage stage) { return timings[static_cast<size_t>(stage)]; }
+  const Histogram &timing(Stage stage) const { return timings[static_cast<size_t>(stage)]; }
+
+  /// Records a block that took `spent` ticks to make `covered` ticks of output
+  void block(uint32_t spent, uint32_t covered) {
+    timing(Stage::Block).record(spent);
+    if (spent > covered)
+      deadline_misses.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void reset() {
+    for (auto &t : timings)
+      t.reset();
+    symbols.reset();
+    deadline_misses.store(0, std::memory_order_relaxed);
+    input_dropped.store(0, std::memory_order_relaxed);
+  }
+};
+
+/**
+ * Records the time from its construction to its destruction into a
+ * histogram. CLOCK provides `static uint32_t now()`; wrapping is fine.
+ */
+template <class CLOCK> class ScopeTimer {
+  Histogram &_histogram;
+  const uint32_t _start;
+
+public:
+  explicit ScopeTimer(Histogram &histogram) : _histogram(histogram), _start(CLOCK::now()) {}
+  ScopeTimer(const ScopeTimer &) = delete;
+  ScopeTimer &operator=(const ScopeTimer &) = delete;
+  ~ScopeTimer() { _histogram.record(CLOCK::now() - _start); }
+};
+
+} // namespace teslasynth::midisynth
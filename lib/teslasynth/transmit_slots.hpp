@@ -0,0 +1,64 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace teslasynth::midisynth {
+
+/**
+ * Tracks which of DEPTH render buffers of one output are free while the
+ * others are still being transmitted.
+ *
+ * The renderer takes the next slot, fills it and submits it before queueing
+ * it, so it can't be released before it was submitted; the transmitter
+ * releases slots in the order they were submitted, once the hardware is done
+ * reading them. A submitted slot is never handed out again before that, so
+ * rendering the next block overlaps transmitting the previous ones.
+ *
+ * Exactly one task may render and one context, like an interrupt, may
+ * release. Neither side blocks; indices run freely.
+ */
+template <size_t DEPTH> class TransmitSlots {
+  static_assert(DEPTH > 0, "at least one slot is needed");
+
+  std::atomic<uint32_t> _submitted{0}; // written by the renderer only
+  std::atomic<uint32_t> _released{0};  // written by the transmitter only
+
+public:
+  static constexpr size_t depth = DEPTH;
+
+  /// Renderer side; the slot to render into next, none while all are in flight
+  std::optional<size_t> next() const {
+    const uint32_t submitted = _submitted.load(std::memory_order_relaxed);
+    if (submitted - _released.load(std::memory_order_acquire) >= DEPTH)
+      return std::nullopt;
+    return submitted % DEPTH;
+  }
+
+  /// Renderer side; hands the slot returned by next() over to the transmitter
+  void submit() {
+    _submitted.store(_submitted.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  /// Renderer side; takes back the last submit, when it couldn't be transmitted after all
+  void retract() {
+    _submitted.store(_submitted.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+  }
+
+  /// Transmitter side; the oldest submitted slot is free again
+  void release() {
+    _released.store(_released.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  /// Approximate when read from the transmitter side
+  size_t in_flight() const {
+    return _submitted.load(std::memory_order_acquire) - _released.load(std::memory_order_acquire);
+  }
+};
+
+} // namespace teslasynth::midisynth
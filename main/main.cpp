@@ -40,6 +40,7 @@ extern "C" void app_main(void) {
     devices::midi::init(sbuf);
   }
 
+  // In both modes, so the `stats` command can profile a show while it plays
   cli::init(app.ui());
 
   while (1) {
@@ -2,11 +2,16 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <nanobind/nanobind.h>
+#include <nanobind/ndarray.h>
 #include <nanobind/stl/array.h>
 #include <nanobind/stl/optional.h>
 #include <nanobind/stl/string.h>
 #include <nanobind/stl/vector.h>
 
+#include <vector>
+
+#include "midi/smf_reader.hpp"
+#include "teslasynth/event_player.hpp"
 #include "teslasynth/midi_synth.hpp"
 #include "teslasynth/config_patch_update.hpp"
 #include "synthesizer/envelope.hpp"
@@ -33,6 +38,25 @@ using Routing = MidiRoutingConfig<8>;
 // written[] is uint8_t so the hard ceiling is 255.
 using Buffer = PulseBuffer<8, 200>;
 
+// Caller-owned output for sample_into(): out[ch, i] = [on_us, off_us].
+using PulseArray = nb::ndarray<uint32_t, nb::shape<8, -1, 2>, nb::c_contig, nb::device::cpu>;
+using CountArray = nb::ndarray<uint32_t, nb::shape<8>, nb::c_contig, nb::device::cpu>;
+using PulseTable = nb::ndarray<nb::numpy, uint32_t, nb::shape<-1, 2>>;
+using OffsetTable = nb::ndarray<nb::numpy, uint64_t, nb::shape<9>>;
+
+// One row of teslasynth.midi.EVENT_DTYPE, as produced by read_smf().
+struct EventRow {
+  uint64_t time_us;
+  uint8_t status, data0, data1;
+  uint8_t padding[5];
+};
+static_assert(sizeof(EventRow) == 16, "EventRow must match EVENT_DTYPE.itemsize");
+using EventRowBytes = nb::ndarray<nb::numpy, uint8_t, nb::shape<-1, sizeof(EventRow)>>;
+
+// Columns of a structured event array (see teslasynth.midi.EVENT_DTYPE).
+using TimeColumn = nb::ndarray<const uint64_t, nb::ndim<1>, nb::device::cpu>;
+using ByteColumn = nb::ndarray<const uint8_t, nb::ndim<1>, nb::device::cpu>;
+
 // Flat Python-visible envelope, avoiding std::variant exposure
 struct PyEnvelope {
   std::string type; // "adsr", "ad", "const"
@@ -72,6 +96,99 @@ static PyEnvelope to_py_envelope(const EnvelopeConfig &cfg) {
       cfg);
 }
 
+static Duration16 checked_budget(uint32_t budget_us) {
+  if (budget_us > 65535)
+    throw nb::value_error("budget_us must be ≤ 65535 (Duration16 limit ~65 ms). "
+                          "Use a smaller step_us.");
+  return Duration16::micros(static_cast<uint16_t>(budget_us));
+}
+
+// Renders one step of output `ch` as [on_us, off_us] pairs starting at `out`.
+static size_t sample_pairs(Synth &s, uint8_t ch, Duration16 budget, uint32_t *out,
+                           size_t capacity) {
+  return s.sample_channel(ch, budget, capacity, [out](size_t i, const Pulse &p) {
+    out[2 * i] = p.on.micros();
+    out[2 * i + 1] = p.off.micros();
+  });
+}
+
+// Hands a vector over to numpy without copying; the capsule frees it.
+static PulseTable to_pulse_table(std::vector<uint32_t> &&data) {
+  auto *owned = new std::vector<uint32_t>(std::move(data));
+  owned->reserve(2); // numpy wants a non-null pointer even for an empty table
+  nb::capsule owner(owned,
+                    [](void *p) noexcept { delete static_cast<std::vector<uint32_t> *>(p); });
+  return PulseTable(owned->data(), {owned->size() / 2, 2}, owner);
+}
+
+static OffsetTable to_offset_table(const std::array<uint64_t, 9> &offsets) {
+  auto *owned = new std::array<uint64_t, 9>(offsets);
+  nb::capsule owner(owned,
+                    [](void *p) noexcept { delete static_cast<std::array<uint64_t, 9> *>(p); });
+  return OffsetTable(owned->data(), {9}, owner);
+}
+
+static EventRowBytes to_event_rows(std::vector<EventRow> &&rows) {
+  auto *owned = new std::vector<EventRow>(std::move(rows));
+  owned->reserve(1); // numpy wants a non-null pointer even for an empty table
+  nb::capsule owner(owned,
+                    [](void *p) noexcept { delete static_cast<std::vector<EventRow> *>(p); });
+  return EventRowBytes(owned->data(), {owned->size(), sizeof(EventRow)}, owner);
+}
+
+// Borrowed view over a structured (time_us, status, data0, data1) event array.
+class EventColumns {
+  TimeColumn time_;
+  ByteColumn status_, data0_, data1_;
+
+public:
+  explicit EventColumns(nb::handle events)
+      : time_(nb::cast<TimeColumn>(events["time_us"])),
+        status_(nb::cast<ByteColumn>(events["status"])),
+        data0_(nb::cast<ByteColumn>(events["data0"])),
+        data1_(nb::cast<ByteColumn>(events["data1"])) {}
+
+  size_t size() const { return time_.shape(0); }
+  uint64_t time_us(size_t i) const { return time_(i); }
+
+  // Returns the channel message of row i, if it holds one.
+  std::optional<MidiChannelMessage> message(size_t i) const {
+    if (!MidiStatus::is_status(status_(i)))
+      return std::nullopt;
+    const MidiStatus st(status_(i));
+    if (!st.is_channel())
+      return std::nullopt;
+    return MidiChannelMessage{.type = st.channel_status_type(),
+                              .channel = st.channel(),
+                              .data0 = data0_(i),
+                              .data1 = data1_(i)};
+  }
+
+  // Engine events for every row holding a channel message.
+  std::vector<TimedChannelMessage> to_vector() const {
+    std::vector<TimedChannelMessage> result;
+    result.reserve(size());
+    for (size_t i = 0; i < size(); i++) {
+      if (i > 0 && time_us(i) < time_us(i - 1))
+        throw nb::value_error("events must be sorted by time_us");
+      if (auto msg = message(i))
+        result.push_back({time_us(i), *msg});
+    }
+    return result;
+  }
+};
+
+// Packs per-output [on_us, off_us] streams into the (pulses, offsets) pair.
+static nb::tuple to_render_result(const std::array<std::vector<uint32_t>, 8> &channels) {
+  std::array<uint64_t, 9> offsets{};
+  std::vector<uint32_t> flat;
+  for (uint8_t ch = 0; ch < 8; ch++) {
+    offsets[ch + 1] = offsets[ch] + channels[ch].size() / 2;
+    flat.insert(flat.end(), channels[ch].begin(), channels[ch].end());
+  }
+  return nb::make_tuple(to_pulse_table(std::move(flat)), to_offset_table(offsets));
+}
+
 static nb::dict percussion_to_dict(PercussionId id) {
   const size_t idx = static_cast<size_t>(id);
   const Percussion &p = percussion_kit[idx];
@@ -100,9 +217,12 @@ NB_MODULE(_teslasynth, m) {
         d["version"] = std::string(TESLASYNTH_VERSION);
         d["date"] = std::string(TESLASYNTH_BUILD_DATE);
         d["time"] = std::string(TESLASYNTH_BUILD_TIME);
+        d["fixed_point"] = std::is_same_v<Arithmetic, FixedArithmetic>;
+        d["engine_stats"] = EngineCounters::enabled;
         return d;
       },
-      "Return a dict with version, date and time of the build.");
+      "Return a dict with version, date and time of the build, and whether the engine "
+      "uses fixed-point arithmetic and keeps engine stats.");
 
   // -------------------------------------------------------------------------
   // Enums
@@ -148,6 +268,13 @@ NB_MODULE(_teslasynth, m) {
       .value("RiseFX", InstrumentId::RiseFX)
       .value("FallFX", InstrumentId::FallFX);
 
+  nb::enum_<LfoShape>(m, "LfoShape")
+      .value("Sine", LfoShape::Sine)
+      .value("Triangle", LfoShape::Triangle)
+      .value("Square", LfoShape::Square)
+      .value("SawUp", LfoShape::SawUp)
+      .value("SawDown", LfoShape::SawDown);
+
   nb::enum_<PercussionId>(m, "PercussionId")
       .value("Kick", PercussionId::Kick)
       .value("Snare", PercussionId::Snare)
@@ -199,6 +326,7 @@ NB_MODULE(_teslasynth, m) {
         d["envelope"] = to_py_envelope(instruments[idx].envelope);
         d["vibrato_rate_hz"] = static_cast<float>(instruments[idx].vibrato.freq);
         d["vibrato_depth_hz"] = static_cast<float>(instruments[idx].vibrato.depth);
+        d["vibrato_shape"] = instruments[idx].vibrato.shape;
         return d;
       },
       "id"_a, "Return a dict describing one instrument.");
@@ -215,6 +343,7 @@ NB_MODULE(_teslasynth, m) {
           d["envelope"] = to_py_envelope(instruments[i].envelope);
           d["vibrato_rate_hz"] = static_cast<float>(instruments[i].vibrato.freq);
           d["vibrato_depth_hz"] = static_cast<float>(instruments[i].vibrato.depth);
+          d["vibrato_shape"] = instruments[i].vibrato.shape;
           result.append(d);
         }
         return result;
@@ -281,6 +410,33 @@ NB_MODULE(_teslasynth, m) {
                   })
       .def("__repr__", [](const MidiChannelMessage &m) { return std::string(m); });
 
+  m.def(
+      "read_smf",
+      [](nb::bytes data) {
+        std::vector<EventRow> rows;
+        SmfError err;
+        {
+          nb::gil_scoped_release release;
+          err = read_smf(static_cast<const uint8_t *>(data.data()), data.size(),
+                         [&rows](const TimedChannelMessage &e) {
+                           rows.push_back({.time_us = e.time_us,
+                                           .status = MidiStatus(e.message.type, e.message.channel),
+                                           .data0 = e.message.data0,
+                                           .data1 = e.message.data1,
+                                           .padding = {}});
+                         });
+        }
+        if (err != SmfError::None)
+          throw nb::value_error(smf_error_message(err));
+        return to_event_rows(std::move(rows));
+      },
+      "data"_a,
+      "Parse a Standard MIDI File (format 0 or 1) held in *data*.\n\n"
+      "All tracks are merged and tempo changes applied in one native pass. Returns "
+      "an (N, 16) uint8 array with one row per channel message, laid out as "
+      "teslasynth.midi.EVENT_DTYPE; use teslasynth.midi.load_events() for the typed "
+      "view. Raises ValueError on malformed files.");
+
   // -------------------------------------------------------------------------
   // Configuration
   // -------------------------------------------------------------------------
@@ -379,6 +535,10 @@ NB_MODULE(_teslasynth, m) {
           "instrument", [](const SynthConfig &s) -> std::optional<uint8_t> { return s.instrument; },
           [](SynthConfig &s, std::optional<uint8_t> v) { s.instrument = v; },
           "Global default instrument (None = use per-channel selection)")
+      .def_prop_rw(
+          "latency_us", [](const SynthConfig &s) { return s.latency.micros(); },
+          [](SynthConfig &s, uint16_t v) { s.latency = Duration16::micros(v); },
+          "Fixed live input latency traded for jitter (0 = off, up to 50 ms)")
       .def("__repr__", [](const SynthConfig &s) { return std::string(s); });
 
   nb::class_<Config>(m, "Configuration")
@@ -440,6 +600,32 @@ NB_MODULE(_teslasynth, m) {
         return a.on.micros() == b.on.micros() && a.off.micros() == b.off.micros();
       });
 
+  // -------------------------------------------------------------------------
+  // EngineStats — per output counters returned by Teslasynth.stats()
+  // -------------------------------------------------------------------------
+
+  nb::class_<EngineStats>(m, "EngineStats")
+      .def_ro("pulses", &EngineStats::pulses, "Pulses played with some on time.")
+      .def_ro("skipped", &EngineStats::skipped,
+              "Pulses of notes that fell behind playback and were never played.")
+      .def_ro("limited", &EngineStats::limited, "Pulses the duty limiter silenced.")
+      .def_ro("limited_on_us", &EngineStats::limited_on_us,
+              "On time the duty limiter silenced, in microseconds.")
+      .def_ro("steals", &EngineStats::steals, "Notes that took the slot of a sounding note.")
+      .def_ro("peak_voices", &EngineStats::peak_voices, "Most notes sounding at once.")
+      .def_ro("dropped", &EngineStats::dropped,
+              "Scheduled messages that never took effect, as the schedule was full or the "
+              "track stopped.")
+      .def("__repr__", [](const EngineStats &s) {
+        return "EngineStats(pulses=" + std::to_string(s.pulses) +
+               ", skipped=" + std::to_string(s.skipped) +
+               ", limited=" + std::to_string(s.limited) +
+               ", limited_on_us=" + std::to_string(s.limited_on_us) +
+               ", steals=" + std::to_string(s.steals) +
+               ", peak_voices=" + std::to_string(s.peak_voices) +
+               ", dropped=" + std::to_string(s.dropped) + ")";
+      });
+
   // -------------------------------------------------------------------------
   // EnvelopeEngine — exact C++ Envelope implementation
   // -------------------------------------------------------------------------
@@ -486,11 +672,8 @@ NB_MODULE(_teslasynth, m) {
       .def(
           "sample_all",
           [](Synth &s, uint32_t budget_us) -> nb::list {
-            if (budget_us > 65535)
-              throw nb::value_error("budget_us must be ≤ 65535 (Duration16 limit ~65 ms). "
-                                    "Use a smaller step_us.");
             Buffer buf;
-            s.sample_all(Duration16::micros(static_cast<uint16_t>(budget_us)), buf);
+            s.sample_all(checked_budget(budget_us), buf);
             nb::list result;
             for (uint8_t ch = 0; ch < 8; ch++) {
               const uint8_t n = buf.written[ch];
@@ -512,6 +695,114 @@ NB_MODULE(_teslasynth, m) {
           "Synthesise up to budget_us µs (max 65535). "
           "Returns a list of 8 lists (one per output channel), "
           "each containing [on_us, off_us] pairs.")
+      .def(
+          "sample_into",
+          [](Synth &s, uint32_t budget_us, PulseArray out, CountArray counts) -> size_t {
+            const Duration16 budget = checked_budget(budget_us);
+            const size_t capacity = out.shape(1);
+            uint32_t *data = out.data();
+            uint32_t *written = counts.data();
+            size_t total = 0;
+            for (uint8_t ch = 0; ch < 8; ch++) {
+              written[ch] = s.track().is_playing()
+                                ? sample_pairs(s, ch, budget, data + ch * capacity * 2, capacity)
+                                : 0;
+              total += written[ch];
+            }
+            s.stop_when_silent();
+            return total;
+          },
+          "budget_us"_a, "out"_a, "counts"_a,
+          "Synthesise up to budget_us µs (max 65535) straight into caller-owned arrays.\n\n"
+          "*out* is a C-contiguous uint32 array of shape (8, capacity, 2); output *ch* "
+          "receives [on_us, off_us] rows in out[ch, :counts[ch]]. *counts* is a uint32 "
+          "array of shape (8,) that is overwritten with the number of rows written per "
+          "output. Returns the total number of pulses written.")
+      .def(
+          "render",
+          [](Synth &s, uint64_t duration_us, uint32_t step_us) {
+            const Duration16 step = checked_budget(step_us);
+            if (step.is_zero())
+              throw nb::value_error("step_us must be positive");
+            // The GIL stays held, as it's all that keeps other threads off the synth
+            std::array<std::vector<uint32_t>, 8> channels;
+            for (uint64_t t = 0; t < duration_us; t += step.micros()) {
+              const auto budget = Duration16::micros(
+                  static_cast<uint16_t>(std::min<uint64_t>(step.micros(), duration_us - t)));
+              if (!s.track().is_playing())
+                continue;
+              for (uint8_t ch = 0; ch < 8; ch++) {
+                auto &pulses = channels[ch];
+                const size_t at = pulses.size();
+                pulses.resize(at + Buffer::output_bufsize * 2);
+                const size_t n =
+                    sample_pairs(s, ch, budget, pulses.data() + at, Buffer::output_bufsize);
+                pulses.resize(at + n * 2);
+              }
+              s.stop_when_silent();
+            }
+            return to_render_result(channels);
+          },
+          "duration_us"_a, "step_us"_a = 10'000,
+          "Render *duration_us* µs of the current state in steps of *step_us* without "
+          "creating a Python object per pulse.\n\n"
+          "Returns ``(pulses, offsets)``: *pulses* is an (N, 2) uint32 array of "
+          "[on_us, off_us] rows for all 8 outputs back to back, and output *ch* occupies "
+          "pulses[offsets[ch]:offsets[ch + 1]].\n\n"
+          "Like every method it holds the GIL throughout, so a synth shared between "
+          "threads is only ever used by one at a time.")
+      .def(
+          "handle_many",
+          [](Synth &s, nb::handle events, size_t start, std::optional<uint64_t> until_us) {
+            const EventColumns columns(events);
+            const uint64_t until = until_us.value_or(UINT64_MAX);
+            size_t i = std::min(start, columns.size());
+            for (; i < columns.size() && columns.time_us(i) < until; i++)
+              if (auto msg = columns.message(i))
+                s.handle(*msg, Duration::micros(columns.time_us(i)));
+            return i;
+          },
+          "events"_a, "start"_a = 0, "until_us"_a = nb::none(),
+          "Feed rows of a structured event array (see teslasynth.midi.EVENT_DTYPE) in "
+          "one call.\n\n"
+          "Rows from *start* whose time_us is before *until_us* (all rows when None) are "
+          "handled in order; rows without a channel message are skipped. Returns the "
+          "index of the first row that was not handled.")
+      .def(
+          "render_events",
+          [](Synth &s, nb::handle events, uint32_t step_us) {
+            const Duration16 step = checked_budget(step_us);
+            if (step.is_zero())
+              throw nb::value_error("step_us must be positive");
+            const std::vector<TimedChannelMessage> timed = EventColumns(events).to_vector();
+            // Holds the GIL like render(), the player drives the synth
+            std::array<std::vector<uint32_t>, 8> channels;
+            EventPlayer<8> player(s, timed.data(), timed.size());
+            player.render(step, Buffer::output_bufsize, [&channels](uint8_t ch, const Pulse &p) {
+              channels[ch].push_back(p.on.micros());
+              channels[ch].push_back(p.off.micros());
+            });
+            return to_render_result(channels);
+          },
+          "events"_a, "step_us"_a = 10'000,
+          "Play a whole structured event array (see teslasynth.midi.EVENT_DTYPE) and "
+          "render it in steps of *step_us*, entirely in native code.\n\n"
+          "Events are applied window by window exactly like feeding handle() and "
+          "sampling once per step, until one step after the last event. Returns "
+          "``(pulses, offsets)`` in the same layout as render(), and holds the GIL "
+          "throughout like it.")
+      .def(
+          "stats",
+          [](const Synth &s, uint8_t ch) {
+            if (ch >= 8)
+              throw nb::index_error(
+                  ("output index " + std::to_string(ch) + " out of range (0–7)").c_str());
+            return s.stats(ch);
+          },
+          "ch"_a,
+          "Counters of what output *ch* played and dropped since the last reset_stats(). "
+          "Always zero unless build_info().engine_stats.")
+      .def("reset_stats", &Synth::reset_stats, "Zero the counters of every output.")
       .def("off", &Synth::off, "Silence all voices immediately.")
       .def("reload_config", &Synth::reload_config,
            "Apply configuration changes (also calls off()).")
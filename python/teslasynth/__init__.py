@@ -29,9 +29,11 @@ from . import (
 from ._teslasynth import (  # noqa: F401 — re-export C++ types
     ChannelConfig,
     Configuration,
+    EngineStats,
     Envelope,
     EnvelopeEngine,
     InstrumentId,
+    LfoShape,
     MidiChannelMessage,
     MidiMessageType,
     PercussionId,
@@ -39,6 +41,7 @@ from ._teslasynth import (  # noqa: F401 — re-export C++ types
     RoutingConfig,
     SynthConfig,
     Teslasynth,
+    read_smf,
     version,
 )
 from ._types import (  # noqa: F401 — typed Python wrappers
@@ -14,7 +14,7 @@ from dataclasses import dataclass
 from typing import TYPE_CHECKING
 
 if TYPE_CHECKING:
-    from ._teslasynth import Envelope, InstrumentId, PercussionId
+    from ._teslasynth import Envelope, InstrumentId, LfoShape, PercussionId
 
 
 @dataclass(frozen=True)
@@ -27,6 +27,7 @@ class InstrumentInfo:
     envelope: Envelope
     vibrato_rate_hz: float
     vibrato_depth_hz: float
+    vibrato_shape: LfoShape
 
 
 @dataclass(frozen=True)
@@ -50,6 +51,8 @@ class BuildInfo:
     version: str
     date: str
     time: str
+    fixed_point: bool = False
+    engine_stats: bool = False
 
 
 @dataclass(frozen=True)
@@ -15,6 +15,7 @@ Schema
     {
       "tuning":     440.0,
       "instrument": null,            // global instrument override, or 0-27
+      "latency":    0,               // microseconds of live input lookahead (0 disables)
       "channels": [
         {
           "notes":            4,
@@ -55,6 +56,7 @@ def to_dict(cfg: Configuration) -> dict:
     return {
         "tuning": cfg.synth.tuning_hz,
         "instrument": cfg.synth.instrument,
+        "latency": cfg.synth.latency_us,
         "channels": [
             {
                 "notes": cfg.channel(i).notes,
@@ -98,6 +100,11 @@ def _load_synth(cfg: Configuration, d: dict) -> None:
         cfg.synth.tuning_hz = v
     if "instrument" in d:
         cfg.synth.instrument = _opt_instrument(d["instrument"], "instrument")
+    if "latency" in d:
+        v = int(d["latency"])
+        if not (0 <= v <= 50_000):
+            raise ValueError(f"latency must be 0-50000, got {v}")
+        cfg.synth.latency_us = v
 
 
 def _load_channel(ch, c: dict) -> None:
@@ -2,19 +2,25 @@
 # SPDX-License-Identifier: LGPL-3.0-only
 
 """
-Convert mido MIDI messages to MidiChannelMessage and drive the synth from a
-.mid file, yielding pulses in fixed-size time steps.
+Read .mid files with the native SMF reader and drive the synth from them,
+yielding pulses in fixed-size time steps.
+
+The mido helpers are kept for callers that already hold mido objects; mido is
+not needed to read files.
 """
 
 from __future__ import annotations
 
-from typing import Generator, NamedTuple
+from typing import TYPE_CHECKING, Generator, NamedTuple
 
-import mido
+import numpy as np
 
-from ._teslasynth import MidiChannelMessage, Teslasynth
+from ._teslasynth import MidiChannelMessage, Teslasynth, read_smf
 from ._types import NoteEvent
 
+if TYPE_CHECKING:
+    import mido
+
 
 class _NoteKey(NamedTuple):
     channel: int
@@ -50,6 +56,9 @@ def _build_tempo_map(mid: mido.MidiFile) -> list[tuple[int, int]]:
 
     Tempo changes in SMF affect all tracks simultaneously regardless of which
     track they appear on. This collects them all into one sorted list.
+
+    Files are read natively by :func:`load_events`; this and
+    :func:`_ticks_to_us` are the pure-Python reference for its timing.
     """
     changes: list[tuple[int, int]] = []
     for track in mid.tracks:
@@ -79,6 +88,55 @@ def _ticks_to_us(
     return us
 
 
+#: Row layout of the event arrays taken by :meth:`~Teslasynth.handle_many` and
+#: :meth:`~Teslasynth.render_events`: absolute time plus the raw status and
+#: data bytes of a channel message.
+EVENT_DTYPE = np.dtype(
+    {
+        "names": ["time_us", "status", "data0", "data1"],
+        "formats": ["<u8", "u1", "u1", "u1"],
+        "offsets": [0, 8, 9, 10],
+        "itemsize": 16,
+    }
+)
+
+
+def load_events(path: str) -> np.ndarray:
+    """Read the channel messages of a .mid file into an :data:`EVENT_DTYPE` array.
+
+    Parsing, track merging and tempo conversion happen in one native pass (see
+    :func:`~teslasynth.read_smf`). Rows are sorted by ``time_us``; events on
+    the same tick keep track order.
+    """
+    with open(path, "rb") as f:
+        data = f.read()
+    return read_smf(data).view(EVENT_DTYPE).reshape(-1)
+
+
+def _steps(
+    synth: Teslasynth,
+    path: str,
+    step_us: int = 10_000,
+) -> Generator[int, None, None]:
+    """Feed *synth* the events of each step and yield the step start time.
+
+    The caller samples the synth once per yielded step.
+    """
+    synth.off()
+    events = load_events(path)
+    if not len(events):
+        return
+    total_us = int(events["time_us"][-1])
+
+    event_idx = 0
+    time_us = 0
+
+    while time_us <= total_us + step_us:
+        event_idx = synth.handle_many(events, event_idx, time_us + step_us)
+        yield time_us
+        time_us += step_us
+
+
 def _drive_synth(
     synth: Teslasynth,
     path: str,
@@ -90,40 +148,27 @@ def _drive_synth(
     :meth:`~Teslasynth.sample_all` — 8 output channels, each a list of
     :class:`~teslasynth.Pulse` objects.
     """
-    synth.off()
-    mid = mido.MidiFile(path)
-    tempo_map = _build_tempo_map(mid)
-
-    raw: list[tuple[int, MidiChannelMessage]] = []
-    for track in mid.tracks:
-        abs_ticks = 0
-        for msg in track:
-            abs_ticks += msg.time
-            cm = from_mido(msg)
-            if cm is not None:
-                raw.append((abs_ticks, cm))
-
-    if not raw:
-        return
+    for time_us in _steps(synth, path, step_us):
+        yield time_us, synth.sample_all(step_us)
 
-    raw.sort(key=lambda x: x[0])
-    events = [
-        (_ticks_to_us(tick, mid.ticks_per_beat, tempo_map), cm) for tick, cm in raw
-    ]
-    total_us = events[-1][0]
 
-    event_idx = 0
-    time_us = 0
+def render_file_arrays(
+    synth: Teslasynth,
+    path: str,
+    step_us: int = 10_000,
+) -> tuple[np.ndarray, np.ndarray]:
+    """Render a whole MIDI file into flat pulse arrays.
 
-    while time_us <= total_us + step_us:
-        window_end = time_us + step_us
-        while event_idx < len(events) and events[event_idx][0] < window_end:
-            t, msg = events[event_idx]
-            synth.handle(msg, t)
-            event_idx += 1
+    The file is played by :meth:`~Teslasynth.render_events` in a single
+    native call, so no Python object is created per event or per pulse.
 
-        yield time_us, synth.sample_all(step_us)
-        time_us += step_us
+    Returns ``(pulses, offsets)`` in the same layout as
+    :meth:`~Teslasynth.render`: *pulses* is an ``(N, 2)`` uint32 array of
+    ``[on_us, off_us]`` rows for all 8 outputs back to back, and output *ch*
+    occupies ``pulses[offsets[ch]:offsets[ch + 1]]``.
+    """
+    synth.off()
+    return synth.render_events(load_events(path), step_us)
 
 
 def render_file(
@@ -189,42 +234,32 @@ def notes_from_midi(path: str) -> list[NoteEvent]:
     Returns a list of :class:`~teslasynth._types.NoteEvent` sorted by start
     time.
     """
-    mid = mido.MidiFile(path)
-    tempo_map = _build_tempo_map(mid)
-
-    events: list[tuple[int, object]] = []
-    for track in mid.tracks:
-        abs_ticks = 0
-        for msg in track:
-            abs_ticks += msg.time
-            if msg.type in ("note_on", "note_off"):
-                events.append((abs_ticks, msg))
-    events.sort(key=lambda x: x[0])
-
     pending: dict[_NoteKey, _PendingNote] = {}
     notes: list[NoteEvent] = []
-
-    for abs_ticks, msg in events:
-        time_us = _ticks_to_us(abs_ticks, mid.ticks_per_beat, tempo_map)
-        key = _NoteKey(msg.channel, msg.note)
-        if msg.type == "note_on" and msg.velocity > 0:
-            pending[key] = _PendingNote(time_us, msg.velocity)
-        else:
-            if key in pending:
-                p = pending.pop(key)
-                notes.append(
-                    NoteEvent(
-                        channel=key.channel,
-                        note=key.note,
-                        velocity=p.velocity,
-                        start_us=p.start_us,
-                        end_us=time_us,
-                    )
+    tail_us: int | None = None
+
+    for time_us, status, note, velocity in load_events(path).tolist():
+        kind = status & 0xF0
+        if kind not in (0x80, 0x90):
+            continue
+        tail_us = time_us
+        key = _NoteKey(status & 0x0F, note)
+        if kind == 0x90 and velocity > 0:
+            pending[key] = _PendingNote(time_us, velocity)
+        elif key in pending:
+            p = pending.pop(key)
+            notes.append(
+                NoteEvent(
+                    channel=key.channel,
+                    note=key.note,
+                    velocity=p.velocity,
+                    start_us=p.start_us,
+                    end_us=time_us,
                 )
+            )
 
     # Close any notes still open at end of file
-    if events:
-        tail_us = _ticks_to_us(events[-1][0], mid.ticks_per_beat, tempo_map)
+    if tail_us is not None:
         for key, p in pending.items():
             notes.append(
                 NoteEvent(
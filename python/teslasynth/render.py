@@ -13,7 +13,7 @@ from typing import Generator, Iterable
 import numpy as np
 
 from ._teslasynth import Teslasynth
-from .midi import pulse_stream, render_file, render_file_all_channels
+from .midi import render_file, render_file_all_channels, render_file_arrays
 
 
 @dataclass
@@ -123,6 +123,34 @@ class Recording:
         )
         return cls(pulses=arr, step_us=step_us)
 
+    @classmethod
+    def from_arrays(
+        cls,
+        pulses: np.ndarray,
+        offsets: np.ndarray,
+        channel: int = 0,
+        step_us: int = 10_000,
+    ) -> Recording:
+        """Build a Recording for one output from flat pulse arrays.
+
+        Accepts the ``(pulses, offsets)`` pair returned by
+        :meth:`~teslasynth.Teslasynth.render` and
+        :func:`~teslasynth.midi.render_file_arrays` without copying.
+
+        Parameters
+        ----------
+        pulses:
+            ``(N, 2)`` uint32 array of ``[on_us, off_us]`` rows for all outputs.
+        offsets:
+            Output *ch* occupies ``pulses[offsets[ch]:offsets[ch + 1]]``.
+        channel:
+            Output channel index to record (default 0).
+        step_us:
+            Step size recorded for reference; does not affect the data.
+        """
+        start, end = int(offsets[channel]), int(offsets[channel + 1])
+        return cls(pulses=pulses[start:end], step_us=step_us)
+
 
 # ------------------------------------------------------------------
 # Streaming signal generator
@@ -209,7 +237,7 @@ def from_file(
 ) -> Recording:
     """Render a MIDI file and return a :class:`Recording`.
 
-    Convenience wrapper around :meth:`Recording.from_stream`.
+    Convenience wrapper around :meth:`Recording.from_arrays`.
 
     Parameters
     ----------
@@ -218,7 +246,5 @@ def from_file(
     """
     if synth is None:
         synth = Teslasynth()
-    return Recording.from_stream(
-        pulse_stream(synth, path, step_us=step_us, channel=channel),
-        step_us=step_us,
-    )
+    pulses, offsets = render_file_arrays(synth, path, step_us=step_us)
+    return Recording.from_arrays(pulses, offsets, channel=channel, step_us=step_us)
@@ -260,6 +260,14 @@ class TestSynthConfig:
         s.tuning_hz = 432.0
         assert s.tuning_hz == pytest.approx(432.0, rel=0.001)
 
+    def test_latency(self):
+        from teslasynth import SynthConfig
+
+        s = SynthConfig()
+        assert s.latency_us == 0
+        s.latency_us = 15_000
+        assert s.latency_us == 15_000
+
 
 # ---------------------------------------------------------------------------
 # RoutingConfig
@@ -401,13 +409,19 @@ class TestGetInstrument:
         assert isinstance(info, InstrumentInfo)
 
     def test_fields_populated(self):
-        from teslasynth import InstrumentId, get_instrument
+        from teslasynth import InstrumentId, LfoShape, get_instrument
 
         info = get_instrument(InstrumentId.SynthPluck)
         assert isinstance(info.name, str) and len(info.name) > 0
         assert isinstance(info.index, int)
         assert info.vibrato_rate_hz >= 0.0
         assert info.vibrato_depth_hz >= 0.0
+        assert info.vibrato_shape == LfoShape.Sine
+
+    def test_vibrato_shape(self):
+        from teslasynth import LfoShape, get_all_instruments
+
+        assert all(i.vibrato_shape == LfoShape.Sine for i in get_all_instruments())
 
     def test_get_all_instruments_count(self):
         from teslasynth import get_all_instruments
@@ -490,6 +504,8 @@ class TestBuildInfo:
         assert isinstance(info.version, str)
         assert isinstance(info.date, str)
         assert isinstance(info.time, str)
+        assert isinstance(info.fixed_point, bool)
+        assert isinstance(info.engine_stats, bool)
 
     def test_version_nonempty(self):
         from teslasynth import build_info
@@ -605,3 +621,210 @@ class TestTeslasynth:
         s = Teslasynth()
         with pytest.raises(ValueError):
             s.sample_all(70_000)  # > 65535
+
+    def test_sample_into_matches_sample_all(self):
+        import numpy as np
+
+        from teslasynth import MidiChannelMessage, Teslasynth
+
+        a, b = Teslasynth(), Teslasynth()
+        for s in (a, b):
+            s.handle(MidiChannelMessage.note_on(0, 60, 100), 0)
+            s.handle(MidiChannelMessage.note_on(1, 64, 100), 0)
+
+        out = np.zeros((8, 200, 2), dtype=np.uint32)
+        counts = np.zeros(8, dtype=np.uint32)
+        total = b.sample_into(10_000, out, counts)
+        expected = a.sample_all(10_000)
+
+        assert total == sum(len(ch) for ch in expected)
+        for ch in range(8):
+            assert counts[ch] == len(expected[ch])
+            got = [tuple(row) for row in out[ch, : counts[ch]]]
+            assert got == [(p.on_us, p.off_us) for p in expected[ch]]
+
+    def test_sample_into_respects_capacity(self):
+        import numpy as np
+
+        from teslasynth import MidiChannelMessage, Teslasynth
+
+        s = Teslasynth()
+        s.handle(MidiChannelMessage.note_on(0, 100, 127), 0)
+        out = np.zeros((8, 2, 2), dtype=np.uint32)
+        counts = np.zeros(8, dtype=np.uint32)
+        s.sample_into(10_000, out, counts)
+        assert counts[0] == 2
+
+    def test_sample_into_rejects_wrong_shape(self):
+        import numpy as np
+
+        from teslasynth import Teslasynth
+
+        s = Teslasynth()
+        counts = np.zeros(8, dtype=np.uint32)
+        with pytest.raises(TypeError):
+            s.sample_into(10_000, np.zeros((4, 10, 2), dtype=np.uint32), counts)
+
+    def test_render_layout(self):
+        import numpy as np
+
+        from teslasynth import MidiChannelMessage, Teslasynth
+
+        s = Teslasynth()
+        s.handle(MidiChannelMessage.note_on(0, 60, 100), 0)
+        pulses, offsets = s.render(100_000)
+        assert pulses.dtype == np.uint32
+        assert pulses.shape[1] == 2
+        assert offsets.shape == (9,)
+        assert offsets[0] == 0 and offsets[-1] == len(pulses)
+        ch0 = pulses[offsets[0] : offsets[1]]
+        assert int(ch0.astype(np.int64).sum()) >= 100_000
+
+    def test_render_matches_sample_all(self):
+        from teslasynth import MidiChannelMessage, Teslasynth
+
+        a, b = Teslasynth(), Teslasynth()
+        for s in (a, b):
+            s.handle(MidiChannelMessage.note_on(0, 60, 100), 0)
+
+        expected = []
+        for _ in range(5):
+            expected += [(p.on_us, p.off_us) for p in a.sample_all(10_000)[0]]
+        pulses, offsets = b.render(50_000, step_us=10_000)
+        got = [tuple(row) for row in pulses[offsets[0] : offsets[1]]]
+        assert got == expected
+
+    def test_handle_many_stops_at_until(self):
+        import numpy as np
+
+        from teslasynth import Teslasynth
+        from teslasynth.midi import EVENT_DTYPE
+
+        events = np.array(
+            [(0, 0x90, 60, 100), (0, 0xF8, 0, 0), (20_000, 0x80, 60, 0)],
+            dtype=EVENT_DTYPE,
+        )
+        s = Teslasynth()
+        assert s.handle_many(events, until_us=10_000) == 2
+        assert s.handle_many(events, 2) == 3
+        assert s.handle_many(events, 3) == 3
+
+    def test_handle_many_matches_handle(self):
+        import numpy as np
+
+        from teslasynth import MidiChannelMessage, Teslasynth
+        from teslasynth.midi import EVENT_DTYPE
+
+        a, b = Teslasynth(), Teslasynth()
+        a.handle(MidiChannelMessage.note_on(0, 60, 100), 0)
+        a.handle(MidiChannelMessage.note_on(1, 64, 90), 1_000)
+        b.handle_many(
+            np.array([(0, 0x90, 60, 100), (1_000, 0x91, 64, 90)], dtype=EVENT_DTYPE)
+        )
+        assert a.sample_all(10_000)[1] == b.sample_all(10_000)[1]
+
+    def test_render_events_matches_stepping(self):
+        import numpy as np
+
+        from teslasynth import Teslasynth
+        from teslasynth.midi import EVENT_DTYPE
+
+        events = np.array(
+            [(0, 0x90, 60, 100), (15_000, 0x91, 67, 80), (32_000, 0x80, 60, 0)],
+            dtype=EVENT_DTYPE,
+        )
+        a, b = Teslasynth(), Teslasynth()
+        expected = [[] for _ in range(8)]
+        idx, time_us = 0, 0
+        while time_us <= 32_000 + 10_000:
+            idx = a.handle_many(events, idx, time_us + 10_000)
+            for ch, pulses in enumerate(a.sample_all(10_000)):
+                expected[ch] += [[p.on_us, p.off_us] for p in pulses]
+            time_us += 10_000
+
+        pulses, offsets = b.render_events(events, step_us=10_000)
+        for ch in range(8):
+            assert pulses[offsets[ch] : offsets[ch + 1]].tolist() == expected[ch]
+
+    def test_render_events_rejects_unsorted(self):
+        import numpy as np
+
+        from teslasynth import Teslasynth
+        from teslasynth.midi import EVENT_DTYPE
+
+        events = np.array([(10, 0x90, 60, 100), (0, 0x80, 60, 0)], dtype=EVENT_DTYPE)
+        with pytest.raises(ValueError):
+            Teslasynth().render_events(events)
+
+    def test_stats_count_pulses(self):
+        from teslasynth import MidiChannelMessage, Teslasynth, build_info
+
+        if not build_info().engine_stats:
+            pytest.skip("built without engine stats")
+        s = Teslasynth()
+        s.handle(MidiChannelMessage.note_on(0, 60, 100), 0)
+        pulses = [p for p in s.sample_all(10_000)[0] if p.on_us > 0]
+        stats = s.stats(0)
+        assert stats.pulses == len(pulses)
+        assert stats.peak_voices == 1
+        assert s.stats(1).pulses == 0
+
+        s.reset_stats()
+        assert s.stats(0).pulses == 0
+
+    def test_stats_count_dropped_messages(self):
+        from teslasynth import MidiChannelMessage, Teslasynth, build_info
+
+        if not build_info().engine_stats:
+            pytest.skip("built without engine stats")
+        s = Teslasynth()
+        s.handle(MidiChannelMessage.note_on(0, 60, 100), 0)
+        # Ahead of playback, so they wait in the schedule until the track stops
+        for i in range(3):
+            s.handle(MidiChannelMessage.pitchbend(0, 8192 + i), 1_000 * (i + 1))
+        assert s.stats(0).dropped == 0
+
+        s.off()
+        stats = s.stats(0)
+        assert stats.dropped == 3
+        assert "dropped=3" in repr(stats)
+
+    def test_stats_rejects_bad_output(self):
+        from teslasynth import Teslasynth
+
+        with pytest.raises(IndexError):
+            Teslasynth().stats(8)
+
+
+@requires_extension
+class TestReadSmf:
+    # Format 0, 96 ticks per beat, note on at tick 0 and note off at tick 96
+    SMF = (
+        b"MThd\x00\x00\x00\x06\x00\x00\x00\x01\x00\x60"
+        b"MTrk\x00\x00\x00\x0c"
+        b"\x00\x90\x3c\x64\x60\x80\x3c\x00\x00\xff\x2f\x00"
+    )
+
+    def test_rows(self):
+        import numpy as np
+
+        from teslasynth import read_smf
+
+        rows = read_smf(self.SMF)
+        assert rows.dtype == np.uint8
+        assert rows.shape == (2, 16)
+
+    def test_event_view(self):
+        from teslasynth import read_smf
+        from teslasynth.midi import EVENT_DTYPE
+
+        events = read_smf(self.SMF).view(EVENT_DTYPE).reshape(-1)
+        assert events.tolist() == [(0, 0x90, 60, 100), (500_000, 0x80, 60, 0)]
+
+    def test_rejects_garbage(self):
+        from teslasynth import read_smf
+
+        with pytest.raises(ValueError):
+            read_smf(b"not a midi file")
+        with pytest.raises(ValueError):
+            read_smf(self.SMF[:-6])
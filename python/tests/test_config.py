@@ -31,7 +31,7 @@ class TestRoundTrip:
         from teslasynth.config import to_dict
 
         d = to_dict(Configuration())
-        assert set(d.keys()) == {"tuning", "instrument", "channels", "routing"}
+        assert set(d.keys()) == {"tuning", "instrument", "latency", "channels", "routing"}
         assert isinstance(d["tuning"], float)
         assert isinstance(d["channels"], list)
         assert len(d["channels"]) == 8
@@ -164,6 +164,12 @@ class TestValidation:
         with pytest.raises(ValueError, match="tuning"):
             from_dict({"tuning": 0.0})
 
+    def test_invalid_latency(self):
+        from teslasynth.config import from_dict
+
+        with pytest.raises(ValueError, match="latency"):
+            from_dict({"latency": 200_000})
+
     def test_invalid_max_on_time(self):
         from teslasynth.config import from_dict
 
@@ -5,6 +5,7 @@
 Tests for teslasynth.midi — tempo map building, tick→µs conversion, note extraction.
 """
 
+import numpy as np
 import pytest
 
 from .conftest import requires_extension
@@ -177,3 +178,58 @@ class TestNotesFromMidi:
         notes = notes_from_midi(str(path))
         starts = [n.start_us for n in notes]
         assert starts == sorted(starts)
+
+
+@requires_extension
+class TestLoadEvents:
+    def test_rows(self, simple_midi):
+        from teslasynth.midi import EVENT_DTYPE, load_events
+
+        events = load_events(simple_midi)
+        assert events.dtype == EVENT_DTYPE
+        assert events["time_us"].tolist() == [0, 500_000]
+        assert events["status"].tolist() == [0x90, 0x80]
+        assert events["data0"].tolist() == [60, 60]
+        assert events["data1"].tolist() == [100, 0]
+
+    def test_skips_meta_messages(self, tmp_path):
+        import mido
+
+        from teslasynth.midi import load_events
+
+        mid = mido.MidiFile(ticks_per_beat=480)
+        track = mido.MidiTrack()
+        mid.tracks.append(track)
+        track.append(mido.MetaMessage("set_tempo", tempo=500_000, time=0))
+        track.append(mido.Message("program_change", channel=2, program=5, time=0))
+        track.append(mido.MetaMessage("end_of_track", time=0))
+        path = tmp_path / "meta.mid"
+        mid.save(str(path))
+        events = load_events(str(path))
+        assert len(events) == 1
+        assert events[0]["status"] == 0xC2
+        assert events[0]["data0"] == 5
+
+    def test_matches_reference_tempo_map(self, tmp_path):
+        """Native timing equals the pure-Python tempo map on multi-track files."""
+        import mido
+
+        from teslasynth.midi import _build_tempo_map, _ticks_to_us, load_events
+
+        mid = mido.MidiFile(ticks_per_beat=96)
+        conductor = mido.MidiTrack()
+        conductor.append(mido.MetaMessage("set_tempo", tempo=400_000, time=0))
+        conductor.append(mido.MetaMessage("set_tempo", tempo=731_113, time=250))
+        conductor.append(mido.MetaMessage("set_tempo", tempo=123_457, time=77))
+        notes = mido.MidiTrack()
+        for i in range(40):
+            notes.append(mido.Message("note_on", note=40 + i, velocity=90, time=13))
+            notes.append(mido.Message("note_off", note=40 + i, velocity=0, time=5))
+        mid.tracks += [conductor, notes]
+        path = tmp_path / "tempo.mid"
+        mid.save(str(path))
+
+        tempo_map = _build_tempo_map(mid)
+        ticks = np.cumsum([msg.time for msg in notes])
+        expected = [_ticks_to_us(int(t), 96, tempo_map) for t in ticks]
+        assert load_events(str(path))["time_us"].tolist() == expected
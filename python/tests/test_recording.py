@@ -96,3 +96,27 @@ class TestDutyCycle:
         duty = recording_440hz.duty_cycle
         silent = recording_440hz.pulses[:, 0] == 0
         assert np.all(duty[silent] == 0.0)
+
+
+@requires_extension
+class TestFromArrays:
+    def test_selects_channel_slice(self):
+        import numpy as np
+
+        from teslasynth.render import Recording
+
+        pulses = np.array([[1, 2], [3, 4], [5, 6]], dtype=np.uint32)
+        offsets = np.array([0, 1, 3, 3, 3, 3, 3, 3, 3], dtype=np.uint64)
+        rec = Recording.from_arrays(pulses, offsets, channel=1, step_us=2_000)
+        assert rec.pulses.tolist() == [[3, 4], [5, 6]]
+        assert rec.step_us == 2_000
+
+    def test_empty_channel(self):
+        import numpy as np
+
+        from teslasynth.render import Recording
+
+        pulses = np.array([[1, 2]], dtype=np.uint32)
+        offsets = np.array([0, 1, 1, 1, 1, 1, 1, 1, 1], dtype=np.uint64)
+        rec = Recording.from_arrays(pulses, offsets, channel=5)
+        assert rec.pulses.shape == (0, 2)
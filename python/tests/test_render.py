@@ -121,3 +121,24 @@ class TestRenderFileAllChannels:
             for (t1, p1), (t2, p2) in zip(single, all_ch):
                 assert t1 == t2
                 assert len(p1) == len(p2)
+
+
+@requires_extension
+class TestFromFile:
+    def test_matches_pulse_stream(self, simple_midi):
+        from teslasynth import Teslasynth
+        from teslasynth.midi import pulse_stream
+        from teslasynth.render import from_file
+
+        rec = from_file(simple_midi, synth=Teslasynth())
+        expected = [[on, off] for _, on, off in pulse_stream(Teslasynth(), simple_midi)]
+        assert rec.pulses.tolist() == expected
+
+    def test_render_file_arrays_offsets(self, simple_midi):
+        from teslasynth import Teslasynth
+        from teslasynth.midi import render_file_arrays
+
+        pulses, offsets = render_file_arrays(Teslasynth(), simple_midi)
+        assert len(offsets) == 9
+        assert offsets[-1] == len(pulses)
+        assert offsets[1] > offsets[0]
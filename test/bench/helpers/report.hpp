@@ -0,0 +1,100 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+/// One measured case, its parameters and what it measured
+struct Result {
+  std::string name;
+  std::vector<std::pair<std::string, std::string>> params;
+  std::vector<std::pair<std::string, double>> metrics;
+
+  Result &param(const std::string &key, const std::string &value) {
+    params.emplace_back(key, value);
+    return *this;
+  }
+  Result &param(const std::string &key, long value) { return param(key, std::to_string(value)); }
+  Result &metric(const std::string &key, double value) {
+    metrics.emplace_back(key, value);
+    return *this;
+  }
+};
+
+/**
+ * Collects results and writes them as JSON, to the file named by
+ * TESLASYNTH_BENCH_JSON or to bench.json in the working directory:
+ *
+ *   {"benchmarks": [{"name": ..., "params": {...}, "metrics": {...}}, ...]}
+ *
+ * Parameters are strings and metrics are numbers, so runs can be diffed
+ * case by case.
+ */
+class Report {
+  std::vector<Result> _results;
+
+  static std::string quoted(const std::string &s) {
+    std::string res = "\"";
+    for (char c : s) {
+      if (c == '"' || c == '\\')
+        res += '\\';
+      res += c;
+    }
+    return res + "\"";
+  }
+
+public:
+  Result &add(const std::string &name) {
+    _results.push_back({name, {}, {}});
+    return _results.back();
+  }
+  const std::vector<Result> &results() const { return _results; }
+
+  std::string json() const {
+    std::string res = "{\"benchmarks\": [";
+    for (size_t i = 0; i < _results.size(); i++) {
+      const auto &r = _results[i];
+      res += i == 0 ? "\n  {" : ",\n  {";
+      res += "\"name\": " + quoted(r.name) + ", \"params\": {";
+      for (size_t j = 0; j < r.params.size(); j++)
+        res += (j == 0 ? "" : ", ") + quoted(r.params[j].first) + ": " +
+               quoted(r.params[j].second);
+      res += "}, \"metrics\": {";
+      for (size_t j = 0; j < r.metrics.size(); j++) {
+        char value[32];
+        std::snprintf(value, sizeof(value), "%.6g", r.metrics[j].second);
+        res += (j == 0 ? "" : ", ") + quoted(r.metrics[j].first) + ": " + value;
+      }
+      res += "}}";
+    }
+    return res + "\n]}\n";
+  }
+
+  /// Returns false if the file couldn't be written
+  bool write() const {
+    const char *path = std::getenv("TESLASYNTH_BENCH_JSON");
+    std::FILE *file = std::fopen(path != nullptr ? path : "bench.json", "w");
+    if (file == nullptr)
+      return false;
+    const std::string out = json();
+    const bool ok = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+    return std::fclose(file) == 0 && ok;
+  }
+};
+
+/// Wall clock time of `f()`, in seconds
+template <class F> double seconds(F &&f) {
+  const auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace bench
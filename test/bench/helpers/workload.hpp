@@ -0,0 +1,75 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "midi_core.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace bench {
+using namespace teslasynth::midi;
+
+/// Shape of a synthetic MIDI stream that keeps every output busy
+struct Workload {
+  /// MIDI channels 0 to channels - 1 play, which route to outputs of the same number
+  uint8_t channels = 1;
+  /// Notes sounding at once on each channel
+  uint8_t polyphony = 1;
+  /// Notes are picked from [low_note, high_note], higher notes pulse faster
+  uint8_t low_note = 48, high_note = 72;
+  uint32_t note_us = 200'000;
+  uint32_t length_us = 1'000'000;
+  /// Plays everything on the percussion channel instead
+  bool percussion = false;
+  uint32_t seed = 1;
+};
+
+/**
+ * Note on and off messages sorted by time, where each channel restarts a
+ * note as soon as one of its notes ends. Notes of a channel start staggered
+ * so they don't all end together. The same workload always gives the same
+ * stream.
+ */
+inline std::vector<TimedChannelMessage> dense_midi(const Workload &w) {
+  std::vector<TimedChannelMessage> res;
+  uint32_t state = w.seed;
+  auto random_note = [&] {
+    state = state * 1103515245 + 12345;
+    return static_cast<uint8_t>(w.low_note + (state >> 16) % (w.high_note - w.low_note + 1));
+  };
+
+  const uint32_t stagger = std::max<uint32_t>(1, w.note_us / std::max<uint8_t>(1, w.polyphony));
+  for (uint8_t ch = 0; ch < w.channels; ch++) {
+    const uint8_t channel = w.percussion ? 9 : ch;
+    for (uint8_t slot = 0; slot < w.polyphony; slot++)
+      for (uint32_t t = slot * stagger + ch; t < w.length_us; t += w.note_us) {
+        const uint8_t note = random_note();
+        res.push_back({t, MidiChannelMessage::note_on(channel, note, 100)});
+        res.push_back({std::min(t + w.note_us - 1, w.length_us),
+                       MidiChannelMessage::note_off(channel, note, 0)});
+      }
+  }
+  std::stable_sort(res.begin(), res.end(),
+                   [](const auto &a, const auto &b) { return a.time_us < b.time_us; });
+  return res;
+}
+
+/// The wire bytes of `events`, with running status like most senders use
+inline std::vector<uint8_t> midi_bytes(const std::vector<TimedChannelMessage> &events) {
+  std::vector<uint8_t> res;
+  res.reserve(events.size() * 3);
+  uint8_t status = 0;
+  for (const auto &e : events) {
+    const auto &msg = e.message;
+    const uint8_t s = static_cast<uint8_t>(msg.type) | msg.channel.value;
+    if (s != status)
+      res.push_back(status = s);
+    res.push_back(msg.data0);
+    res.push_back(msg.data1);
+  }
+  return res;
+}
+
+} // namespace bench
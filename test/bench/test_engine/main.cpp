@@ -0,0 +1,293 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "bench/helpers/report.hpp"
+#include "bench/helpers/workload.hpp"
+#include "config_data.hpp"
+#include "config_patch_update.hpp"
+#include "midi_core.hpp"
+#include "midi_parser.hpp"
+#include "midi_synth.hpp"
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unity.h>
+#include <vector>
+
+using namespace teslasynth::midisynth;
+using namespace bench;
+
+static Report report;
+
+constexpr uint8_t max_polyphony = 16;
+constexpr Duration16 block = 2_ms;
+
+constexpr std::array<Instrument, 1> constant{{
+    {.envelope = EnvelopeLevel(1), .vibrato = Vibrato::none()},
+}};
+constexpr std::array<Instrument, 1> adsr_exp{{
+    {.envelope = envelopes::ADSR::exponential(5_ms, 50_ms, EnvelopeLevel(0.7), 50_ms),
+     .vibrato = Vibrato::none()},
+}};
+constexpr std::array<Instrument, 1> adsr_lin{{
+    {.envelope = envelopes::ADSR::linear(5_ms, 50_ms, EnvelopeLevel(0.7), 50_ms),
+     .vibrato = Vibrato::none()},
+}};
+constexpr std::array<Instrument, 1> vibrato{{
+    {.envelope = envelopes::ADSR::exponential(5_ms, 50_ms, EnvelopeLevel(0.7), 50_ms),
+     .vibrato = {5_hz, 1.5_hz}},
+}};
+
+struct EngineCase {
+  std::string instrument;
+  uint8_t outputs, polyphony;
+  /// Names the note range, which sets the pulse rate
+  std::string rate;
+};
+
+static void use_instrument(auto &synth, const std::string &name) {
+  if (name == "const")
+    synth.use_instruments(constant);
+  else if (name == "adsr-lin")
+    synth.use_instruments(adsr_lin);
+  else if (name == "vibrato")
+    synth.use_instruments(vibrato);
+  else
+    synth.use_instruments(adsr_exp);
+}
+
+static Workload workload_of(const EngineCase &c) {
+  Workload w{.channels = c.outputs, .polyphony = c.polyphony, .percussion = c.instrument == "hit"};
+  if (c.rate == "low")
+    w.low_note = 24, w.high_note = 48;
+  else if (c.rate == "high")
+    w.low_note = 84, w.high_note = 108;
+  if (w.percussion)
+    w.note_us = 50'000;
+  return w;
+}
+
+template <uint8_t OUTPUTS> static void bench_sample_all(const EngineCase &c) {
+  auto synth = std::make_unique<Teslasynth<OUTPUTS, Voice<max_polyphony>>>();
+  for (uint8_t ch = 0; ch < OUTPUTS; ch++) {
+    synth->configuration().channel(ch).notes = c.polyphony;
+    synth->configuration().channel(ch).max_duty = DutyCycle::max();
+  }
+  if (c.instrument == "hit") {
+    synth->configuration().routing().percussion = true;
+    synth->configuration().routing().mapping[9] = OutputNumberOpt<OUTPUTS>(0);
+  }
+  synth->reload_config();
+  use_instrument(*synth, c.instrument);
+
+  const Workload w = workload_of(c);
+  const auto events = dense_midi(w);
+  PulseBuffer<OUTPUTS, 64> buffer;
+  uint64_t pulses = 0, blocks = 0, saturated = 0;
+
+  const double wall = seconds([&] {
+    size_t next = 0;
+    for (uint32_t t = 0; t < w.length_us; t += block.micros(), blocks++) {
+      for (; next < events.size() && events[next].time_us < t + block.micros(); next++)
+        synth->handle(events[next].message, Duration::micros(events[next].time_us));
+      synth->sample_all(block, buffer);
+      for (uint8_t ch = 0; ch < OUTPUTS; ch++) {
+        for (uint8_t i = 0; i < buffer.data_size(ch); i++)
+          pulses += !buffer.at(ch, i).on.is_zero();
+        saturated += buffer.data_size(ch) == buffer.output_bufsize;
+      }
+    }
+  });
+
+  TEST_ASSERT_GREATER_THAN(0, pulses);
+  const double audio = w.length_us / 1e6;
+  report.add("sample_all")
+      .param("instrument", c.instrument)
+      .param("outputs", c.outputs)
+      .param("polyphony", c.polyphony)
+      .param("rate", c.rate)
+      .metric("realtime", audio / wall)
+      .metric("pulses_per_s", pulses / wall)
+      .metric("ns_per_block", wall * 1e9 / blocks)
+      .metric("ns_per_pulse", wall * 1e9 / pulses)
+      .metric("pulses", pulses)
+      .metric("saturated_blocks", saturated);
+}
+
+static void bench_sample_all(const EngineCase &c) {
+  switch (c.outputs) {
+  case 1:
+    return bench_sample_all<1>(c);
+  case 4:
+    return bench_sample_all<4>(c);
+  default:
+    return bench_sample_all<8>(c);
+  }
+}
+
+void test_sample_all_by_outputs_and_polyphony(void) {
+  for (uint8_t outputs : {1, 4, 8})
+    for (uint8_t polyphony : {1, 4, 16})
+      bench_sample_all({"adsr-exp", outputs, polyphony, "mid"});
+}
+
+void test_sample_all_by_instrument(void) {
+  for (const char *instrument : {"const", "adsr-exp", "adsr-lin", "vibrato"})
+    bench_sample_all({instrument, 4, 4, "mid"});
+  // Percussion only plays on one MIDI channel
+  bench_sample_all({"hit", 1, 4, "mid"});
+}
+
+void test_sample_all_by_pulse_rate(void) {
+  for (const char *rate : {"low", "mid", "high"})
+    bench_sample_all({"adsr-exp", 4, 4, rate});
+}
+
+/**
+ * Like the test_parser vectors: a run of random length of every channel
+ * message type, each under running status
+ */
+static std::vector<uint8_t> all_types_bytes(size_t runs) {
+  std::vector<uint8_t> res;
+  uint32_t state = 1;
+  auto random = [&state](uint32_t range) {
+    state = state * 1103515245 + 12345;
+    return (state >> 16) % range;
+  };
+  constexpr uint8_t types[] = {0x80, 0x90, 0xA0, 0xB0, 0xC0, 0xD0, 0xE0};
+  for (size_t run = 0; run < runs; run++)
+    for (uint8_t type : types) {
+      res.push_back(type | random(16));
+      const size_t data = (type == 0xC0 || type == 0xD0 ? 1 : 2) * random(128);
+      for (size_t i = 0; i < data; i++)
+        res.push_back(random(128));
+    }
+  return res;
+}
+
+template <class PARSER, class FEED>
+static void bench_parser(const std::string &sink, const std::string &input,
+                         const std::vector<uint8_t> &bytes, size_t expected, PARSER &parser,
+                         FEED &&feed, const uint64_t &messages) {
+  constexpr size_t chunk = 64;
+  constexpr int repeats = 50;
+  const uint64_t before = messages;
+  const double wall = seconds([&] {
+    for (int r = 0; r < repeats; r++)
+      for (size_t at = 0; at < bytes.size(); at += chunk)
+        feed(parser, bytes.data() + at, std::min(chunk, bytes.size() - at));
+  });
+
+  TEST_ASSERT_EQUAL_UINT64(expected * repeats, messages - before);
+  const double total = static_cast<double>(bytes.size()) * repeats;
+  report.add("parser_feed")
+      .param("sink", sink)
+      .param("input", input)
+      .param("chunk", chunk)
+      .metric("bytes_per_s", total / wall)
+      .metric("messages_per_s", (messages - before) / wall)
+      .metric("ns_per_byte", wall * 1e9 / total);
+}
+
+static void bench_parser_sinks(const std::string &input, const std::vector<uint8_t> &bytes) {
+  uint64_t messages = 0, expected = 0;
+  MidiParser count([&](const MidiChannelMessage &) { expected++; });
+  count.feed(bytes.data(), bytes.size());
+
+  auto feed = [](auto &parser, const uint8_t *data, size_t len) { parser.feed(data, len); };
+  // Type erased, how every parser called back before it took its sink as a template parameter
+  MidiParser<> erased([&](const MidiChannelMessage &) { messages++; });
+  bench_parser("erased", input, bytes, expected, erased, feed, messages);
+  MidiParser inlined([&](const MidiChannelMessage &) { messages++; });
+  bench_parser("inline", input, bytes, expected, inlined, feed, messages);
+
+  BatchMidiParser batch;
+  std::array<MidiChannelMessage, 64> out;
+  bench_parser("batch", input, bytes, expected, batch,
+               [&](BatchMidiParser &parser, const uint8_t *data, size_t len) {
+                 messages += parser.feed_batch(data, len, out.data(), out.size());
+               },
+               messages);
+}
+
+void test_parser_feed(void) {
+  const auto events = dense_midi({.channels = 8, .polyphony = 4, .length_us = 10'000'000});
+  bench_parser_sinks("dense", midi_bytes(events));
+  bench_parser_sinks("all-types", all_types_bytes(400));
+}
+
+/// The patch expression that sets every integer valued field of `config`
+template <uint8_t OUTPUTS> static std::string patch_of(const Configuration<OUTPUTS> &config) {
+  std::string res = "synth.latency=" + std::to_string(config.synth().latency.micros()) + "us";
+  if (config.synth().instrument)
+    res += " synth.instrument=" + std::to_string(*config.synth().instrument + 1);
+  for (uint8_t i = 0; i < OUTPUTS; i++) {
+    const auto &ch = config.channel(i);
+    const std::string prefix = " output." + std::to_string(i + 1) + ".";
+    res += prefix + "max-on-time=" + std::to_string(ch.max_on_time.micros()) + "us";
+    res += prefix + "min-deadtime=" + std::to_string(ch.min_deadtime.micros()) + "us";
+    res += prefix + "duty-window=" + std::to_string(ch.duty_window.micros()) + "us";
+    res += prefix + "pulse-resolution=" + std::to_string(ch.pulse_resolution.micros()) + "us";
+    res += prefix + "notes=" + std::to_string(ch.notes);
+    res += prefix + "instrument=" + (ch.instrument ? std::to_string(*ch.instrument + 1) : "-");
+  }
+  return res;
+}
+
+void test_config_round_trip(void) {
+  Configuration<8> config;
+  config.synth().latency = 5_ms;
+  config.synth().instrument = 3;
+  for (uint8_t i = 0; i < 8; i++) {
+    auto &ch = config.channel(i);
+    ch.max_on_time = Duration16::micros(100 + 10 * i);
+    ch.min_deadtime = Duration16::micros(50 + i);
+    ch.pulse_resolution = Duration16::micros(i);
+    ch.notes = 1 + i % (ChannelConfig::max_notes - 1);
+    ch.instrument = i % 2 == 0 ? std::optional<uint8_t>(i) : std::nullopt;
+  }
+
+  constexpr int round_trips = 20'000;
+  size_t length = 0;
+  bool equal = true;
+  const double wall = seconds([&] {
+    for (int i = 0; i < round_trips; i++) {
+      const std::string patch = patch_of(config);
+      Configuration<8> decoded;
+      equal &= static_cast<bool>(config::patch::update(patch, decoded)) &&
+               decoded.synth() == config.synth();
+      for (uint8_t ch = 0; ch < 8; ch++)
+        equal &= decoded.channel(ch) == config.channel(ch);
+      length = patch.size();
+    }
+  });
+
+  TEST_ASSERT_TRUE(equal);
+  report.add("config_round_trip")
+      .param("outputs", 8)
+      .metric("round_trips_per_s", round_trips / wall)
+      .metric("us_per_round_trip", wall * 1e6 / round_trips)
+      .metric("bytes", length);
+}
+
+void test_write_report(void) {
+  TEST_ASSERT_TRUE(report.write());
+  std::fputs(report.json().c_str(), stdout);
+}
+
+extern "C" void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_sample_all_by_outputs_and_polyphony);
+  RUN_TEST(test_sample_all_by_instrument);
+  RUN_TEST(test_sample_all_by_pulse_rate);
+  RUN_TEST(test_parser_feed);
+  RUN_TEST(test_config_round_trip);
+  RUN_TEST(test_write_report);
+  UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  app_main();
+}
@@ -0,0 +1,211 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "ble_midi.hpp"
+#include "midi_core.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unity.h>
+#include <vector>
+
+using namespace teslasynth::midi;
+
+using Bytes = std::vector<uint8_t>;
+using Events = std::vector<TimedChannelMessage>;
+
+struct Collect {
+  Events *events;
+  void operator()(const TimedChannelMessage &e) const { events->push_back(e); }
+};
+
+static void assert_message(const MidiChannelMessage &expected, const TimedChannelMessage &actual) {
+  TEST_ASSERT_TRUE_MESSAGE(expected == actual.message,
+                           (std::string(actual.message) + " != " + std::string(expected)).c_str());
+}
+
+static bool decode(BleMidiDecoder<Collect> &decoder, const Bytes &packet, uint64_t arrival_us) {
+  return decoder.decode(packet.data(), packet.size(), arrival_us);
+}
+
+static uint64_t map(BleMidiClock &clock, uint16_t timestamp, uint64_t arrival_us) {
+  clock.sync(timestamp, arrival_us);
+  return clock.map(timestamp);
+}
+
+// Captured from a phone app playing a chord: header, then one timestamp per message
+void test_should_decode_full_messages(void) {
+  Events events;
+  BleMidiDecoder<Collect> decoder({&events});
+  TEST_ASSERT_TRUE(
+      decode(decoder, {0xB5, 0xE2, 0x90, 0x3C, 0x64, 0xE2, 0x90, 0x40, 0x64}, 1'000'000));
+
+  TEST_ASSERT_EQUAL(2, events.size());
+  assert_message(MidiChannelMessage::note_on(0, 60, 100), events[0]);
+  assert_message(MidiChannelMessage::note_on(0, 64, 100), events[1]);
+  TEST_ASSERT_EQUAL_UINT64(1'000'000, events[0].time_us);
+  TEST_ASSERT_EQUAL_UINT64(1'000'000, events[1].time_us);
+}
+
+void test_should_decode_running_status(void) {
+  Events events;
+  BleMidiDecoder<Collect> decoder({&events});
+  // With a timestamp of its own, then without one, then a one byte message
+  TEST_ASSERT_TRUE(decode(decoder,
+                          {0x80, 0x81, 0x91, 0x3C, 0x64, 0x85, 0x3E, 0x64, 0x40, 0x64, 0x86, 0xC1,
+                           0x05, 0x06},
+                          500'000));
+
+  TEST_ASSERT_EQUAL(5, events.size());
+  assert_message(MidiChannelMessage::note_on(1, 60, 100), events[0]);
+  assert_message(MidiChannelMessage::note_on(1, 62, 100), events[1]);
+  assert_message(MidiChannelMessage::note_on(1, 64, 100), events[2]);
+  TEST_ASSERT_TRUE(MidiMessageType::ProgramChange == events[3].message.type);
+  TEST_ASSERT_EQUAL(5, events[3].message.data0);
+  TEST_ASSERT_EQUAL(6, events[4].message.data0);
+
+  // Sent at 1, 5, 5, 6 and 6ms, the last one just before the packet arrived
+  TEST_ASSERT_EQUAL_UINT64(495'000, events[0].time_us);
+  TEST_ASSERT_EQUAL_UINT64(499'000, events[1].time_us);
+  TEST_ASSERT_EQUAL_UINT64(499'000, events[2].time_us);
+  TEST_ASSERT_EQUAL_UINT64(500'000, events[3].time_us);
+  TEST_ASSERT_EQUAL_UINT64(500'000, events[4].time_us);
+}
+
+void test_should_carry_the_timestamp_over_in_a_packet(void) {
+  Events events;
+  BleMidiDecoder<Collect> decoder({&events});
+  // Lower bits go from 127 to 1, so the upper bits went from 5 to 6
+  TEST_ASSERT_TRUE(
+      decode(decoder, {0x85, 0xFF, 0x90, 0x3C, 0x64, 0x81, 0x80, 0x3C, 0x00}, 10'000));
+
+  TEST_ASSERT_EQUAL(2, events.size());
+  assert_message(MidiChannelMessage::note_off(0, 60, 0), events[1]);
+  TEST_ASSERT_EQUAL_UINT64(2'000, events[1].time_us - events[0].time_us);
+}
+
+void test_should_skip_sysex_across_packets(void) {
+  Events events;
+  BleMidiDecoder<Collect> decoder({&events});
+  TEST_ASSERT_TRUE(decode(decoder, {0x80, 0x80, 0x90, 0x3C, 0x64, 0x81, 0xF0, 0x7D, 0x01, 0x02},
+                          1'000'000));
+  // The continuation starts right after the header, and the end has a timestamp
+  TEST_ASSERT_TRUE(decode(decoder, {0x80, 0x03, 0x04, 0x82, 0xF7, 0x82, 0x90, 0x3E, 0x64},
+                          1'002'000));
+
+  TEST_ASSERT_EQUAL(2, events.size());
+  assert_message(MidiChannelMessage::note_on(0, 60, 100), events[0]);
+  assert_message(MidiChannelMessage::note_on(0, 62, 100), events[1]);
+}
+
+void test_should_keep_running_status_over_realtime(void) {
+  Events events;
+  BleMidiDecoder<Collect> decoder({&events});
+  TEST_ASSERT_TRUE(decode(decoder,
+                          {0x80, 0x80, 0xB2, 0x07, 0x40, 0x80, 0xF8, 0x80, 0x07, 0x50, 0x80, 0xF1,
+                           0x10, 0x07, 0x60},
+                          0));
+
+  // Timing clock leaves the status alone, a system common message cancels it
+  TEST_ASSERT_EQUAL(2, events.size());
+  assert_message(MidiChannelMessage::control_change(2, ControlChange::CHANNEL_VOLUME_MSB, 0x50),
+                 events[1]);
+}
+
+void test_should_reject_bad_packets(void) {
+  Events events;
+  BleMidiDecoder<Collect> decoder({&events});
+  TEST_ASSERT_FALSE(decode(decoder, {0x3C, 0x64, 0x90}, 0));
+  TEST_ASSERT_FALSE(decode(decoder, {0xC0, 0x80, 0x90, 0x3C, 0x64}, 0));
+  TEST_ASSERT_FALSE(decode(decoder, {0x80}, 0));
+  // A timestamp in the middle of a message
+  TEST_ASSERT_FALSE(decode(decoder, {0x80, 0x80, 0x90, 0x3C, 0x81, 0x64}, 0));
+  TEST_ASSERT_EQUAL(0, events.size());
+}
+
+void test_clock_should_remove_connection_interval_jitter(void) {
+  BleMidiClock clock;
+  // Sent every 10ms, delivered at the next 7.5ms connection event
+  uint64_t previous = 0;
+  for (uint32_t sent = 0; sent < 2'000; sent += 10) {
+    const uint64_t arrival = 3'000'000 + ((sent * 1000 / 7500) + 1) * 7500;
+    const uint64_t mapped = map(clock, sent % BleMidiClock::timestamp_wrap, arrival);
+    TEST_ASSERT_TRUE(mapped <= arrival);
+    // Once the shortest delay is seen, only the drift allowance moves them
+    if (sent > 20)
+      TEST_ASSERT_TRUE_MESSAGE(mapped - previous >= 9'990 && mapped - previous <= 10'010,
+                               std::to_string(mapped - previous).c_str());
+    previous = mapped;
+  }
+}
+
+void test_clock_should_unwrap_timestamps(void) {
+  BleMidiClock clock;
+  const uint64_t start = map(clock, 8000, 1'000'000);
+  TEST_ASSERT_EQUAL_UINT64(1'000'000, start);
+  // 300ms later the sender's timestamp wrapped
+  TEST_ASSERT_EQUAL_UINT64(start + 300'000, map(clock, (8000 + 300) % 8192, 1'300'000));
+  // A gap longer than the wrap
+  TEST_ASSERT_EQUAL_UINT64(start + 20'300'000, map(clock, (8000 + 20'300) % 8192, 21'300'000));
+  // Earlier messages of the same packet map before it
+  TEST_ASSERT_EQUAL_UINT64(start + 20'290'000, clock.map((8000 + 20'290) % 8192));
+}
+
+void test_clock_should_follow_drift(void) {
+  BleMidiClock clock;
+  // The sender's clock runs 100ppm slower, messages take exactly 5ms
+  for (uint64_t now = 0; now <= 120'000'000; now += 50'000) {
+    const uint64_t sent_us = now - now / 10'000;
+    const uint64_t arrival = 1'000'000 + now + 5'000;
+    const uint64_t mapped =
+        map(clock, static_cast<uint16_t>(sent_us / 1000 % BleMidiClock::timestamp_wrap), arrival);
+    TEST_ASSERT_TRUE(mapped <= arrival);
+    TEST_ASSERT_TRUE_MESSAGE(arrival - mapped < 2'000, std::to_string(arrival - mapped).c_str());
+  }
+}
+
+void test_clock_should_resync_after_a_sender_reset(void) {
+  BleMidiClock clock;
+  map(clock, 4000, 1'000'000);
+  map(clock, 4100, 1'100'000);
+  // The sender restarted its clock, so its times suddenly lag far behind
+  TEST_ASSERT_EQUAL_UINT64(1'200'000, map(clock, 1000, 1'200'000));
+  const uint64_t next = map(clock, 1050, 1'255'000);
+  TEST_ASSERT_TRUE(next >= 1'250'000 && next <= 1'250'100);
+}
+
+void test_reset_should_forget_the_sender(void) {
+  Events events;
+  BleMidiDecoder<Collect> decoder({&events});
+  TEST_ASSERT_TRUE(decode(decoder, {0x80, 0x80, 0x90, 0x3C, 0x64, 0x80, 0xF0, 0x01}, 1'000'000));
+  TEST_ASSERT_EQUAL(1, events.size());
+  decoder.reset();
+  TEST_ASSERT_FALSE(decoder.clock().synced());
+
+  // Neither the running status nor the sysex is left over
+  events.clear();
+  TEST_ASSERT_TRUE(decode(decoder, {0x80, 0x90, 0x3C, 0x64, 0x90, 0x90, 0x3E, 0x64}, 9'000'000));
+  TEST_ASSERT_EQUAL(1, events.size());
+  assert_message(MidiChannelMessage::note_on(0, 62, 100), events[0]);
+  TEST_ASSERT_EQUAL_UINT64(9'000'000, events[0].time_us);
+}
+
+extern "C" void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_should_decode_full_messages);
+  RUN_TEST(test_should_decode_running_status);
+  RUN_TEST(test_should_carry_the_timestamp_over_in_a_packet);
+  RUN_TEST(test_should_skip_sysex_across_packets);
+  RUN_TEST(test_should_keep_running_status_over_realtime);
+  RUN_TEST(test_should_reject_bad_packets);
+  RUN_TEST(test_clock_should_remove_connection_interval_jitter);
+  RUN_TEST(test_clock_should_unwrap_timestamps);
+  RUN_TEST(test_clock_should_follow_drift);
+  RUN_TEST(test_clock_should_resync_after_a_sender_reset);
+  RUN_TEST(test_reset_should_forget_the_sender);
+  UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  app_main();
+}
@@ -0,0 +1,123 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "event_queue.hpp"
+#include "midi_core.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <unity.h>
+
+using namespace teslasynth::midi;
+
+static TimedChannelMessage event(uint32_t seq) {
+  return {
+      .time_us = seq,
+      .message = MidiChannelMessage::note_on(seq % 16, (seq >> 4) % 128, (seq >> 11) % 128),
+  };
+}
+
+static void assert_event(uint32_t seq, const TimedChannelMessage &e) {
+  const TimedChannelMessage expected = event(seq);
+  TEST_ASSERT_EQUAL_UINT64(expected.time_us, e.time_us);
+  TEST_ASSERT_TRUE(expected.message == e.message);
+}
+
+void queue_starts_empty(void) {
+  EventQueue<8> queue;
+  TimedChannelMessage e;
+  TEST_ASSERT_TRUE(queue.empty());
+  TEST_ASSERT_FALSE(queue.pop(e));
+  TEST_ASSERT_EQUAL(0, queue.drain([](const TimedChannelMessage &) { TEST_FAIL(); }));
+}
+
+void queue_is_fifo(void) {
+  EventQueue<8> queue;
+  for (uint32_t i = 0; i < 5; i++)
+    TEST_ASSERT_TRUE(queue.push(event(i)));
+  TEST_ASSERT_EQUAL(5, queue.size());
+
+  TimedChannelMessage e;
+  for (uint32_t i = 0; i < 5; i++) {
+    TEST_ASSERT_TRUE(queue.pop(e));
+    assert_event(i, e);
+  }
+  TEST_ASSERT_FALSE(queue.pop(e));
+}
+
+void queue_drops_when_full(void) {
+  EventQueue<4> queue;
+  for (uint32_t i = 0; i < 4; i++)
+    TEST_ASSERT_TRUE(queue.push(event(i)));
+  TEST_ASSERT_FALSE(queue.push(event(4)));
+  TEST_ASSERT_FALSE(queue.push(event(5)));
+  TEST_ASSERT_EQUAL(2, queue.dropped());
+
+  TimedChannelMessage e;
+  TEST_ASSERT_TRUE(queue.pop(e));
+  assert_event(0, e);
+  TEST_ASSERT_TRUE(queue.push(event(6)));
+  TEST_ASSERT_EQUAL(4, queue.size());
+}
+
+void queue_drain_wraps_around(void) {
+  EventQueue<4> queue;
+  uint32_t pushed = 0, expected = 0;
+  for (int round = 0; round < 10; round++) {
+    for (int i = 0; i < 3; i++)
+      TEST_ASSERT_TRUE(queue.push(event(pushed++)));
+    const size_t drained = queue.drain([&](const TimedChannelMessage &e) {
+      assert_event(expected++, e);
+    });
+    TEST_ASSERT_EQUAL(3, drained);
+  }
+  TEST_ASSERT_EQUAL(pushed, expected);
+  TEST_ASSERT_TRUE(queue.empty());
+}
+
+void queue_stress_with_two_threads(void) {
+  constexpr uint32_t total = 2'000'000;
+  static EventQueue<64> queue;
+
+  std::thread producer([&] {
+    for (uint32_t i = 0; i < total;) {
+      if (queue.push(event(i)))
+        i++;
+      else
+        std::this_thread::yield();
+    }
+  });
+
+  uint32_t expected = 0;
+  bool ordered = true;
+  while (expected < total) {
+    const size_t drained = queue.drain([&](const TimedChannelMessage &e) {
+      const TimedChannelMessage want = event(expected++);
+      ordered &= e.time_us == want.time_us && e.message == want.message;
+    });
+    if (drained == 0)
+      std::this_thread::yield();
+  }
+  producer.join();
+
+  TEST_ASSERT_TRUE(ordered);
+  TEST_ASSERT_EQUAL_UINT32(total, expected);
+  TEST_ASSERT_TRUE(queue.empty());
+  // Drops are counted, but this producer retries so every message arrives
+  TimedChannelMessage e;
+  TEST_ASSERT_FALSE(queue.pop(e));
+}
+
+extern "C" void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(queue_starts_empty);
+  RUN_TEST(queue_is_fifo);
+  RUN_TEST(queue_drops_when_full);
+  RUN_TEST(queue_drain_wraps_around);
+  RUN_TEST(queue_stress_with_two_threads);
+  UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  app_main();
+}
@@ -0,0 +1,135 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "midi_core.hpp"
+#include "midi_frame.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unity.h>
+#include <vector>
+
+using namespace teslasynth::midi;
+
+using Bytes = std::vector<uint8_t>;
+using Events = std::vector<TimedChannelMessage>;
+
+static Events read(const uint8_t *data, size_t len, bool expected = true) {
+  Events res;
+  const bool ok =
+      read_frames(data, len, [&res](const TimedChannelMessage &e) { res.push_back(e); });
+  TEST_ASSERT_EQUAL(expected, ok);
+  return res;
+}
+
+static Events read(const Bytes &data, bool expected = true) {
+  return read(data.data(), data.size(), expected);
+}
+
+static void assert_event(const TimedChannelMessage &expected, const TimedChannelMessage &actual) {
+  TEST_ASSERT_EQUAL_UINT64(expected.time_us, actual.time_us);
+  TEST_ASSERT_TRUE_MESSAGE(expected.message == actual.message,
+                           (std::string(actual.message) + " != " + std::string(expected.message))
+                               .c_str());
+}
+
+void test_should_read_what_was_written(void) {
+  const Events events{
+      {1'000'000, MidiChannelMessage::note_on(0, 60, 100)},
+      {1'000'000, MidiChannelMessage::note_on(0, 64, 100)},
+      {1'000'090, MidiChannelMessage::control_change(3, ControlChange::CHANNEL_VOLUME_MSB, 20)},
+      {1'200'000, MidiChannelMessage::program_change(15, 5)},
+      {1'200'001, MidiChannelMessage::note_off(9, 36, 0)},
+  };
+  uint8_t buffer[128];
+  FrameWriter writer(buffer, sizeof(buffer));
+  for (const auto &e : events)
+    TEST_ASSERT_TRUE(writer.append(e));
+
+  const Events res = read(writer.data(), writer.size());
+  TEST_ASSERT_EQUAL(events.size(), res.size());
+  for (size_t i = 0; i < events.size(); i++)
+    assert_event(events[i], res[i]);
+}
+
+void test_should_be_compact(void) {
+  uint8_t buffer[64];
+  FrameWriter writer(buffer, sizeof(buffer));
+  TEST_ASSERT_TRUE(writer.append({300, MidiChannelMessage::note_on(1, 60, 100)}));
+  TEST_ASSERT_TRUE(writer.append({300, MidiChannelMessage::note_on(1, 64, 100)}));
+  TEST_ASSERT_TRUE(writer.append({400, MidiChannelMessage::program_change(2, 7)}));
+
+  // The first delta is the absolute time, the rest only what passed since
+  const Bytes expected{0xAC, 0x02, 0x91, 60, 100, 0x00, 0x91, 64, 100, 0x64, 0xC2, 7};
+  TEST_ASSERT_TRUE(Bytes(writer.data(), writer.data() + writer.size()) == expected);
+}
+
+void test_should_not_go_back_in_time(void) {
+  uint8_t buffer[64];
+  FrameWriter writer(buffer, sizeof(buffer));
+  TEST_ASSERT_TRUE(writer.append({5'000, MidiChannelMessage::note_on(0, 60, 100)}));
+  TEST_ASSERT_TRUE(writer.append({4'000, MidiChannelMessage::note_on(0, 62, 100)}));
+  TEST_ASSERT_TRUE(writer.append({6'000, MidiChannelMessage::note_on(0, 64, 100)}));
+
+  const Events res = read(writer.data(), writer.size());
+  TEST_ASSERT_EQUAL(3, res.size());
+  TEST_ASSERT_EQUAL_UINT64(5'000, res[1].time_us);
+  TEST_ASSERT_EQUAL_UINT64(6'000, res[2].time_us);
+}
+
+void test_should_refuse_a_frame_that_does_not_fit(void) {
+  uint8_t buffer[10];
+  FrameWriter writer(buffer, sizeof(buffer));
+  TEST_ASSERT_TRUE(writer.append({1, MidiChannelMessage::note_on(0, 60, 100)}));
+  TEST_ASSERT_TRUE(writer.append({2, MidiChannelMessage::note_on(0, 62, 100)}));
+  TEST_ASSERT_FALSE(writer.append({3, MidiChannelMessage::note_on(0, 64, 100)}));
+  TEST_ASSERT_EQUAL(8, writer.size());
+  TEST_ASSERT_EQUAL(2, read(writer.data(), writer.size()).size());
+
+  // A new chunk starts from the absolute time again
+  writer.clear();
+  TEST_ASSERT_TRUE(writer.empty());
+  TEST_ASSERT_TRUE(writer.append({3, MidiChannelMessage::note_on(0, 64, 100)}));
+  const Events res = read(writer.data(), writer.size());
+  TEST_ASSERT_EQUAL(1, res.size());
+  TEST_ASSERT_EQUAL_UINT64(3, res[0].time_us);
+}
+
+void test_should_hold_the_largest_time(void) {
+  uint8_t buffer[FrameWriter::max_frame_size];
+  FrameWriter writer(buffer, sizeof(buffer));
+  const TimedChannelMessage event{UINT64_MAX, MidiChannelMessage::note_on(0, 60, 100)};
+  TEST_ASSERT_TRUE(writer.append(event));
+  TEST_ASSERT_EQUAL(FrameWriter::max_frame_size, writer.size());
+  assert_event(event, read(writer.data(), writer.size())[0]);
+}
+
+void test_should_reject_broken_chunks(void) {
+  // Frames before the broken one are kept
+  TEST_ASSERT_EQUAL(1, read({0x00, 0x90, 60, 100, 0x00, 0x90, 62}, false).size());
+  TEST_ASSERT_EQUAL(0, read({0x80}, false).size());
+  TEST_ASSERT_EQUAL(0, read({0x00, 60, 100}, false).size());
+  TEST_ASSERT_EQUAL(0, read({0x00, 0xF8}, false).size());
+  TEST_ASSERT_EQUAL(0, read({0x00, 0x90, 60, 0x90}, false).size());
+  // A delta longer than 64 bits
+  TEST_ASSERT_EQUAL(
+      0, read({0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0x90, 60, 100},
+              false)
+             .size());
+  TEST_ASSERT_EQUAL(0, read(Bytes{}).size());
+}
+
+extern "C" void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_should_read_what_was_written);
+  RUN_TEST(test_should_be_compact);
+  RUN_TEST(test_should_not_go_back_in_time);
+  RUN_TEST(test_should_refuse_a_frame_that_does_not_fit);
+  RUN_TEST(test_should_hold_the_largest_time);
+  RUN_TEST(test_should_reject_broken_chunks);
+  UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  app_main();
+}
@@ -352,6 +352,59 @@ void parser_does_not_clear_status_on_realtime_system_messages(void) {
   TEST_ASSERT_EQUAL(0, msgs.size());
 }
 
+void parser_feed_batch_should_match_feed(void) {
+  std::vector<uint8_t> input;
+  rng.fill_data_for_all_types(input);
+  // Realtime bytes between messages, and a sysex that ends the running status
+  input.insert(input.begin() + input.size() / 2, {0xF8, 0xFE});
+  input.insert(input.end(), {0xF0, 0x7D, 0x01, 0xF7, 0x40, 0x90, 60, 100});
+
+  Messages expected;
+  MidiParser parser([&](const MidiChannelMessage &m) { expected.push_back(m); });
+  parser.feed(input.data(), input.size());
+
+  BatchMidiParser batch;
+  Messages msgs(input.size());
+  size_t consumed = 0;
+  const size_t count = batch.feed_batch(input.data(), input.size(), msgs.data(), msgs.size(),
+                                        &consumed);
+  TEST_ASSERT_EQUAL(input.size(), consumed);
+  TEST_ASSERT_EQUAL(expected.size(), count);
+  for (size_t i = 0; i < count; i++)
+    assert_midi_message_equal(msgs[i], expected[i]);
+  TEST_ASSERT_TRUE(parser.status() == batch.status());
+}
+
+void parser_feed_batch_should_stop_when_full(void) {
+  const uint8_t input[] = {0x90, 60, 100, 62, 100, 64, 100, 0xC1, 5};
+  BatchMidiParser parser;
+  MidiChannelMessage msgs[2];
+  size_t consumed = 0;
+
+  TEST_ASSERT_EQUAL(2, parser.feed_batch(input, sizeof(input), msgs, 2, &consumed));
+  TEST_ASSERT_EQUAL(5, consumed);
+  assert_midi_message_equal(msgs[1], MidiChannelMessage::note_on(0, 62, 100));
+
+  // The rest picks up where it stopped, running status included
+  size_t rest = 0;
+  TEST_ASSERT_EQUAL(2, parser.feed_batch(input + consumed, sizeof(input) - consumed, msgs, 2,
+                                         &rest));
+  TEST_ASSERT_EQUAL(sizeof(input) - consumed, rest);
+  assert_midi_message_equal(msgs[0], MidiChannelMessage::note_on(0, 64, 100));
+  TEST_ASSERT_TRUE(MidiMessageType::ProgramChange == msgs[1].type);
+  TEST_ASSERT_EQUAL(5, msgs[1].data0);
+}
+
+void parser_feed_batch_should_carry_state_across_buffers(void) {
+  const uint8_t first[] = {0xE2, 0x00}, second[] = {0x40, 0x01};
+  BatchMidiParser parser;
+  MidiChannelMessage msgs[2];
+
+  TEST_ASSERT_EQUAL(0, parser.feed_batch(first, sizeof(first), msgs, 2));
+  TEST_ASSERT_EQUAL(1, parser.feed_batch(second, sizeof(second), msgs, 2));
+  assert_midi_message_equal(msgs[0], MidiChannelMessage::pitchbend(2, 0x2000));
+}
+
 extern "C" void app_main(void) {
   UNITY_BEGIN();
   RUN_TEST(parser_empty);
@@ -374,6 +427,10 @@ extern "C" void app_main(void) {
 
   RUN_TEST(parser_clears_status_on_non_realtime_system_messages);
   RUN_TEST(parser_does_not_clear_status_on_realtime_system_messages);
+
+  RUN_TEST(parser_feed_batch_should_match_feed);
+  RUN_TEST(parser_feed_batch_should_stop_when_full);
+  RUN_TEST(parser_feed_batch_should_carry_state_across_buffers);
   UNITY_END();
 }
 
@@ -0,0 +1,237 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "midi_core.hpp"
+#include "smf_reader.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unity.h>
+#include <vector>
+
+using namespace teslasynth::midi;
+
+using Bytes = std::vector<uint8_t>;
+using Events = std::vector<TimedChannelMessage>;
+
+static void append_be(Bytes &out, uint32_t value, size_t bytes) {
+  for (size_t i = bytes; i > 0; i--)
+    out.push_back(static_cast<uint8_t>(value >> (8 * (i - 1))));
+}
+
+static Bytes smf(uint16_t format, uint16_t division, const std::vector<Bytes> &tracks) {
+  Bytes out{'M', 'T', 'h', 'd'};
+  append_be(out, 6, 4);
+  append_be(out, format, 2);
+  append_be(out, static_cast<uint16_t>(tracks.size()), 2);
+  append_be(out, division, 2);
+  for (const auto &track : tracks) {
+    out.insert(out.end(), {'M', 'T', 'r', 'k'});
+    append_be(out, static_cast<uint32_t>(track.size()), 4);
+    out.insert(out.end(), track.begin(), track.end());
+  }
+  return out;
+}
+
+static const Bytes end_of_track{0x00, 0xFF, 0x2F, 0x00};
+
+static Bytes track(Bytes events) {
+  events.insert(events.end(), end_of_track.begin(), end_of_track.end());
+  return events;
+}
+
+static SmfError read(const Bytes &data, Events &events) {
+  return read_smf(data.data(), data.size(),
+                  [&events](const TimedChannelMessage &e) { events.push_back(e); });
+}
+
+static void assert_event(const TimedChannelMessage &expected, const TimedChannelMessage &actual) {
+  TEST_ASSERT_EQUAL_UINT64(expected.time_us, actual.time_us);
+  TEST_ASSERT_TRUE_MESSAGE(expected.message == actual.message,
+                           (std::string(actual.message) + " != " + std::string(expected.message))
+                               .c_str());
+}
+
+void test_should_read_single_track(void) {
+  // 480 ticks per beat at the default 120 BPM: one tick is 500000/480 us
+  const auto data = smf(0, 480,
+                        {track({
+                            0x00, 0x90, 60, 100,       // note on
+                            0x83, 0x60, 0x80, 60, 0,   // 480 ticks later, note off
+                            0x00, 0xC1, 5,             // program change
+                            0x81, 0x70, 0xE0, 0, 0x40, // 240 ticks later, pitch bend
+                        })});
+  Events events;
+  TEST_ASSERT_EQUAL(SmfError::None, read(data, events));
+  TEST_ASSERT_EQUAL(4, events.size());
+  assert_event({0, MidiChannelMessage::note_on(0, 60, 100)}, events[0]);
+  assert_event({500'000, MidiChannelMessage::note_off(0, 60, 0)}, events[1]);
+  assert_event({500'000, MidiChannelMessage::program_change(1, 5)}, events[2]);
+  assert_event({750'000, MidiChannelMessage::pitchbend(0, 8192)}, events[3]);
+}
+
+void test_should_handle_running_status(void) {
+  const auto data = smf(0, 96,
+                        {track({
+                            0x00, 0x91, 60, 100, // note on
+                            0x00, 64, 90,        // running status note on
+                            0x60, 60, 0,         // running status, velocity zero
+                        })});
+  Events events;
+  TEST_ASSERT_EQUAL(SmfError::None, read(data, events));
+  TEST_ASSERT_EQUAL(3, events.size());
+  assert_event({0, MidiChannelMessage::note_on(1, 60, 100)}, events[0]);
+  assert_event({0, MidiChannelMessage::note_on(1, 64, 90)}, events[1]);
+  assert_event({500'000, MidiChannelMessage::note_on(1, 60, 0)}, events[2]);
+}
+
+void test_meta_should_clear_running_status(void) {
+  const auto data = smf(0, 96,
+                        {track({
+                            0x00, 0x90, 60, 100,              // note on
+                            0x00, 0xFF, 0x01, 0x02, 'h', 'i', // text meta
+                            0x00, 62, 100,                    // no running status
+                        })});
+  Events events;
+  TEST_ASSERT_EQUAL(SmfError::BadEvent, read(data, events));
+  TEST_ASSERT_EQUAL(1, events.size());
+  assert_event({0, MidiChannelMessage::note_on(0, 60, 100)}, events[0]);
+}
+
+void test_sysex_should_clear_running_status(void) {
+  const auto data = smf(0, 96,
+                        {track({
+                            0x00, 0x90, 60, 100,                // note on
+                            0x00, 62, 100,                      // running status
+                            0x00, 0xF0, 0x03, 0x7E, 0x00, 0xF7, // sysex
+                            0x00, 64, 100,                      // no running status
+                        })});
+  Events events;
+  TEST_ASSERT_EQUAL(SmfError::BadEvent, read(data, events));
+  TEST_ASSERT_EQUAL(2, events.size());
+  assert_event({0, MidiChannelMessage::note_on(0, 62, 100)}, events[1]);
+}
+
+void test_tempo_changes_should_apply_per_segment(void) {
+  const auto data = smf(0, 3,
+                        {track({
+                            0x00, 0xFF, 0x51, 0x03, 0x0F, 0x42, 0x40, // 1 s per beat
+                            0x01, 0x90, 60, 100,                      // tick 1
+                            0x02, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20, // tick 3, 0.5 s per beat
+                            0x01, 0x80, 60, 0,                        // tick 4
+                        })});
+  Events events;
+  TEST_ASSERT_EQUAL(SmfError::None, read(data, events));
+  TEST_ASSERT_EQUAL(2, events.size());
+  // Integer division per segment: 1 * 1000000 / 3 and 3 * 1000000 / 3 + 1 * 500000 / 3
+  TEST_ASSERT_EQUAL_UINT64(333'333, events[0].time_us);
+  TEST_ASSERT_EQUAL_UINT64(1'166'666, events[1].time_us);
+}
+
+void test_should_merge_tracks_in_time_order(void) {
+  const auto data = smf(1, 480,
+                        {
+                            track({
+                                0x00, 0xFF, 0x51, 0x03, 0x03, 0xD0, 0x90,       // 250 ms per beat
+                                0x83, 0x60, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20, // tick 480, 500 ms
+                            }),
+                            track({
+                                0x00, 0x90, 60, 100, // tick 0
+                                0x87, 0x40, 62, 100, // tick 960
+                            }),
+                            track({
+                                0x00, 0x91, 48, 100,     // tick 0, after the first track
+                                0x83, 0x60, 0x81, 48, 0, // tick 480
+                            }),
+                        });
+  Events events;
+  TEST_ASSERT_EQUAL(SmfError::None, read(data, events));
+  TEST_ASSERT_EQUAL(4, events.size());
+  assert_event({0, MidiChannelMessage::note_on(0, 60, 100)}, events[0]);
+  assert_event({0, MidiChannelMessage::note_on(1, 48, 100)}, events[1]);
+  assert_event({250'000, MidiChannelMessage::note_off(1, 48, 0)}, events[2]);
+  assert_event({750'000, MidiChannelMessage::note_on(0, 62, 100)}, events[3]);
+}
+
+void test_should_read_smpte_division(void) {
+  // 25 fps, 40 ticks per frame: 1 ms per tick
+  const uint16_t division = static_cast<uint16_t>((-25 & 0xFF) << 8 | 40);
+  const auto data = smf(0, division,
+                        {track({
+                            0x00, 0xFF, 0x51, 0x03, 0x0F, 0x42, 0x40, // ignored
+                            0x0A, 0x90, 60, 100,
+                        })});
+  Events events;
+  TEST_ASSERT_EQUAL(SmfError::None, read(data, events));
+  TEST_ASSERT_EQUAL(1, events.size());
+  TEST_ASSERT_EQUAL_UINT64(10'000, events[0].time_us);
+}
+
+void test_should_stop_at_end_of_track(void) {
+  const auto data = smf(0, 96, {{0x00, 0x90, 60, 100, 0x00, 0xFF, 0x2F, 0x00, 0x00, 0x90}});
+  Events events;
+  TEST_ASSERT_EQUAL(SmfError::None, read(data, events));
+  TEST_ASSERT_EQUAL(1, events.size());
+}
+
+void test_should_reject_invalid_files(void) {
+  Events events;
+  const Bytes garbage{'R', 'I', 'F', 'F', 0, 0, 0, 0};
+  TEST_ASSERT_EQUAL(SmfError::NotMidiFile, read(garbage, events));
+  TEST_ASSERT_EQUAL(SmfError::NotMidiFile, read(smf(0, 0, {}), events));
+  TEST_ASSERT_EQUAL(SmfError::UnsupportedFormat, read(smf(2, 96, {}), events));
+
+  auto truncated = smf(0, 96, {track({0x00, 0x90, 60, 100})});
+  truncated.resize(truncated.size() - 2);
+  TEST_ASSERT_EQUAL(SmfError::Truncated, read(truncated, events));
+
+  const auto cut_event = smf(0, 96, {{0x00, 0x90, 60}});
+  TEST_ASSERT_EQUAL(SmfError::Truncated, read(cut_event, events));
+
+  const auto no_status = smf(0, 96, {{0x00, 60, 100}});
+  TEST_ASSERT_EQUAL(SmfError::BadEvent, read(no_status, events));
+  TEST_ASSERT_EQUAL(0, events.size());
+}
+
+void test_should_reject_truncated_headers(void) {
+  Events events;
+  const auto header = smf(0, 96, {});
+  for (size_t len = 4; len < header.size(); len++) {
+    const Bytes cut(header.begin(), header.begin() + len);
+    TEST_ASSERT_EQUAL(SmfError::Truncated, read(cut, events));
+  }
+
+  auto long_header = header;
+  long_header[7] = 8;
+  TEST_ASSERT_EQUAL(SmfError::Truncated, read(long_header, events));
+  long_header.insert(long_header.end(), {0, 0});
+  TEST_ASSERT_EQUAL(SmfError::None, read(long_header, events));
+  TEST_ASSERT_EQUAL(0, events.size());
+}
+
+void test_empty_file_should_have_no_events(void) {
+  Events events;
+  TEST_ASSERT_EQUAL(SmfError::None, read(smf(1, 96, {}), events));
+  TEST_ASSERT_EQUAL(SmfError::None, read(smf(1, 96, {end_of_track}), events));
+  TEST_ASSERT_EQUAL(0, events.size());
+}
+
+extern "C" void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_should_read_single_track);
+  RUN_TEST(test_should_handle_running_status);
+  RUN_TEST(test_meta_should_clear_running_status);
+  RUN_TEST(test_sysex_should_clear_running_status);
+  RUN_TEST(test_tempo_changes_should_apply_per_segment);
+  RUN_TEST(test_should_merge_tracks_in_time_order);
+  RUN_TEST(test_should_read_smpte_division);
+  RUN_TEST(test_should_stop_at_end_of_track);
+  RUN_TEST(test_should_reject_invalid_files);
+  RUN_TEST(test_should_reject_truncated_headers);
+  RUN_TEST(test_empty_file_should_have_no_events);
+  UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  app_main();
+}
@@ -0,0 +1,23 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#pragma once
+
+#include "core.hpp"
+#include "lfo.hpp"
+#include <algorithm>
+#include <cstdint>
+
+using namespace teslasynth::synth;
+
+/// Offset of a vibrato started at zero and left running until `now`
+inline Hertz vibrato_offset(const Vibrato &vibrato, const Duration &now) {
+  Lfo lfo;
+  lfo.start(vibrato);
+  for (uint64_t left = now.micros(); left > 0;) {
+    const uint32_t dt = static_cast<uint32_t>(std::min<uint64_t>(left, UINT32_MAX));
+    lfo.advance(Duration32::micros(dt));
+    left -= dt;
+  }
+  return lfo.offset();
+}
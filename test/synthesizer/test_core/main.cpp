@@ -7,6 +7,7 @@
 #include <cmath>
 #include <core.hpp>
 #include <cstdint>
+#include <type_traits>
 #include <unity.h>
 
 using namespace teslasynth::core;
@@ -153,9 +154,16 @@ void test_hertz_arithmetic(void) {
   assert_hertz_equal(100_hz - 2_hz, 98_hz);
 
   assert_hertz_equal(100_hz + 900_hz, 1_khz);
-  assert_hertz_equal(100_mhz + 900_mhz, 1000_mhz);
-
-  assert_hertz_equal(900_mhz - 100_mhz, 800_mhz);
+  if constexpr (std::is_floating_point_v<Arithmetic::Frequency>) {
+    assert_hertz_equal(100_mhz + 900_mhz, 1000_mhz);
+    assert_hertz_equal(900_mhz - 100_mhz, 800_mhz);
+  } else {
+    // Q23.8 ends at about 8.4 MHz, and conversions saturate there
+    assert_hertz_equal(1_mhz + 7_mhz, 8_mhz);
+    assert_hertz_equal(8_mhz - 1_mhz, 7_mhz);
+    TEST_ASSERT_EQUAL(INT32_MAX, (100_mhz).raw());
+    TEST_ASSERT_EQUAL(INT32_MIN, Hertz(-1e9f).raw());
+  }
   assert_hertz_equal(2_khz * 4, 8_khz);
 }
 
@@ -183,12 +191,18 @@ void test_level_comparison(void) {
   TEST_ASSERT_TRUE(EnvelopeLevel(100) == EnvelopeLevel(1.f));
 
   TEST_ASSERT_TRUE(EnvelopeLevel(0.800) != EnvelopeLevel(0.810));
-  TEST_ASSERT_TRUE(EnvelopeLevel(0.800) == EnvelopeLevel(0.801));
   TEST_ASSERT_TRUE(EnvelopeLevel(0.800) == EnvelopeLevel(0.8001));
-
   TEST_ASSERT_TRUE(EnvelopeLevel(0.63) != EnvelopeLevel(0.64));
   TEST_ASSERT_TRUE(EnvelopeLevel(0.63) != EnvelopeLevel(0.632));
-  TEST_ASSERT_TRUE(EnvelopeLevel(0.63) == EnvelopeLevel(0.631));
+
+  if constexpr (std::is_floating_point_v<Arithmetic::Level>) {
+    TEST_ASSERT_TRUE(EnvelopeLevel(0.800) == EnvelopeLevel(0.801));
+    TEST_ASSERT_TRUE(EnvelopeLevel(0.63) == EnvelopeLevel(0.631));
+  } else {
+    // Rounding to Q15 can move levels 0.001 apart just past the tolerance
+    TEST_ASSERT_TRUE(EnvelopeLevel(0.800) == EnvelopeLevel(0.8009));
+    TEST_ASSERT_TRUE(EnvelopeLevel(0.63) == EnvelopeLevel(0.6309));
+  }
 }
 void test_level_arithmetic(void) {
   assert_level_equal(EnvelopeLevel(0) + EnvelopeLevel(1), EnvelopeLevel(1));
@@ -248,12 +262,18 @@ void test_probability_comparison(void) {
   TEST_ASSERT_TRUE(Probability(100) == Probability(1.f));
 
   TEST_ASSERT_TRUE(Probability(0.800) != Probability(0.810));
-  TEST_ASSERT_TRUE(Probability(0.800) == Probability(0.801));
   TEST_ASSERT_TRUE(Probability(0.800) == Probability(0.8001));
-
   TEST_ASSERT_TRUE(Probability(0.63) != Probability(0.64));
   TEST_ASSERT_TRUE(Probability(0.63) != Probability(0.632));
-  TEST_ASSERT_TRUE(Probability(0.63) == Probability(0.631));
+
+  if constexpr (std::is_floating_point_v<Arithmetic::Level>) {
+    TEST_ASSERT_TRUE(Probability(0.800) == Probability(0.801));
+    TEST_ASSERT_TRUE(Probability(0.63) == Probability(0.631));
+  } else {
+    // Rounding to Q15 can move probabilities 0.001 apart just past the tolerance
+    TEST_ASSERT_TRUE(Probability(0.800) == Probability(0.8009));
+    TEST_ASSERT_TRUE(Probability(0.63) == Probability(0.6309));
+  }
 }
 void test_probability_arithmetic(void) {
   assert_probability_equal(Probability(0) + Probability(1), Probability(1));
@@ -4,6 +4,7 @@
 #include "core/duration.hpp"
 #include "synthesizer/helpers/assertions.hpp"
 #include "unity_internals.h"
+#include <algorithm>
 #include <cmath>
 #include <envelope.hpp>
 #include <unity.h>
@@ -138,6 +139,50 @@ void test_curve_constant_zero(void) {
   assert_level_equal(curve.update(0_us), EnvelopeLevel(0));
 }
 
+void test_exp_decay_should_match_expf(void) {
+  for (uint64_t x = 0; x < (8ull << 32); x += 0x1234567) {
+    const double expected = exp(-static_cast<double>(x) / (1ull << 32));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, expected, exp_decay(x) / static_cast<double>(1 << 30));
+  }
+  TEST_ASSERT_EQUAL_UINT32(1 << 30, exp_decay(0));
+  TEST_ASSERT_EQUAL_UINT32(0, exp_decay(8ull << 32));
+}
+
+// The closed form the table replaces: level += (target - level) * (1 - exp(-dt / tau))
+static void assert_exp_curve_tracks_expf(float start, float target, uint32_t total,
+                                         const uint32_t *steps, size_t n) {
+  Curve curve(EnvelopeLevel(start), EnvelopeLevel(target), Duration32::micros(total),
+              CurveType::Exp);
+  const float tau = total / 6.907755278982137f;
+  float expected = start;
+  uint32_t elapsed = 0;
+  // Fixed levels stop moving once a step is under half an LSB, as the expf form did
+  float stall = 0;
+  if (std::is_same_v<Arithmetic, FixedArithmetic>) {
+    const float shortest = *std::min_element(steps, steps + n);
+    stall = 0.5f / FixedArithmetic::level_one / (1 - expf(-shortest / tau));
+  }
+  for (size_t i = 0; elapsed < total; i = (i + 1) % n) {
+    const uint32_t dt = steps[i];
+    elapsed += dt;
+    expected = elapsed >= total ? target : expected + (target - expected) * (1 - expf(-(dt / tau)));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f + stall, expected, float(curve.update(Duration32::micros(dt))));
+  }
+  TEST_ASSERT_TRUE(curve.is_target_reached());
+}
+
+void test_curve_exp_should_track_expf(void) {
+  const uint32_t periods[] = {2273, 2273, 2273, 1516};
+  const uint32_t fast[] = {250, 251, 249};
+  const uint32_t mixed[] = {37, 5000, 120, 913, 1};
+  assert_exp_curve_tracks_expf(0, 1, 500'000, periods, 4);
+  assert_exp_curve_tracks_expf(1, 0.3f, 2'000'000, periods, 4);
+  assert_exp_curve_tracks_expf(0, 1, 5'000, fast, 3);
+  assert_exp_curve_tracks_expf(0.8f, 0, 100'000, fast, 3);
+  assert_exp_curve_tracks_expf(0, 1, 60'000'000, periods, 4);
+  assert_exp_curve_tracks_expf(0.2f, 0.9f, 300'000, mixed, 5);
+}
+
 extern "C" void app_main(void) {
   UNITY_BEGIN();
   RUN_TEST(test_curve_lin_positive);
@@ -148,6 +193,8 @@ extern "C" void app_main(void) {
   RUN_TEST(test_curve_lin_negative_small);
   RUN_TEST(test_curve_exp_positive);
   RUN_TEST(test_curve_exp_negative);
+  RUN_TEST(test_exp_decay_should_match_expf);
+  RUN_TEST(test_curve_exp_should_track_expf);
   RUN_TEST(test_curve_must_be_only_time_dependent_after_creation);
   RUN_TEST(test_curve_constant);
   RUN_TEST(test_curve_constant_zero);
@@ -8,6 +8,7 @@
 #include <cstdint>
 #include <cstdio>
 #include <unity.h>
+#include <vector>
 
 using namespace teslasynth::synth;
 
@@ -125,6 +126,32 @@ void test_pitched_period_bounds_low_prf(void) {
   TEST_ASSERT_GREATER_THAN(10, count);
 }
 
+static std::vector<Duration32> periods(uint8_t number, Duration time,
+                                       HitSeed mode = HitSeed::NoteAndTime) {
+  Percussion params{.burst = 100_ms, .prf = 1_khz, .noise = Probability(1)};
+  Hit hit;
+  hit.start(number, EnvelopeLevel::max(), time, params, nullptr, mode);
+  std::vector<Duration32> res;
+  do
+    res.push_back(hit.current().period);
+  while (hit.next());
+  return res;
+}
+
+void test_should_repeat_the_same_hit(void) {
+  const auto first = periods(36, 1_s);
+  TEST_ASSERT_GREATER_THAN(10, first.size());
+  TEST_ASSERT_TRUE(first == periods(36, 1_s));
+  TEST_ASSERT_FALSE(first == periods(38, 1_s));
+  TEST_ASSERT_FALSE(first == periods(36, 2_s));
+}
+
+void test_fresh_hits_should_start_from_the_same_seed_by_default(void) {
+  const auto first = periods(36, 1_s, HitSeed::Carried);
+  TEST_ASSERT_TRUE(first == periods(38, 2_s, HitSeed::Carried));
+  TEST_ASSERT_FALSE(first == periods(36, 1_s));
+}
+
 extern "C" void app_main(void) {
   UNITY_BEGIN();
   RUN_TEST(test_empty);
@@ -133,6 +160,8 @@ extern "C" void app_main(void) {
   RUN_TEST(test_generate_bursts_random);
   RUN_TEST(test_pitched_period_bounds_high_prf);
   RUN_TEST(test_pitched_period_bounds_low_prf);
+  RUN_TEST(test_should_repeat_the_same_hit);
+  RUN_TEST(test_fresh_hits_should_start_from_the_same_seed_by_default);
   UNITY_END();
 }
 
@@ -4,6 +4,9 @@
 #include "core.hpp"
 #include "lfo.hpp"
 #include "synthesizer/helpers/assertions.hpp"
+#include "synthesizer/helpers/vibrato.hpp"
+#include <cmath>
+#include <cstdint>
 #include <unity.h>
 
 using namespace teslasynth::synth;
@@ -11,10 +14,10 @@ using namespace teslasynth::synth;
 void test_flat(void) {
   Vibrato lfo;
 
-  assert_hertz_equal(lfo.offset(0_us), 0_hz);
-  assert_hertz_equal(lfo.offset(1_ms), 0_hz);
-  assert_hertz_equal(lfo.offset(3_ms), 0_hz);
-  assert_hertz_equal(lfo.offset(1_s), 0_hz);
+  assert_hertz_equal(vibrato_offset(lfo, 0_us), 0_hz);
+  assert_hertz_equal(vibrato_offset(lfo, 1_ms), 0_hz);
+  assert_hertz_equal(vibrato_offset(lfo, 3_ms), 0_hz);
+  assert_hertz_equal(vibrato_offset(lfo, 1_s), 0_hz);
 }
 
 void test_oscillation1(void) {
@@ -22,22 +25,22 @@ void test_oscillation1(void) {
 
   for (int i = 0; i < 100; i++) {
     auto start = Duration::seconds(i);
-    assert_hertz_equal(lfo.offset(start + 0_us), 0_hz);
-    assert_hertz_equal(lfo.offset(start + 250_ms), 2_hz);
-    assert_hertz_equal(lfo.offset(start + 500_ms), 0_hz);
-    assert_hertz_equal(lfo.offset(start + 750_ms), -2_hz);
-    assert_hertz_equal(lfo.offset(start + 1_s), 0_hz);
+    assert_hertz_equal(vibrato_offset(lfo, start + 0_us), 0_hz);
+    assert_hertz_equal(vibrato_offset(lfo, start + 250_ms), 2_hz);
+    assert_hertz_equal(vibrato_offset(lfo, start + 500_ms), 0_hz);
+    assert_hertz_equal(vibrato_offset(lfo, start + 750_ms), -2_hz);
+    assert_hertz_equal(vibrato_offset(lfo, start + 1_s), 0_hz);
   }
 }
 
 void test_oscillation2(void) {
   Vibrato lfo{2_hz, 10_hz};
 
-  assert_hertz_equal(lfo.offset(0_us), 0_hz);
-  assert_hertz_equal(lfo.offset(125_ms), 10_hz);
-  assert_hertz_equal(lfo.offset(250_ms), 0_hz);
-  assert_hertz_equal(lfo.offset(375_ms), -10_hz);
-  assert_hertz_equal(lfo.offset(500_ms), 0_hz);
+  assert_hertz_equal(vibrato_offset(lfo, 0_us), 0_hz);
+  assert_hertz_equal(vibrato_offset(lfo, 125_ms), 10_hz);
+  assert_hertz_equal(vibrato_offset(lfo, 250_ms), 0_hz);
+  assert_hertz_equal(vibrato_offset(lfo, 375_ms), -10_hz);
+  assert_hertz_equal(vibrato_offset(lfo, 500_ms), 0_hz);
 }
 
 void test_comparision(void) {
@@ -53,6 +56,81 @@ void test_comparision(void) {
 
   TEST_ASSERT_FALSE(lfo2 == lfo3);
   TEST_ASSERT_TRUE(lfo2 != lfo3);
+
+  Vibrato square{2_hz, 10_hz, LfoShape::Square};
+  TEST_ASSERT_TRUE(lfo1 != square);
+  TEST_ASSERT_FALSE(lfo1 == square);
+}
+
+void test_wave_shapes(void) {
+  for (uint64_t phase = 0; phase < (1ull << 32); phase += 0x1234567) {
+    const double expected = 32767 * sin(2 * M_PI * phase / (1ull << 32));
+    TEST_ASSERT_INT32_WITHIN(4, static_cast<int32_t>(lround(expected)),
+                             lfo_wave(LfoShape::Sine, static_cast<uint32_t>(phase)));
+  }
+
+  const uint32_t quarter = 1u << 30;
+  const int32_t points[][4] = {
+      {0, 32767, 0, -32767},          // Triangle
+      {32767, 32767, -32767, -32767}, // Square
+      {0, 16384, -32767, -16384},     // SawUp
+      {0, -16384, 32767, 16384},      // SawDown
+  };
+  const LfoShape shapes[] = {LfoShape::Triangle, LfoShape::Square, LfoShape::SawUp,
+                             LfoShape::SawDown};
+  for (int s = 0; s < 4; s++)
+    for (uint32_t q = 0; q < 4; q++)
+      TEST_ASSERT_INT32_WITHIN(1, points[s][q], lfo_wave(shapes[s], q * quarter));
+  TEST_ASSERT_INT32_WITHIN(1, 16384, lfo_wave(LfoShape::Triangle, quarter / 2));
+  TEST_ASSERT_INT32_WITHIN(1, -16384, lfo_wave(LfoShape::Triangle, 5 * (quarter / 2)));
+}
+
+void test_lfo_should_start_at_zero_phase(void) {
+  Lfo lfo;
+  assert_hertz_equal(lfo.offset(), 0_hz);
+
+  lfo.start({2_hz, 10_hz});
+  assert_hertz_equal(lfo.offset(), 0_hz);
+  lfo.advance(125_ms);
+  assert_hertz_equal(lfo.offset(), 10_hz);
+  lfo.advance(250_ms);
+  assert_hertz_equal(lfo.offset(), -10_hz);
+
+  lfo.start({2_hz, 10_hz});
+  assert_hertz_equal(lfo.offset(), 0_hz);
+  lfo.start(Vibrato::none());
+  lfo.advance(125_ms);
+  assert_hertz_equal(lfo.offset(), 0_hz);
+}
+
+void test_lfo_should_follow_pulse_periods(void) {
+  Lfo lfo;
+  lfo.start({5_hz, 1.5_hz});
+  const uint32_t periods[] = {2273, 2272, 1911, 5000, 333};
+  // Q23.8 frequencies resolve 1/256 Hz
+  const float tolerance = std::is_same_v<Arithmetic, FixedArithmetic> ? 1.f / 256 : 1e-3f;
+  uint64_t t = 0;
+  for (int i = 0; i < 20000; i++) {
+    const double expected = 1.5 * sin(2 * M_PI * 5 * (t / 1e6));
+    TEST_ASSERT_FLOAT_WITHIN(tolerance, expected, float(lfo.offset()));
+    lfo.advance(Duration32::micros(periods[i % 5]));
+    t += periods[i % 5];
+  }
+}
+
+void test_lfo_should_not_drift_on_long_tracks(void) {
+  Lfo lfo;
+  lfo.start({1_hz, 2_hz});
+  // Ten hours of 2 ms pulses, then a quarter cycle
+  for (int i = 0; i < 18'000'000; i++)
+    lfo.advance(2_ms);
+  assert_hertz_equal(lfo.offset(), 0_hz);
+  lfo.advance(250_ms);
+  assert_hertz_equal(lfo.offset(), 2_hz);
+
+  const Vibrato vibrato{1_hz, 2_hz};
+  assert_hertz_equal(vibrato_offset(vibrato, Duration::seconds(36'000) + 250_ms), 2_hz);
+  assert_hertz_equal(vibrato_offset(vibrato, Duration::seconds(360'000) + 750_ms), -2_hz);
 }
 
 extern "C" void app_main(void) {
@@ -61,6 +139,10 @@ extern "C" void app_main(void) {
   RUN_TEST(test_oscillation1);
   RUN_TEST(test_oscillation2);
   RUN_TEST(test_comparision);
+  RUN_TEST(test_wave_shapes);
+  RUN_TEST(test_lfo_should_start_at_zero_phase);
+  RUN_TEST(test_lfo_should_follow_pulse_periods);
+  RUN_TEST(test_lfo_should_not_drift_on_long_tracks);
   UNITY_END();
 }
 
@@ -11,6 +11,7 @@
 #include "lfo.hpp"
 #include "pitchbend.hpp"
 #include "synthesizer/helpers/assertions.hpp"
+#include "synthesizer/helpers/vibrato.hpp"
 #include "voices/note.hpp"
 #include <cstdint>
 #include <sys/types.h>
@@ -115,6 +116,16 @@ void test_note_release(void) {
   assert_duration_equal(note.current().period, 10_ms);
 }
 
+void test_note_release_should_keep_the_earlier_time(void) {
+  note.release(30000_us);
+  note.release(50000_us);
+
+  TEST_ASSERT_TRUE(note.next());
+  TEST_ASSERT_TRUE(note.next());
+  TEST_ASSERT_FALSE(note.next());
+  assert_duration_equal(note.now(), 30100_us);
+}
+
 void test_note_release_with_zero_velocity(void) {
   note.start(mnote1, EnvelopeLevel::zero(), 30000_us, envelope, tuning);
 
@@ -340,7 +351,7 @@ void test_note_vibrato(void) {
   assert_duration_equal(note.now(), 10_ms);
   for (int i = 0; i < 5000; i++) {
     auto start = note.current().start;
-    auto freq = 100_hz + vib.offset(start);
+    auto freq = 100_hz + vibrato_offset(vib, start);
     assert_level_equal(note.current().volume, EnvelopeLevel::max());
     assert_duration_equal(note.current().period, freq.period());
 
@@ -353,6 +364,22 @@ void test_off(void) {
   TEST_ASSERT_FALSE(note.is_active());
 }
 
+void test_off_at_a_time(void) {
+  note.off(20000_us);
+  TEST_ASSERT_TRUE(note.is_active());
+  TEST_ASSERT_TRUE(note.next());
+  assert_duration_equal(note.current().start, 10100_us);
+  TEST_ASSERT_FALSE(note.next());
+  TEST_ASSERT_FALSE(note.is_active());
+}
+
+void test_off_at_a_time_should_silence_the_pulse_lined_up(void) {
+  note.off(100_us);
+  assert_duration_equal(note.current().start, 100_us);
+  TEST_ASSERT_TRUE(note.current().volume.is_zero());
+  TEST_ASSERT_FALSE(note.next());
+}
+
 void test_sub_audible_frequency_rejected(void) {
   Note n;
   n.start(Hertz(10.0f), amplitude, 0_us, Envelope(amplitude), Vibrato::none());
@@ -393,7 +420,8 @@ void test_note_pitchbend(void) {
     assert_duration_equal(note.current().period, period);
 
     note.next();
-    freq = lerp(freq, state.pitch_bend * base_freq, 0.1);
+    freq = Hertz::from_raw(Arithmetic::frequency_lerp(
+        freq.raw(), (state.pitch_bend * base_freq).raw(), state.smoothing));
   }
 }
 
@@ -405,6 +433,7 @@ extern "C" void app_main(void) {
   RUN_TEST(test_started_note_initial_time);
   RUN_TEST(test_note_next);
   RUN_TEST(test_note_release);
+  RUN_TEST(test_note_release_should_keep_the_earlier_time);
   RUN_TEST(test_note_release_with_zero_velocity);
   RUN_TEST(test_note_second_start);
   RUN_TEST(test_note_start_after_release);
@@ -415,6 +444,8 @@ extern "C" void app_main(void) {
   RUN_TEST(test_note_envelope_constant);
   RUN_TEST(test_note_vibrato);
   RUN_TEST(test_off);
+  RUN_TEST(test_off_at_a_time);
+  RUN_TEST(test_off_at_a_time_should_silence_the_pulse_lined_up);
   RUN_TEST(test_note_pitchbend);
   RUN_TEST(test_sub_audible_frequency_rejected);
   RUN_TEST(test_over_limit_frequency_rejected);
@@ -0,0 +1,118 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "core.hpp"
+#include "core/numeric.hpp"
+#include "synthesizer/helpers/assertions.hpp"
+#include <cmath>
+#include <cstdint>
+#include <unity.h>
+
+using namespace teslasynth::core;
+
+using FixedLevel = BasicEnvelopeLevel<FixedArithmetic>;
+using FixedHertz = BasicHertz<FixedArithmetic>;
+using FixedProbability = BasicProbability<FixedArithmetic>;
+using FloatLevel = BasicEnvelopeLevel<FloatArithmetic>;
+using FloatHertz = BasicHertz<FloatArithmetic>;
+
+constexpr float level_lsb = 1.f / FixedArithmetic::level_one;
+
+void test_fixed_level_representation(void) {
+  TEST_ASSERT_EQUAL_INT32(0, FixedLevel::zero().raw());
+  TEST_ASSERT_EQUAL_INT32(1 << 15, FixedLevel::max().raw());
+  TEST_ASSERT_EQUAL_INT32(1 << 14, FixedLevel(0.5f).raw());
+  TEST_ASSERT_EQUAL_INT32(1 << 15, FixedLevel(3.f).raw());
+  TEST_ASSERT_EQUAL_INT32(0, FixedLevel(-3.f).raw());
+  TEST_ASSERT_EQUAL_INT32(1 << 15, FixedLevel::from_raw(1 << 16).raw());
+  TEST_ASSERT_EQUAL_INT32(0, FixedLevel::from_raw(-5).raw());
+
+  for (int i = 0; i <= 1000; i++) {
+    const float v = i / 1000.f;
+    TEST_ASSERT_FLOAT_WITHIN(level_lsb / 2, v, float(FixedLevel(v)));
+  }
+}
+
+void test_fixed_level_arithmetic(void) {
+  TEST_ASSERT_EQUAL_INT32(1 << 13, (FixedLevel(0.5f) * FixedLevel(0.5f)).raw());
+  TEST_ASSERT_EQUAL_INT32(1 << 15, (FixedLevel::max() * FixedLevel::max()).raw());
+  TEST_ASSERT_EQUAL_INT32(0, (FixedLevel::zero() * FixedLevel::max()).raw());
+  TEST_ASSERT_EQUAL_INT32(1 << 15, (FixedLevel(0.7f) + FixedLevel(0.7f)).raw());
+  TEST_ASSERT_EQUAL_INT32(1 << 15, (FixedLevel(0.7f) += FixedLevel(0.7f)).raw());
+  TEST_ASSERT_EQUAL_INT32(0, (FixedLevel(0.2f) += -0.5f).raw());
+  TEST_ASSERT_FLOAT_WITHIN(level_lsb, 0.6f, FixedLevel(1) - FixedLevel(0.4f));
+
+  for (int a = 0; a <= 100; a += 7)
+    for (int b = 0; b <= 100; b += 3) {
+      const float fa = a / 100.f, fb = b / 100.f;
+      TEST_ASSERT_FLOAT_WITHIN(2 * level_lsb, float(FloatLevel(fa) * FloatLevel(fb)),
+                               float(FixedLevel(fa) * FixedLevel(fb)));
+    }
+}
+
+void test_fixed_level_scales_durations(void) {
+  assert_duration_equal(FixedLevel(0.5f) * 10_ms, 5_ms);
+  assert_duration_equal(FixedLevel::max() * Duration32::micros(4000), Duration32::micros(4000));
+  assert_duration_equal(FixedLevel::zero() * 10_ms, Duration::zero());
+  assert_duration_equal(FixedLevel(0.25f) * Duration16::micros(1000), Duration16::micros(250));
+}
+
+void test_fixed_probability(void) {
+  TEST_ASSERT_EQUAL_INT32(1 << 15, FixedProbability::max().raw());
+  TEST_ASSERT_EQUAL_INT32(1 << 14, FixedProbability(0.5f).raw());
+  TEST_ASSERT_TRUE(FixedProbability(0.3f) < FixedProbability(0.31f));
+  TEST_ASSERT_EQUAL_INT32(1 << 13, (FixedProbability(0.5f) * FixedProbability(0.5f)).raw());
+  TEST_ASSERT_EQUAL_INT32(1 << 15, (FixedProbability(0.9f) + FixedProbability(0.2f)).raw());
+}
+
+void test_fixed_hertz_representation(void) {
+  TEST_ASSERT_EQUAL_INT32(440 << 8, FixedHertz(440).raw());
+  TEST_ASSERT_EQUAL_INT32(128, FixedHertz(0.5f).raw());
+  TEST_ASSERT_EQUAL_INT32(2'000'000 << 8, FixedHertz::megahertz(2).raw());
+  TEST_ASSERT_EQUAL_INT32(-(2 << 8), (-FixedHertz(2)).raw());
+  TEST_ASSERT_EQUAL_INT32(8000 << 8, (FixedHertz::kilohertz(2) * 4).raw());
+  TEST_ASSERT_EQUAL_INT32(3 << 8, (FixedHertz(1.5f) * 2).raw());
+  TEST_ASSERT_EQUAL_INT32(512, (FixedHertz(2) * 0.99999f).raw());
+  TEST_ASSERT_TRUE(FixedHertz(100) + FixedHertz(900) == FixedHertz::kilohertz(1));
+}
+
+void test_fixed_period_should_match_float(void) {
+  assert_duration_equal(FixedHertz(100).period(), 10_ms);
+  assert_duration_equal(FixedHertz(1).period(), 1_s);
+  assert_duration_equal(FixedHertz(0).period(), Duration32::max());
+  assert_duration_equal(FixedHertz(-5).period(), Duration32::max());
+
+  // Q23.8 rounds the input by at most 1/512 Hz, which moves a period p by p^2 / 512e6 us
+  for (int midi = 0; midi < 128; midi++) {
+    const float hz = 440.f * exp2f((midi - 69) / 12.f);
+    const uint64_t fixed = FixedHertz(hz).period().micros();
+    const uint64_t flt = FloatHertz(hz).period().micros();
+    TEST_ASSERT_UINT32_WITHIN(1 + flt * flt / 512'000'000, flt, fixed);
+  }
+}
+
+void test_default_arithmetic_is_selected_by_config(void) {
+#ifdef CONFIG_TESLASYNTH_FIXED_POINT
+  TEST_ASSERT_TRUE((std::is_same_v<EnvelopeLevel, FixedLevel>));
+  TEST_ASSERT_TRUE((std::is_same_v<Hertz, FixedHertz>));
+#else
+  TEST_ASSERT_TRUE((std::is_same_v<EnvelopeLevel, FloatLevel>));
+  TEST_ASSERT_TRUE((std::is_same_v<Hertz, FloatHertz>));
+#endif
+}
+
+extern "C" void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_fixed_level_representation);
+  RUN_TEST(test_fixed_level_arithmetic);
+  RUN_TEST(test_fixed_level_scales_durations);
+  RUN_TEST(test_fixed_probability);
+  RUN_TEST(test_fixed_hertz_representation);
+  RUN_TEST(test_fixed_period_should_match_float);
+  RUN_TEST(test_default_arithmetic_is_selected_by_config);
+  UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  app_main();
+}
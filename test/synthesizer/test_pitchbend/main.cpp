@@ -20,6 +20,15 @@ void test_bend(void) {
   assert_hertz_equal(pb_down * 100_hz, 100_hz * exp2f(-2 / 12.f));
 }
 
+void test_multiplier_is_computed_once_per_message(void) {
+  for (uint16_t v = 0; v < 16384; v += 127) {
+    const PitchBend pb = PitchBend::midi(v);
+    const float semitones = (float(v) - 8192.0f) / 8192.0f * 2;
+    TEST_ASSERT_EQUAL_FLOAT(exp2f(semitones / 12.0f), pb.multiplier());
+  }
+  TEST_ASSERT_EQUAL_FLOAT(1.f, PitchBend::midi(8192).multiplier());
+}
+
 void test_comparision(void) {
   PitchBend pb1(1), pb2(2), pb3(0), pb4(-1), pb5(-2), pbd;
 
@@ -41,6 +50,7 @@ extern "C" void app_main(void) {
   RUN_TEST(test_flat);
   RUN_TEST(test_bend);
   RUN_TEST(test_comparision);
+  RUN_TEST(test_multiplier_is_computed_once_per_message);
   UNITY_END();
 }
 
@@ -0,0 +1,80 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "core.hpp"
+#include "synthesizer/helpers/assertions.hpp"
+#include "tuning.hpp"
+#include "voices/note.hpp"
+#include <cmath>
+#include <cstdint>
+#include <unity.h>
+
+using namespace teslasynth::synth;
+
+void test_semitone_ratios(void) {
+  for (int n = 0; n < 128; n++) {
+    const float expected = exp2f((n - 69) / 12.0f);
+    TEST_ASSERT_FLOAT_WITHIN(expected * 1e-6f, expected, semitone_ratio(n));
+  }
+  TEST_ASSERT_EQUAL_FLOAT(1.f, semitone_ratio(69));
+  TEST_ASSERT_EQUAL_FLOAT(2.f, semitone_ratio(81));
+  TEST_ASSERT_EQUAL_FLOAT(semitone_ratio(127), semitone_ratio(200));
+}
+
+void test_table_should_match_note_frequencies(void) {
+  TuningTable table;
+  assert_hertz_equal(table.tuning(), 440_hz);
+  for (uint8_t n = 0; n < 128; n++) {
+    assert_hertz_equal(table.frequency(n), Note::frequency_for(n));
+    assert_duration_equal(table.period(n), Note::frequency_for(n).period());
+  }
+  assert_hertz_equal(table.frequency(69), 440_hz);
+  assert_duration_equal(table.period(57), Duration32::micros(4545));
+}
+
+void test_table_should_retune(void) {
+  TuningTable table(100_hz);
+  assert_hertz_equal(table.frequency(69), 100_hz);
+  assert_duration_equal(table.period(69), 10_ms);
+  assert_hertz_equal(table.frequency(81), 200_hz);
+
+  table.retune(200_hz);
+  assert_hertz_equal(table.tuning(), 200_hz);
+  assert_hertz_equal(table.frequency(69), 200_hz);
+  assert_duration_equal(table.period(69), 5_ms);
+  assert_hertz_equal(table.frequency(57), 100_hz);
+}
+
+void test_velocity_levels(void) {
+  for (int v = 0; v < 128; v++)
+    assert_level_equal(velocity_level(v), EnvelopeLevel::logscale(v * 2 + 1));
+  assert_level_equal(velocity_level(127), EnvelopeLevel::max());
+  assert_level_equal(velocity_level(255), velocity_level(127));
+}
+
+void test_note_should_start_from_table(void) {
+  TuningTable table(100_hz);
+  const Instrument instrument{.envelope = EnvelopeLevel(1), .vibrato = Vibrato::none()};
+  Note note;
+  note.start(81, EnvelopeLevel(1), 0_us, instrument, table);
+  TEST_ASSERT_TRUE(note.is_active());
+  assert_hertz_equal(note.frequency(), 200_hz);
+  assert_duration_equal(note.current().period, 5_ms);
+  note.next();
+  assert_duration_equal(note.current().start, 5_ms);
+  assert_duration_equal(note.current().period, 5_ms);
+}
+
+extern "C" void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_semitone_ratios);
+  RUN_TEST(test_table_should_match_note_frequencies);
+  RUN_TEST(test_table_should_retune);
+  RUN_TEST(test_velocity_levels);
+  RUN_TEST(test_note_should_start_from_table);
+  UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  app_main();
+}
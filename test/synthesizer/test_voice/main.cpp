@@ -45,6 +45,7 @@ public:
     pulse.start = time;
     pulse.volume = amplitude;
     active = true;
+    is_released_ = false;
     _channel = channel;
   }
   void release(Duration time) {
@@ -63,6 +64,7 @@ public:
   const NotePulse &current() const { return pulse; }
   bool is_active() const { return active; }
   bool is_released() const { return is_released_; }
+  const ChannelState *channel() const { return _channel; }
 
   void assert_started(uint8_t number, EnvelopeLevel amplitude, Duration time,
                       const SoundPreset &preset) {
@@ -84,7 +86,8 @@ public:
   }
 };
 
-typedef Voice<4, FakeEvent> TestVoice;
+using ScanVoice = Voice<4, FakeEvent, ScanScheduler>;
+using HeapVoice = Voice<4, FakeEvent, HeapScheduler>;
 
 void test_empty(void) {
   Voice<> voice;
@@ -95,6 +98,7 @@ void test_empty(void) {
   TEST_ASSERT_FALSE(evt.next());
 }
 
+template <class TestVoice>
 void assert_note(TestVoice &voice, const uint8_t number, const Duration &time) {
   EnvelopeLevel amp = EnvelopeLevel::max();
   auto &evt = voice.start(number, amp, time, preset);
@@ -103,7 +107,7 @@ void assert_note(TestVoice &voice, const uint8_t number, const Duration &time) {
   evt.assert_started(number, amp, time, preset);
 }
 
-void test_start(void) {
+template <class TestVoice> void test_start(void) {
   TestVoice voice;
   for (size_t i = 0; i < voice.max_size(); i++) {
     auto mnote = mnotef(i);
@@ -113,7 +117,7 @@ void test_start(void) {
   }
 }
 
-void test_should_limit_concurrent_voice(void) {
+template <class TestVoice> void test_should_limit_concurrent_voice(void) {
   for (size_t max = 1; max < 5; max++) {
     TestVoice voice(max);
     for (uint8_t i = 0; i < max; i++) {
@@ -128,7 +132,7 @@ void test_should_limit_concurrent_voice(void) {
   }
 }
 
-void test_should_steal_voices_that_are_the_most_quiet(void) {
+template <class TestVoice> void test_should_steal_voices_that_are_the_most_quiet(void) {
   FakeEvent *events[4];
   TestVoice voice(4);
   for (int i = 0; i < 4; i++) {
@@ -139,7 +143,7 @@ void test_should_steal_voices_that_are_the_most_quiet(void) {
   TEST_ASSERT_EQUAL(&stolen, events[3]);
 }
 
-void test_should_steal_voices_that_are_the_most_quiet2(void) {
+template <class TestVoice> void test_should_steal_voices_that_are_the_most_quiet2(void) {
   FakeEvent *events[4];
   TestVoice voice(4);
   for (int i = 0; i < 4; i++) {
@@ -150,7 +154,7 @@ void test_should_steal_voices_that_are_the_most_quiet2(void) {
   TEST_ASSERT_EQUAL(&stolen, events[0]);
 }
 
-void test_should_restart_the_same_note(void) {
+template <class TestVoice> void test_should_restart_the_same_note(void) {
   TestVoice voice(2);
   assert_note(voice, mnotef(0), 200_us);
   assert_note(voice, mnotef(0), 100_us);
@@ -159,7 +163,7 @@ void test_should_restart_the_same_note(void) {
   assert_duration_equal(note.current().start, 100_us);
 }
 
-void test_should_return_the_note_with_least_time(void) {
+template <class TestVoice> void test_should_return_the_note_with_least_time(void) {
   TestVoice voice;
   assert_note(voice, mnotef(1), 200_us);
   assert_note(voice, mnotef(2), 50_us);
@@ -169,7 +173,7 @@ void test_should_return_the_note_with_least_time(void) {
   assert_duration_equal(evt.current().start, 50_us);
 }
 
-void test_should_return_the_note_with_least_time_after_tick(void) {
+template <class TestVoice> void test_should_return_the_note_with_least_time_after_tick(void) {
   TestVoice voice(4);
   assert_note(voice, mnotef(1), 200_us);
   assert_note(voice, mnotef(2), 50_us);
@@ -190,7 +194,7 @@ void test_should_return_the_note_with_least_time_after_tick(void) {
   note3.assert_started(mnotef(1), EnvelopeLevel::max(), 200_us, preset);
 }
 
-void test_should_release_note(void) {
+template <class TestVoice> void test_should_release_note(void) {
   TestVoice voice;
   auto mnote = mnotef(1);
   assert_note(voice, mnote, 200_ms);
@@ -201,7 +205,7 @@ void test_should_release_note(void) {
   note.assert_released(3000_ms);
 }
 
-void test_should_not_release_other_voice(void) {
+template <class TestVoice> void test_should_not_release_other_voice(void) {
   TestVoice voice;
   assert_note(voice, mnotef(0), 100_ms);
   assert_note(voice, mnotef(1), 200_ms);
@@ -211,7 +215,29 @@ void test_should_not_release_other_voice(void) {
   TEST_ASSERT_FALSE(note.is_released());
 }
 
-void test_should_allow_the_minimum_size_of_one(void) {
+template <class TestVoice> void test_should_release_all_notes(void) {
+  TestVoice voice;
+  assert_note(voice, mnotef(0), 100_ms);
+  assert_note(voice, mnotef(1), 200_ms);
+  voice.release_all(3000_ms, nullptr);
+  voice.next().assert_released(3000_ms);
+
+  // Started after, so left alone
+  auto &note = voice.start(mnotef(2), EnvelopeLevel::max(), 3500_ms, preset);
+  TEST_ASSERT_FALSE(note.is_released());
+}
+
+template <class TestVoice> void test_should_release_all_notes_of_a_channel_only(void) {
+  TestVoice voice;
+  ChannelState first, second;
+  auto &a = voice.start(mnotef(0), EnvelopeLevel::max(), 100_ms, preset, &first);
+  auto &b = voice.start(mnotef(1), EnvelopeLevel::max(), 200_ms, preset, &second);
+  voice.release_all(3000_ms, &second);
+  TEST_ASSERT_FALSE(a.is_released());
+  b.assert_released(3000_ms);
+}
+
+template <class TestVoice> void test_should_allow_the_minimum_size_of_one(void) {
   TestVoice voice(1);
   assert_note(voice, mnotef(0), 100_ms);
   assert_note(voice, mnotef(1), 200_ms);
@@ -222,7 +248,7 @@ void test_should_allow_the_minimum_size_of_one(void) {
   note.assert_started(mnotef(1), EnvelopeLevel::max(), 200_ms, preset);
 }
 
-void test_off(void) {
+template <class TestVoice> void test_off(void) {
   TestVoice voice;
   assert_note(voice, mnotef(0), 200_ms);
   assert_note(voice, mnotef(1), 200_ms);
@@ -233,7 +259,7 @@ void test_off(void) {
   TEST_ASSERT_FALSE(note.is_active());
 }
 
-void test_should_return_the_note_with_least_time2(void) {
+template <class TestVoice> void test_should_return_the_note_with_least_time2(void) {
   TestVoice voice;
   auto *note1 = &voice.start(mnotef(1), EnvelopeLevel::max(), 200_us, preset),
        *note2 = &voice.start(mnotef(2), EnvelopeLevel::max(), 1_s, preset),
@@ -272,7 +298,7 @@ void test_should_return_the_note_with_least_time2(void) {
   TEST_ASSERT_EQUAL(0, voice.active());
 }
 
-void test_adjust_size(void) {
+template <class TestVoice> void test_adjust_size(void) {
   TestVoice voice(3);
   assert_note(voice, mnotef(0), 200_ms);
   assert_note(voice, mnotef(1), 200_ms);
@@ -290,7 +316,7 @@ void test_adjust_size(void) {
   TEST_ASSERT_EQUAL(1, voice.active());
 }
 
-void test_should_pass_channel_state(void) {
+template <class TestVoice> void test_should_pass_channel_state(void) {
   TestVoice voice;
   ChannelState state;
 
@@ -299,23 +325,104 @@ void test_should_pass_channel_state(void) {
   evt.assert_started_with_channel_state(&state);
 }
 
+template <class V> void test_should_restart_a_playing_number_in_a_lower_idle_slot(void) {
+  V voice(2);
+  auto &first = voice.start(mnotef(1), EnvelopeLevel::max(), 0_us, preset);
+  auto &second = voice.start(mnotef(0), EnvelopeLevel::max(), 0_us, preset);
+  voice.release(mnotef(1), 0_us);
+  while (first.is_active())
+    voice.next().next();
+  TEST_ASSERT_EQUAL(1, voice.active());
+
+  // The idle slot comes before the one still playing the number
+  auto &again = voice.start(mnotef(0), EnvelopeLevel::max(), 5_ms, preset);
+  TEST_ASSERT_EQUAL(&first, &again);
+  TEST_ASSERT_EQUAL(2, voice.active());
+  voice.release(mnotef(0), 5_ms);
+  TEST_ASSERT_TRUE(second.is_released());
+  TEST_ASSERT_TRUE(again.is_released());
+}
+
+void test_heap_should_pick_pulses_in_scan_order(void) {
+  Voice<32, FakeEvent, ScanScheduler> scan(6);
+  Voice<32, FakeEvent, HeapScheduler> heap(6);
+  uint32_t seed = 12345;
+  auto random = [&seed](uint32_t n) {
+    seed = seed * 1664525 + 1013904223;
+    return (seed >> 8) % n;
+  };
+
+  // Few numbers, so notes are often restarted while they still play
+  uint8_t started = 0;
+  Duration now = 0_us;
+  for (int step = 0; step < 20000; step++) {
+    const uint32_t op = random(100);
+    if (op < 3 && started < 128) {
+      const auto amplitude = EnvelopeLevel(random(100) / 100.f);
+      const auto time = now + Duration32::micros(random(3000));
+      const uint8_t number = random(12);
+      scan.start(number, amplitude, time, preset);
+      heap.start(number, amplitude, time, preset);
+      started++;
+    } else if (op < 6 && started > 0) {
+      const uint8_t number = random(12);
+      scan.release(number, now);
+      heap.release(number, now);
+    } else {
+      auto &a = scan.next();
+      auto &b = heap.next();
+      TEST_ASSERT_EQUAL(a.is_active(), b.is_active());
+      TEST_ASSERT_EQUAL(scan.active(), heap.active());
+      if (!a.is_active())
+        continue;
+      TEST_ASSERT_EQUAL(a.current().start.micros(), b.current().start.micros());
+      TEST_ASSERT_EQUAL(a.current().volume.raw(), b.current().volume.raw());
+      now = a.current().start;
+      a.next();
+      b.next();
+    }
+  }
+  TEST_ASSERT_GREATER_THAN(100, started);
+}
+
 extern "C" void app_main(void) {
   UNITY_BEGIN();
   RUN_TEST(test_empty);
-  RUN_TEST(test_start);
-  RUN_TEST(test_should_limit_concurrent_voice);
-  RUN_TEST(test_should_steal_voices_that_are_the_most_quiet);
-  RUN_TEST(test_should_steal_voices_that_are_the_most_quiet2);
-  RUN_TEST(test_should_restart_the_same_note);
-  RUN_TEST(test_should_return_the_note_with_least_time);
-  RUN_TEST(test_should_return_the_note_with_least_time_after_tick);
-  RUN_TEST(test_should_release_note);
-  RUN_TEST(test_should_not_release_other_voice);
-  RUN_TEST(test_should_allow_the_minimum_size_of_one);
-  RUN_TEST(test_off);
-  RUN_TEST(test_should_return_the_note_with_least_time2);
-  RUN_TEST(test_adjust_size);
-  RUN_TEST(test_should_pass_channel_state);
+  RUN_TEST(test_start<ScanVoice>);
+  RUN_TEST(test_start<HeapVoice>);
+  RUN_TEST(test_should_limit_concurrent_voice<ScanVoice>);
+  RUN_TEST(test_should_limit_concurrent_voice<HeapVoice>);
+  RUN_TEST(test_should_steal_voices_that_are_the_most_quiet<ScanVoice>);
+  RUN_TEST(test_should_steal_voices_that_are_the_most_quiet<HeapVoice>);
+  RUN_TEST(test_should_steal_voices_that_are_the_most_quiet2<ScanVoice>);
+  RUN_TEST(test_should_steal_voices_that_are_the_most_quiet2<HeapVoice>);
+  RUN_TEST(test_should_restart_the_same_note<ScanVoice>);
+  RUN_TEST(test_should_restart_the_same_note<HeapVoice>);
+  RUN_TEST(test_should_return_the_note_with_least_time<ScanVoice>);
+  RUN_TEST(test_should_return_the_note_with_least_time<HeapVoice>);
+  RUN_TEST(test_should_return_the_note_with_least_time_after_tick<ScanVoice>);
+  RUN_TEST(test_should_return_the_note_with_least_time_after_tick<HeapVoice>);
+  RUN_TEST(test_should_release_note<ScanVoice>);
+  RUN_TEST(test_should_release_note<HeapVoice>);
+  RUN_TEST(test_should_not_release_other_voice<ScanVoice>);
+  RUN_TEST(test_should_not_release_other_voice<HeapVoice>);
+  RUN_TEST(test_should_release_all_notes<ScanVoice>);
+  RUN_TEST(test_should_release_all_notes<HeapVoice>);
+  RUN_TEST(test_should_release_all_notes_of_a_channel_only<ScanVoice>);
+  RUN_TEST(test_should_release_all_notes_of_a_channel_only<HeapVoice>);
+  RUN_TEST(test_should_allow_the_minimum_size_of_one<ScanVoice>);
+  RUN_TEST(test_should_allow_the_minimum_size_of_one<HeapVoice>);
+  RUN_TEST(test_off<ScanVoice>);
+  RUN_TEST(test_off<HeapVoice>);
+  RUN_TEST(test_should_return_the_note_with_least_time2<ScanVoice>);
+  RUN_TEST(test_should_return_the_note_with_least_time2<HeapVoice>);
+  RUN_TEST(test_adjust_size<ScanVoice>);
+  RUN_TEST(test_adjust_size<HeapVoice>);
+  RUN_TEST(test_should_pass_channel_state<ScanVoice>);
+  RUN_TEST(test_should_pass_channel_state<HeapVoice>);
+  RUN_TEST(test_should_restart_a_playing_number_in_a_lower_idle_slot<ScanVoice>);
+  RUN_TEST(test_should_restart_a_playing_number_in_a_lower_idle_slot<HeapVoice>);
+  RUN_TEST(test_heap_should_pick_pulses_in_scan_order);
 
   UNITY_END();
 }
@@ -49,6 +49,17 @@ void test_synth_instrument(void) {
   TEST_ASSERT_TRUE(config.synth().instrument == 1);
 }
 
+void test_synth_latency(void) {
+  Configuration<3> config, bkp = config;
+  ASSERT_UPDATES("synth.latency=15ms", config);
+  assert_duration_equal(config.synth().latency, 15_ms);
+
+  ASSERT_NO_UPDATES("synth.latency=60ms", config);
+  assert_duration_equal(config.synth().latency, 15_ms);
+  ASSERT_UPDATES("synth.latency=0", config);
+  TEST_ASSERT_TRUE(config.synth() == bkp.synth());
+}
+
 void test_synth_config(void) {
   Configuration<3> config;
   config.synth().instrument = 2;
@@ -145,6 +156,7 @@ extern "C" void app_main(void) {
   RUN_TEST(test_synth_tuning);
   RUN_TEST(test_synth_error);
   RUN_TEST(test_synth_instrument);
+  RUN_TEST(test_synth_latency);
   RUN_TEST(test_synth_config);
   RUN_TEST(test_channel_config);
   RUN_TEST(test_channel_config_multiple);
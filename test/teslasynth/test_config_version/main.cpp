@@ -0,0 +1,143 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "config_data.hpp"
+#include "synthesizer/helpers/assertions.hpp"
+#include <cstdint>
+#include <cstring>
+#include <unity.h>
+
+using namespace teslasynth::midisynth;
+
+using Config = Configuration<2>;
+
+// Writes fields the way another firmware would have left them in storage
+static void store_version(Config &config, uint32_t version) {
+  std::memcpy(reinterpret_cast<uint8_t *>(&config), &version, sizeof(version));
+}
+
+template <typename T> static void store_tuning(Config &config, T raw) {
+  static_assert(sizeof(T) == sizeof(Hertz));
+  std::memcpy(&config.synth().tuning, &raw, sizeof(raw));
+}
+
+static constexpr int32_t q23_8(float hz) { return static_cast<int32_t>(hz * 256); }
+
+void test_current_version_should_be_kept(void) {
+  Config config;
+  config.synth().tuning = 432_hz;
+  TEST_ASSERT_TRUE(config.upgrade());
+  TEST_ASSERT_EQUAL_UINT32(Config::current_version, config.version());
+  assert_hertz_equal(config.synth().tuning, 432_hz);
+}
+
+void test_version_should_record_the_arithmetic(void) {
+  const bool fixed = std::is_same_v<Arithmetic, FixedArithmetic>;
+  TEST_ASSERT_EQUAL(fixed, (Config::current_version & Config::fixed_point_flag) != 0);
+  TEST_ASSERT_EQUAL_UINT32(Config::layout_version,
+                           Config::current_version & ~Config::fixed_point_flag);
+}
+
+void test_unknown_versions_should_be_refused(void) {
+  for (uint32_t version : {0u, Config::layout_version + 1, Config::fixed_point_flag}) {
+    Config config;
+    store_version(config, version);
+    TEST_ASSERT_FALSE(config.upgrade());
+  }
+}
+
+void test_float_tuning_should_be_converted(void) {
+  Config config;
+  store_version(config, Config::layout_version);
+  store_tuning(config, 415.f);
+  TEST_ASSERT_TRUE(config.upgrade());
+  assert_hertz_equal(config.synth().tuning, 415_hz);
+  TEST_ASSERT_EQUAL_UINT32(Config::current_version, config.version());
+}
+
+void test_fixed_point_tuning_should_be_converted(void) {
+  Config config;
+  store_version(config, Config::layout_version | Config::fixed_point_flag);
+  store_tuning(config, q23_8(415.f));
+  TEST_ASSERT_TRUE(config.upgrade());
+  assert_hertz_equal(config.synth().tuning, 415_hz);
+  TEST_ASSERT_EQUAL_UINT32(Config::current_version, config.version());
+}
+
+void test_first_layout_should_be_read_from_either_arithmetic(void) {
+  Config from_float, from_fixed;
+  store_version(from_float, 1);
+  store_tuning(from_float, 440.f);
+  store_version(from_fixed, 1);
+  store_tuning(from_fixed, q23_8(442.f));
+
+  TEST_ASSERT_TRUE(from_float.upgrade());
+  TEST_ASSERT_TRUE(from_fixed.upgrade());
+  assert_hertz_equal(from_float.synth().tuning, 440_hz);
+  assert_hertz_equal(from_fixed.synth().tuning, 442_hz);
+}
+
+void test_nonsense_tuning_should_fall_back_to_default(void) {
+  Config config;
+  store_tuning(config, 0x7FC00000u); // NaN as a float, 8 MHz as Q23.8
+  TEST_ASSERT_TRUE(config.upgrade());
+  assert_hertz_equal(config.synth().tuning, SynthConfig().tuning);
+}
+
+void test_other_fields_should_survive(void) {
+  Config config;
+  config.synth().instrument = 3;
+  config.channel(1).notes = 2;
+  config.channel(1).max_duty = DutyCycle(20);
+  store_version(config, 1);
+  store_tuning(config, 440.f);
+  TEST_ASSERT_TRUE(config.upgrade());
+  TEST_ASSERT_TRUE(config.synth().instrument == 3);
+  TEST_ASSERT_EQUAL(2, config.channel(1).notes);
+  TEST_ASSERT_TRUE(config.channel(1).max_duty == DutyCycle(20));
+}
+
+void test_latency_should_be_reset_before_layout_3(void) {
+  for (uint32_t version : {1u, 2u}) {
+    Config config;
+    config.synth().latency = 20_ms;
+    store_version(config, version);
+    store_tuning(config, 440.f);
+    TEST_ASSERT_TRUE(config.upgrade());
+    TEST_ASSERT_TRUE(config.synth().latency == SynthConfig().latency);
+  }
+}
+
+void test_latency_should_be_kept_from_layout_3(void) {
+  Config config;
+  config.synth().latency = 20_ms;
+  TEST_ASSERT_TRUE(config.upgrade());
+  TEST_ASSERT_TRUE(config.synth().latency == 20_ms);
+}
+
+void test_latency_over_the_limit_should_be_reset(void) {
+  Config config;
+  config.synth().latency = SynthConfig::max_latency + 1_ms;
+  TEST_ASSERT_TRUE(config.upgrade());
+  TEST_ASSERT_TRUE(config.synth().latency == SynthConfig().latency);
+}
+
+extern "C" void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_current_version_should_be_kept);
+  RUN_TEST(test_version_should_record_the_arithmetic);
+  RUN_TEST(test_unknown_versions_should_be_refused);
+  RUN_TEST(test_float_tuning_should_be_converted);
+  RUN_TEST(test_fixed_point_tuning_should_be_converted);
+  RUN_TEST(test_first_layout_should_be_read_from_either_arithmetic);
+  RUN_TEST(test_nonsense_tuning_should_fall_back_to_default);
+  RUN_TEST(test_other_fields_should_survive);
+  RUN_TEST(test_latency_should_be_reset_before_layout_3);
+  RUN_TEST(test_latency_should_be_kept_from_layout_3);
+  RUN_TEST(test_latency_over_the_limit_should_be_reset);
+  UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  app_main();
+}
@@ -0,0 +1,141 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#define CONFIG_TESLASYNTH_ENGINE_STATS 1
+
+#include "midi_core.hpp"
+#include "midi_synth.hpp"
+#include "synthesizer/helpers/assertions.hpp"
+#include <cstdint>
+#include <unity.h>
+
+using namespace teslasynth::midisynth;
+
+static uint32_t sounding_pulses(Teslasynth<1> &synth, int blocks) {
+  PulseBuffer<1, 64> buffer;
+  uint32_t res = 0;
+  for (int block = 0; block < blocks; block++) {
+    synth.sample_all(10_ms, buffer);
+    for (uint8_t i = 0; i < buffer.data_size(0); i++)
+      if (!buffer.at(0, i).on.is_zero())
+        res++;
+  }
+  return res;
+}
+
+void test_should_count_emitted_pulses(void) {
+  static_assert(EngineCounters::enabled);
+  Teslasynth<1> synth;
+  synth.handle(MidiChannelMessage::note_on(0, 69, 127), 0_ms);
+  const uint32_t pulses = sounding_pulses(synth, 10);
+  TEST_ASSERT_GREATER_THAN(0, pulses);
+
+  const auto stats = synth.stats(0);
+  TEST_ASSERT_EQUAL_UINT32(pulses, stats.pulses);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.skipped);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.limited);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.steals);
+  TEST_ASSERT_EQUAL(1, stats.peak_voices);
+}
+
+void test_should_count_pulses_the_limiter_silences(void) {
+  Teslasynth<1> free, limited;
+  limited.configuration().channel(0).max_duty = DutyCycle(1);
+  limited.reload_config();
+  for (auto *synth : {&free, &limited})
+    synth->handle(MidiChannelMessage::note_on(0, 81, 127), 0_ms);
+
+  const uint32_t expected = sounding_pulses(free, 10);
+  const uint32_t played = sounding_pulses(limited, 10);
+  const auto stats = limited.stats(0);
+  TEST_ASSERT_GREATER_THAN(0, stats.limited);
+  TEST_ASSERT_EQUAL_UINT32(played, stats.pulses);
+  TEST_ASSERT_EQUAL_UINT32(expected, stats.pulses + stats.limited);
+  TEST_ASSERT_GREATER_OR_EQUAL(stats.limited, stats.limited_on_us);
+}
+
+void test_should_count_pulses_of_late_notes(void) {
+  Teslasynth<1> synth;
+  synth.handle(MidiChannelMessage::note_on(0, 60, 127), 0_ms);
+  sounding_pulses(synth, 5);
+  TEST_ASSERT_EQUAL_UINT32(0, synth.stats(0).skipped);
+
+  // Pulses of the two notes land on each other's dead time now and then
+  synth.handle(MidiChannelMessage::note_on(0, 61, 127), 0_ms);
+  sounding_pulses(synth, 10);
+  TEST_ASSERT_GREATER_THAN(0, synth.stats(0).skipped);
+}
+
+void test_should_not_skip_the_attack_of_a_note_started_behind_playback(void) {
+  Teslasynth<1> synth;
+  PulseBuffer<1, 64> buffer;
+  synth.handle(MidiChannelMessage::note_on(0, 60, 127), 0_ms);
+  // Rendered ahead of the clock, as the render loop does
+  synth.sample_all(22_ms, buffer);
+
+  // Arrives while what was rendered still plays
+  synth.handle(MidiChannelMessage::note_on(0, 81, 127), 5_ms);
+  assert_duration_equal(*synth.next_edge(0), Duration::zero());
+  synth.sample_all(2_ms, buffer);
+  TEST_ASSERT_FALSE(buffer.at(0, 0).on.is_zero());
+  TEST_ASSERT_EQUAL_UINT32(0, synth.stats(0).skipped);
+}
+
+void test_should_count_voice_steals(void) {
+  Teslasynth<1> synth;
+  synth.configuration().channel(0).notes = 2;
+  synth.reload_config();
+
+  synth.handle(MidiChannelMessage::note_on(0, 60, 127), 0_ms);
+  synth.handle(MidiChannelMessage::note_on(0, 64, 127), 0_ms);
+  TEST_ASSERT_EQUAL_UINT32(0, synth.stats(0).steals);
+  // Retriggering a sounding note reuses its own slot
+  synth.handle(MidiChannelMessage::note_on(0, 64, 100), 1_ms);
+  TEST_ASSERT_EQUAL_UINT32(0, synth.stats(0).steals);
+  synth.handle(MidiChannelMessage::note_on(0, 67, 127), 2_ms);
+  synth.handle(MidiChannelMessage::note_on(0, 71, 127), 3_ms);
+  TEST_ASSERT_EQUAL_UINT32(2, synth.stats(0).steals);
+  TEST_ASSERT_EQUAL(2, synth.stats(0).peak_voices);
+}
+
+void test_should_count_dropped_messages(void) {
+  Teslasynth<1> synth;
+  synth.handle(MidiChannelMessage::note_on(0, 60, 127), 0_ms);
+  // Fed far ahead of playback, more than the schedule holds
+  for (size_t i = 0; i < EventSchedule<>::capacity + 3; i++)
+    synth.handle(MidiChannelMessage::pitchbend(0, 100 * i), Duration::millis(1 + i));
+  TEST_ASSERT_EQUAL_UINT32(3, synth.stats(0).dropped);
+
+  // Stopping the track leaves the rest for good
+  synth.off();
+  TEST_ASSERT_EQUAL_UINT32(EventSchedule<>::capacity + 3, synth.stats(0).dropped);
+}
+
+void test_should_reset_stats(void) {
+  Teslasynth<2> synth;
+  synth.handle(MidiChannelMessage::note_on(1, 60, 127), 0_ms);
+  PulseBuffer<2, 64> buffer;
+  synth.sample_all(10_ms, buffer);
+  TEST_ASSERT_EQUAL_UINT32(0, synth.stats(0).pulses);
+  TEST_ASSERT_GREATER_THAN(0, synth.stats(1).pulses);
+
+  synth.reset_stats();
+  TEST_ASSERT_EQUAL_UINT32(0, synth.stats(1).pulses);
+  TEST_ASSERT_EQUAL(0, synth.stats(1).peak_voices);
+}
+
+extern "C" void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_should_count_emitted_pulses);
+  RUN_TEST(test_should_count_pulses_the_limiter_silences);
+  RUN_TEST(test_should_count_pulses_of_late_notes);
+  RUN_TEST(test_should_not_skip_the_attack_of_a_note_started_behind_playback);
+  RUN_TEST(test_should_count_voice_steals);
+  RUN_TEST(test_should_count_dropped_messages);
+  RUN_TEST(test_should_reset_stats);
+  UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  app_main();
+}
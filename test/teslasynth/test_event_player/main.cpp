@@ -0,0 +1,145 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "core.hpp"
+#include "event_player.hpp"
+#include "midi_core.hpp"
+#include "midi_synth.hpp"
+#include "synthesizer/helpers/assertions.hpp"
+#include <array>
+#include <cstdint>
+#include <unity.h>
+#include <vector>
+
+using namespace teslasynth::midisynth;
+
+constexpr std::array<TimedChannelMessage, 6> events{{
+    {0, MidiChannelMessage::note_on(0, 69, 127)},
+    {5'000, MidiChannelMessage::note_on(1, 72, 100)},
+    {12'000, MidiChannelMessage::pitchbend(0, 10000)},
+    {20'000, MidiChannelMessage::note_off(0, 69, 0)},
+    {20'000, MidiChannelMessage::note_on(0, 76, 90)},
+    {41'000, MidiChannelMessage::note_off(1, 72, 0)},
+}};
+
+using Pulses = std::array<std::vector<Pulse>, 2>;
+
+static void assert_pulses_equal(const Pulses &expected, const Pulses &actual) {
+  for (uint8_t ch = 0; ch < 2; ch++) {
+    TEST_ASSERT_EQUAL(expected[ch].size(), actual[ch].size());
+    for (size_t i = 0; i < expected[ch].size(); i++) {
+      assert_duration_equal(expected[ch][i].on, actual[ch][i].on);
+      assert_duration_equal(expected[ch][i].off, actual[ch][i].off);
+    }
+  }
+}
+
+void test_handle_until_should_apply_events_before_end(void) {
+  Teslasynth<2> tsynth;
+  EventPlayer<2> player(tsynth, events.data(), events.size());
+  TEST_ASSERT_FALSE(player.done());
+  assert_duration_equal(player.end_time(), 41_ms);
+
+  TEST_ASSERT_EQUAL(0, player.handle_until(0_us));
+  TEST_ASSERT_FALSE(tsynth.track().is_playing());
+
+  TEST_ASSERT_EQUAL(2, player.handle_until(12_ms));
+  TEST_ASSERT_EQUAL(2, player.position());
+  TEST_ASSERT_TRUE(tsynth.track().is_playing());
+
+  TEST_ASSERT_EQUAL(3, player.handle_until(20001_us));
+  TEST_ASSERT_EQUAL(5, player.position());
+  TEST_ASSERT_EQUAL(1, player.handle_until(Duration::max()));
+  TEST_ASSERT_TRUE(player.done());
+  TEST_ASSERT_EQUAL(0, player.handle_until(Duration::max()));
+}
+
+void test_should_start_from_given_position(void) {
+  Teslasynth<2> tsynth;
+  EventPlayer<2> player(tsynth, events.data(), events.size(), 3);
+  TEST_ASSERT_EQUAL(3, player.position());
+  TEST_ASSERT_EQUAL(2, player.handle_until(21_ms));
+
+  EventPlayer<2> past_end(tsynth, events.data(), events.size(), 100);
+  TEST_ASSERT_TRUE(past_end.done());
+}
+
+void test_render_should_match_step_by_step_playback(void) {
+  Pulses expected;
+  {
+    Teslasynth<2> tsynth;
+    PulseBuffer<2, 64> buf;
+    size_t next = 0;
+    for (Duration time = Duration::zero(); time <= 41_ms + 10_ms; time += 10_ms) {
+      for (; next < events.size() && events[next].time_us < (time + 10_ms).micros(); next++)
+        tsynth.handle(events[next].message, Duration::micros(events[next].time_us));
+      tsynth.sample_all(10_ms, buf);
+      for (uint8_t ch = 0; ch < 2; ch++)
+        for (size_t i = 0; i < buf.data_size(ch); i++)
+          expected[ch].push_back(buf.at(ch, i));
+    }
+  }
+
+  Pulses actual;
+  Teslasynth<2> tsynth;
+  EventPlayer<2> player(tsynth, events.data(), events.size());
+  const Duration rendered =
+      player.render(10_ms, 64, [&actual](uint8_t ch, const Pulse &p) { actual[ch].push_back(p); });
+
+  assert_duration_equal(rendered, 60_ms);
+  TEST_ASSERT_TRUE(player.done());
+  TEST_ASSERT_GREATER_THAN(0, actual[0].size());
+  TEST_ASSERT_GREATER_THAN(0, actual[1].size());
+  assert_pulses_equal(expected, actual);
+}
+
+void test_render_should_seek_to_given_position(void) {
+  Pulses expected;
+  {
+    Teslasynth<2> tsynth;
+    PulseBuffer<2, 64> buf;
+    size_t next = 4;
+    for (Duration time = 20_ms; time <= 41_ms + 10_ms; time += 10_ms) {
+      for (; next < events.size() && events[next].time_us < (time + 10_ms).micros(); next++)
+        tsynth.handle(events[next].message, Duration::micros(events[next].time_us));
+      tsynth.sample_all(10_ms, buf);
+      for (uint8_t ch = 0; ch < 2; ch++)
+        for (size_t i = 0; i < buf.data_size(ch); i++)
+          expected[ch].push_back(buf.at(ch, i));
+    }
+  }
+
+  Pulses actual;
+  Teslasynth<2> tsynth;
+  EventPlayer<2> player(tsynth, events.data(), events.size(), 4);
+  const Duration rendered =
+      player.render(10_ms, 64, [&actual](uint8_t ch, const Pulse &p) { actual[ch].push_back(p); });
+
+  // From the 20ms window to one step after the last event, without the 20ms before it
+  assert_duration_equal(rendered, 40_ms);
+  TEST_ASSERT_GREATER_THAN(0, actual[0].size());
+  assert_pulses_equal(expected, actual);
+}
+
+void test_render_should_do_nothing_without_events(void) {
+  Teslasynth<2> tsynth;
+  EventPlayer<2> player(tsynth, events.data(), 0);
+  size_t written = 0;
+  const Duration rendered = player.render(10_ms, 64, [&](uint8_t, const Pulse &) { written++; });
+  assert_duration_equal(rendered, Duration::zero());
+  TEST_ASSERT_EQUAL(0, written);
+}
+
+extern "C" void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_handle_until_should_apply_events_before_end);
+  RUN_TEST(test_should_start_from_given_position);
+  RUN_TEST(test_render_should_match_step_by_step_playback);
+  RUN_TEST(test_render_should_seek_to_given_position);
+  RUN_TEST(test_render_should_do_nothing_without_events);
+  UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  app_main();
+}
@@ -0,0 +1,294 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+// Renders every file in corpus/ through the engine with fixed configs and
+// compares each output's pulse stream against the digests in the golden file.
+//
+// A change that is meant to alter the output is accepted by regenerating the
+// digests and committing them with it:
+//
+//   TESLASYNTH_GOLDEN_UPDATE=1 pio test -e native -f teslasynth/test_golden
+//
+// Digests only say which chunk diverged. To see the exact pulse, render with
+// TESLASYNTH_GOLDEN_DUMP=<dir> before and after the change and diff the dumps.
+
+#include "core.hpp"
+#include "event_player.hpp"
+#include "midi_core.hpp"
+#include "midi_synth.hpp"
+#include "smf_reader.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unity.h>
+#include <vector>
+
+using namespace teslasynth::midisynth;
+namespace fs = std::filesystem;
+
+constexpr uint8_t outputs = 4;
+// The firmware render period, and enough room that no block saturates
+constexpr Duration16 step = 2_ms;
+constexpr size_t capacity = 64;
+constexpr size_t chunk = 256;
+
+// Float and fixed point builds round differently, so each has its own digests
+#ifdef CONFIG_TESLASYNTH_FIXED_POINT
+constexpr const char *golden_name = "golden_fixed.txt";
+#else
+constexpr const char *golden_name = "golden.txt";
+#endif
+
+static const fs::path root = fs::path(__FILE__).parent_path();
+
+struct Setup {
+  const char *name;
+  void (*apply)(Configuration<outputs> &);
+};
+
+static void with_drums(Configuration<outputs> &config) {
+  config.routing().percussion = true;
+  config.routing().mapping[9] = OutputNumberOpt<outputs>(outputs - 1);
+}
+
+// Factory defaults, and a coil that is short of notes, duty and on time
+static const std::array<Setup, 2> setups{{
+    {"default", with_drums},
+    {"tight",
+     [](Configuration<outputs> &config) {
+       with_drums(config);
+       for (auto &ch : config.channels()) {
+         ch.notes = 2;
+         ch.max_on_time = 60_us;
+         ch.min_deadtime = 200_us;
+         ch.max_duty = DutyCycle(5);
+         ch.duty_window = 5_ms;
+         ch.pulse_resolution = 5_us;
+       }
+     }},
+}};
+
+/// The pulses one output played, and the digest of every `chunk` of them
+struct Stream {
+  std::vector<Pulse> pulses;
+  std::vector<uint32_t> digests;
+};
+
+// FNV-1a over the on and off times of the pulses in [from, to)
+static uint32_t digest(const std::vector<Pulse> &pulses, size_t from, size_t to) {
+  uint32_t hash = 2166136261u;
+  auto mix = [&hash](uint16_t value) {
+    for (uint8_t byte : {static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8)}) {
+      hash ^= byte;
+      hash *= 16777619u;
+    }
+  };
+  for (size_t i = from; i < to; i++) {
+    mix(pulses[i].on.micros());
+    mix(pulses[i].off.micros());
+  }
+  return hash;
+}
+
+static void seal(Stream &stream) {
+  for (size_t at = 0; at < stream.pulses.size(); at += chunk)
+    stream.digests.push_back(digest(stream.pulses, at, std::min(at + chunk, stream.pulses.size())));
+}
+
+static std::vector<TimedChannelMessage> read(const fs::path &path) {
+  std::ifstream file(path, std::ios::binary);
+  const std::vector<uint8_t> data{std::istreambuf_iterator<char>(file), {}};
+  std::vector<TimedChannelMessage> events;
+  const SmfError error = read_smf(data.data(), data.size(),
+                                  [&events](const TimedChannelMessage &e) { events.push_back(e); });
+  TEST_ASSERT_TRUE_MESSAGE(error == SmfError::None,
+                           (path.string() + ": " + smf_error_message(error)).c_str());
+  return events;
+}
+
+static std::array<Stream, outputs> render(const std::vector<TimedChannelMessage> &events,
+                                          const Setup &setup) {
+  Configuration<outputs> config;
+  setup.apply(config);
+  auto synth = std::make_unique<Teslasynth<outputs>>(config);
+  synth->seed_hits(HitSeed::NoteAndTime);
+  EventPlayer<outputs> player(*synth, events.data(), events.size());
+  std::array<Stream, outputs> res;
+  player.render(step, capacity,
+                [&res](uint8_t ch, const Pulse &p) { res[ch].pulses.push_back(p); });
+  for (auto &stream : res)
+    seal(stream);
+  return res;
+}
+
+/// A rendered stream, keyed by "<file> <setup> <output>"
+using Renders = std::map<std::string, Stream>;
+
+static Renders render_corpus() {
+  std::vector<fs::path> files;
+  for (const auto &entry : fs::directory_iterator(root / "corpus"))
+    if (entry.path().extension() == ".mid")
+      files.push_back(entry.path());
+  std::sort(files.begin(), files.end());
+  TEST_ASSERT_FALSE_MESSAGE(files.empty(), "Empty corpus");
+
+  Renders res;
+  for (const auto &file : files) {
+    const auto events = read(file);
+    for (const auto &setup : setups) {
+      auto streams = render(events, setup);
+      for (uint8_t ch = 0; ch < outputs; ch++)
+        res[file.filename().string() + " " + setup.name + " " + std::to_string(ch + 1)] =
+            std::move(streams[ch]);
+    }
+  }
+  return res;
+}
+
+struct Golden {
+  size_t pulses;
+  std::vector<uint32_t> digests;
+};
+
+// One line per stream: <file> <setup> <output> <pulses> <digest>...
+static std::map<std::string, Golden> load_golden() {
+  std::map<std::string, Golden> res;
+  std::ifstream file(root / golden_name);
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream in(line);
+    std::string name, setup, output;
+    Golden golden;
+    in >> name >> setup >> output >> golden.pulses;
+    uint32_t value;
+    while (in >> std::hex >> value)
+      golden.digests.push_back(value);
+    res[name + " " + setup + " " + output] = golden;
+  }
+  return res;
+}
+
+static bool save_golden(const Renders &renders) {
+  std::ofstream file(root / golden_name);
+  file << "# Pulse stream digests of test_golden, one per " << chunk << " pulses\n"
+       << "# <file> <setup> <output> <pulses> <digest>...\n";
+  char hex[10];
+  for (const auto &[key, stream] : renders) {
+    file << key << ' ' << stream.pulses.size();
+    for (uint32_t value : stream.digests) {
+      std::snprintf(hex, sizeof(hex), " %08x", static_cast<unsigned>(value));
+      file << hex;
+    }
+    file << '\n';
+  }
+  return static_cast<bool>(file);
+}
+
+static void dump(const Renders &renders, const fs::path &dir) {
+  fs::create_directories(dir);
+  for (const auto &[key, stream] : renders) {
+    std::string name = key;
+    std::replace(name.begin(), name.end(), ' ', '_');
+    std::ofstream file(dir / (name + ".txt"));
+    uint64_t time = 0;
+    for (const auto &p : stream.pulses) {
+      file << time << ' ' << p.on.micros() << ' ' << p.off.micros() << '\n';
+      time += p.length().micros();
+    }
+  }
+}
+
+// Where the first differing chunk starts, and the pulses around it as rendered now
+static std::string divergence(const std::string &key, const Stream &stream, const Golden &golden) {
+  size_t at = 0;
+  while (at < golden.digests.size() && at < stream.digests.size() &&
+         golden.digests[at] == stream.digests[at])
+    at++;
+  const size_t first = at * chunk;
+  uint64_t time = 0;
+  for (size_t i = 0; i < std::min(first, stream.pulses.size()); i++)
+    time += stream.pulses[i].length().micros();
+
+  std::string res = key + ": " + std::to_string(stream.pulses.size()) + " pulses, expected " +
+                    std::to_string(golden.pulses) + "; diverges in pulses " +
+                    std::to_string(first) + ".." + std::to_string(first + chunk - 1) + " from " +
+                    std::to_string(time) + "us:";
+  const size_t from = first >= 2 ? first - 2 : 0;
+  for (size_t i = from; i < std::min(first + 6, stream.pulses.size()); i++)
+    res += std::string(i == first ? " |" : " ") + std::to_string(stream.pulses[i].on.micros()) +
+           "/" + std::to_string(stream.pulses[i].off.micros());
+  return res;
+}
+
+void test_should_render_the_same_twice(void) {
+  const fs::path drums = root / "corpus" / "drums.mid";
+  const auto events = read(drums);
+  for (const auto &setup : setups) {
+    const auto a = render(events, setup), b = render(events, setup);
+    for (uint8_t ch = 0; ch < outputs; ch++)
+      TEST_ASSERT_TRUE(a[ch].digests == b[ch].digests);
+    TEST_ASSERT_GREATER_THAN(0, a[outputs - 1].pulses.size());
+  }
+}
+
+void test_digest_should_catch_a_single_pulse(void) {
+  Stream stream, changed;
+  for (uint16_t i = 0; i < 3 * chunk; i++)
+    stream.pulses.push_back({Duration16::micros(i % 100), Duration16::micros(1000 - i)});
+  changed.pulses = stream.pulses;
+  changed.pulses[chunk + 7].off = changed.pulses[chunk + 7].off + 1_us;
+  seal(stream);
+  seal(changed);
+
+  TEST_ASSERT_EQUAL(3, stream.digests.size());
+  TEST_ASSERT_EQUAL_UINT32(stream.digests[0], changed.digests[0]);
+  TEST_ASSERT_TRUE(stream.digests[1] != changed.digests[1]);
+  TEST_ASSERT_EQUAL_UINT32(stream.digests[2], changed.digests[2]);
+}
+
+void test_corpus_should_match_golden_digests(void) {
+  const Renders renders = render_corpus();
+  if (const char *dir = std::getenv("TESLASYNTH_GOLDEN_DUMP"))
+    dump(renders, dir);
+  if (std::getenv("TESLASYNTH_GOLDEN_UPDATE") != nullptr) {
+    TEST_ASSERT_TRUE_MESSAGE(save_golden(renders), "Couldn't write the golden digests");
+    return;
+  }
+
+  const auto golden = load_golden();
+  std::string failures;
+  for (const auto &[key, stream] : renders) {
+    const auto it = golden.find(key);
+    if (it == golden.end())
+      failures += "\n" + key + ": no golden digests, run with TESLASYNTH_GOLDEN_UPDATE=1";
+    else if (it->second.pulses != stream.pulses.size() || it->second.digests != stream.digests)
+      failures += "\n" + divergence(key, stream, it->second);
+  }
+  for (const auto &[key, _] : golden)
+    if (renders.find(key) == renders.end())
+      failures += "\n" + key + ": not in the corpus anymore";
+  TEST_ASSERT_TRUE_MESSAGE(failures.empty(), failures.c_str());
+}
+
+extern "C" void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_should_render_the_same_twice);
+  RUN_TEST(test_digest_should_catch_a_single_pulse);
+  RUN_TEST(test_corpus_should_match_golden_digests);
+  UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  app_main();
+}
@@ -11,8 +11,11 @@
 #include "presets.hpp"
 #include "synthesizer/helpers/assertions.hpp"
 #include "unity_internals.h"
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <unity.h>
+#include <utility>
 #include <vector>
 
 using namespace teslasynth::midisynth;
@@ -65,23 +68,35 @@ private:
   std::vector<Started> started_;
   std::vector<Released> released_;
   std::vector<Off> offs_;
+  std::vector<Duration> released_all_, cuts_;
   std::vector<uint8_t> adjusts_;
+  uint8_t sounding_ = 0;
 
 public:
   Note &start(uint8_t number, EnvelopeLevel amplitude, Duration time, const SoundPreset &preset,
               const ChannelState *state = nullptr) {
     started_.push_back({number, amplitude, time, preset, state});
+    sounding_++;
     return note;
   }
 
   void release(uint8_t number, Duration time) { released_.push_back({number, time}); }
-  void off() { offs_.push_back({}); }
+  void release_all(Duration time, const ChannelState *) { released_all_.push_back(time); }
+  void off() {
+    offs_.push_back({});
+    sounding_ = 0;
+  }
+  void off(Duration time, const ChannelState *) { cuts_.push_back(time); }
 
   void adjust_size(uint8_t size) { adjusts_.push_back(size); }
+  bool would_steal(uint8_t) { return false; }
+  uint8_t active() const { return sounding_; }
 
   const std::vector<Started> started() const { return started_; }
   const std::vector<Released> released() const { return released_; }
   const std::vector<Off> turned_off() const { return offs_; }
+  const std::vector<Duration> released_all() const { return released_all_; }
+  const std::vector<Duration> cut() const { return cuts_; }
   const std::vector<uint8_t> adjusted() const { return adjusts_; }
 };
 
@@ -178,10 +193,14 @@ void test_should_handle_instrument_change(void) {
   TEST_ASSERT_EQUAL(0, tsynth.instrument_number(0));
   TEST_ASSERT_FALSE(track.is_playing());
 
+  tsynth.handle(MidiChannelMessage::program_change(0, 1), 10_ms);
+  TEST_ASSERT_EQUAL(1, tsynth.instrument_number(0));
+
   for (auto i = 0; i < N; i++) {
-    tsynth.handle(MidiChannelMessage::program_change(0, i), 10_ms);
-    TEST_ASSERT_EQUAL(i, tsynth.instrument_number(0));
-    tsynth.handle(MidiChannelMessage::note_on(0, 69 + i, 10 * (i + 1)), 0_ms);
+    // Scheduled once playing, still in effect for notes at the same time
+    const auto time = Duration::millis(10 * (i + 1));
+    tsynth.handle(MidiChannelMessage::program_change(0, i), time);
+    tsynth.handle(MidiChannelMessage::note_on(0, 69 + i, 10 * (i + 1)), time);
 
     TEST_ASSERT_TRUE(track.is_playing());
     TEST_ASSERT_EQUAL(i + 1, voice.started().size());
@@ -254,6 +273,74 @@ void test_should_turnoff_when_needed(void) {
   }
 }
 
+void test_channel_mode_messages_should_act_at_their_time(void) {
+  for (auto ch = 0; ch < 16; ch++) {
+    Teslasynth<1, FakeNotes> tsynth;
+    tsynth.configuration().routing().mapping[ch] = 0;
+    auto &track = tsynth.track();
+    auto &voice = tsynth.voice();
+    // At their time on the track, which keeps playing while the note sounds
+    tsynth.handle(MidiChannelMessage::note_on(ch, 69, 127), 10_ms);
+    tsynth.handle(MidiChannelMessage::control_change(ch, ControlChange::ALL_NOTES_OFF, 0), 30_ms);
+    tsynth.handle(MidiChannelMessage::control_change(ch, ControlChange::ALL_SOUND_OFF, 0), 40_ms);
+    TEST_ASSERT_EQUAL(1, voice.released_all().size());
+    assert_duration_equal(voice.released_all().back(), 20_ms);
+    TEST_ASSERT_EQUAL(1, voice.cut().size());
+    assert_duration_equal(voice.cut().back(), 30_ms);
+    TEST_ASSERT_EQUAL(0, voice.turned_off().size());
+    TEST_ASSERT_TRUE(track.is_playing());
+
+    tsynth.off();
+    TEST_ASSERT_EQUAL(1, voice.turned_off().size());
+    TEST_ASSERT_FALSE(track.is_playing());
+  }
+}
+
+void test_channel_mode_messages_should_only_act_on_their_channel(void) {
+  Teslasynth<1> tsynth;
+  tsynth.configuration().routing().mapping[1] = 0;
+  PulseBuffer<1, 64> buffer;
+  tsynth.handle(MidiChannelMessage::note_on(0, 60, 127), 0_ms);
+  tsynth.handle(MidiChannelMessage::note_on(1, 64, 127), 0_ms);
+  tsynth.handle(MidiChannelMessage::control_change(0, ControlChange::ALL_NOTES_OFF, 0), 10_ms);
+  for (int block = 0; block < 200; block++)
+    tsynth.sample_all(10_ms, buffer);
+  // Only the note of channel 0 was released, the track plays on with the other one
+  TEST_ASSERT_EQUAL(1, tsynth.voice().active());
+  TEST_ASSERT_TRUE(tsynth.track().is_playing());
+
+  // Stops as soon as nothing sounds anymore
+  tsynth.handle(MidiChannelMessage::control_change(1, ControlChange::ALL_SOUND_OFF, 0), 2000_ms);
+  TEST_ASSERT_TRUE(tsynth.track().is_playing());
+  tsynth.sample_all(10_ms, buffer);
+  TEST_ASSERT_EQUAL(0, tsynth.voice().active());
+  TEST_ASSERT_FALSE(tsynth.track().is_playing());
+}
+
+void test_should_apply_program_changes_at_their_time(void) {
+  Teslasynth<1> tsynth;
+  tsynth.handle(MidiChannelMessage::note_on(0, 69, 127), 0_ms);
+  tsynth.handle(MidiChannelMessage::program_change(0, 3), 10_ms);
+  TEST_ASSERT_EQUAL(0, tsynth.instrument_number(0));
+  while (tsynth.track().played_time(0) <= 10_ms)
+    tsynth.sample(0, 20_ms);
+  tsynth.sample(0, 20_ms);
+  TEST_ASSERT_EQUAL(3, tsynth.instrument_number(0));
+}
+
+void test_reset_all_controllers_should_center_pitch_bend(void) {
+  Teslasynth<1, FakeNotes> tsynth;
+  auto &voice = tsynth.voice();
+  tsynth.handle(MidiChannelMessage::pitchbend(0, 0), 0_ms);
+  tsynth.handle(MidiChannelMessage::note_on(0, 69, 127), 0_ms);
+  const ChannelState *state = voice.started().back().state;
+  TEST_ASSERT_FALSE(state->pitch_bend.is_zero());
+
+  tsynth.handle(MidiChannelMessage::control_change(0, ControlChange::RESET_ALL_CONTROLLERS, 0),
+                0_ms);
+  TEST_ASSERT_TRUE(state->pitch_bend.is_zero());
+}
+
 void test_should_start_playing_the_first_note_on_message(void) {
   Teslasynth<1, FakeNotes> tsynth;
   auto &track = tsynth.track();
@@ -299,6 +386,29 @@ void test_reload_config_should_adjust_note_sizes(void) {
   TEST_ASSERT_EQUAL(2, voice.adjusted().back());
 }
 
+void test_set_config_should_use_its_tuning_without_reloading(void) {
+  Teslasynth<1, FakeNotes> tsynth;
+  auto &voice = tsynth.voice();
+  tsynth.note_on(0, 69, 127, 0_ms);
+
+  Configuration<> conf = tsynth.configuration();
+  conf.synth().tuning = 220_hz;
+  const TuningTable table(220_hz);
+  tsynth.set_config(conf, table);
+  TEST_ASSERT_TRUE(tsynth.track().is_playing());
+  TEST_ASSERT_EQUAL(1, voice.adjusted().size());
+
+  tsynth.note_on(0, 69, 127, 1_ms);
+  assert_hertz_equal(voice.started().back().as_pitch().tuning, 220_hz);
+  TEST_ASSERT_NOT_NULL(voice.started().back().as_pitch().table);
+
+  // Edited in place, the tuning is computed per note until the next reload
+  tsynth.configuration().synth().tuning = 110_hz;
+  tsynth.note_on(0, 69, 127, 2_ms);
+  assert_hertz_equal(voice.started().back().as_pitch().tuning, 110_hz);
+  TEST_ASSERT_NULL(voice.started().back().as_pitch().table);
+}
+
 void test_should_handle_channel_volume(void) {
   Teslasynth<1, FakeNotes> tsynth;
   auto &voice = tsynth.voice();
@@ -361,6 +471,165 @@ void test_sample_all_should_write_each_output_to_its_own_buffer_slot(void) {
   }
 }
 
+using Stream = std::vector<std::pair<uint32_t, uint32_t>>;
+
+// Pulses with silences merged, so streams split at different points compare equal
+static void advance(Teslasynth<2> &tsynth, std::array<Stream, 2> &out, Duration until) {
+  for (uint8_t ch = 0; ch < 2; ch++) {
+    while (tsynth.track().played_time(ch) < until) {
+      const uint64_t left = until.micros() - tsynth.track().played_time(ch).micros();
+      const Pulse p = tsynth.sample(ch, Duration16::micros(std::min<uint64_t>(left, 60'000)));
+      if (p.on.is_zero() && !out[ch].empty())
+        out[ch].back().second += p.off.micros();
+      else
+        out[ch].push_back({p.on.micros(), p.off.micros()});
+    }
+  }
+}
+
+void test_should_apply_messages_fed_ahead_at_their_time(void) {
+  Teslasynth<2> tsynth;
+  tsynth.handle(MidiChannelMessage::note_on(1, 69, 127), 0_ms);
+  tsynth.handle(MidiChannelMessage::pitchbend(0, 0), 5_ms);
+
+  // Output 0 only renders up to the pitch bend, then carries on
+  assert_duration_equal(tsynth.sample(0, 10_ms).off, 5_ms);
+  assert_duration_equal(tsynth.sample(0, 10_ms).off, 10_ms);
+}
+
+using Events = std::vector<std::pair<Duration, MidiChannelMessage>>;
+
+// A latency keeps real time input ahead of playback too, by more than a note period
+static void assert_ahead_renders_like_real_time(const Events &events, Duration until,
+                                                Duration16 latency = Duration16::zero()) {
+  const Configuration<2> config(SynthConfig{.latency = latency});
+  std::array<Stream, 2> realtime;
+  {
+    Teslasynth<2> tsynth(config);
+    for (const auto &[time, msg] : events) {
+      advance(tsynth, realtime, time);
+      tsynth.handle(msg, time);
+    }
+    advance(tsynth, realtime, until);
+  }
+
+  std::array<Stream, 2> ahead;
+  Teslasynth<2> tsynth(config);
+  for (const auto &[time, msg] : events)
+    tsynth.handle(msg, time);
+  advance(tsynth, ahead, until);
+
+  for (uint8_t ch = 0; ch < 2; ch++) {
+    TEST_ASSERT_GREATER_THAN(10, realtime[ch].size());
+    TEST_ASSERT_EQUAL(realtime[ch].size(), ahead[ch].size());
+    for (size_t i = 0; i < realtime[ch].size(); i++) {
+      TEST_ASSERT_EQUAL_UINT32(realtime[ch][i].first, ahead[ch][i].first);
+      TEST_ASSERT_EQUAL_UINT32(realtime[ch][i].second, ahead[ch][i].second);
+    }
+  }
+}
+
+// Notes are already placed on the track timeline, releases even more precisely ahead of time
+void test_feeding_ahead_should_render_like_feeding_in_real_time(void) {
+  assert_ahead_renders_like_real_time(
+      {
+          {0_ms, MidiChannelMessage::note_on(0, 57, 127)},
+          {1_ms, MidiChannelMessage::note_on(1, 64, 90)},
+          {3_ms, MidiChannelMessage::control_change(1, ControlChange::CHANNEL_VOLUME_MSB, 40)},
+          {Duration::micros(7'300), MidiChannelMessage::pitchbend(0, 16000)},
+          {Duration::micros(12'150), MidiChannelMessage::pitchbend(0, 2000)},
+          {Duration::micros(23'100), MidiChannelMessage::pitchbend(0, 8192)},
+          {31_ms, MidiChannelMessage::control_change(1, ControlChange::CHANNEL_VOLUME_MSB, 127)},
+          {40_ms, MidiChannelMessage::pitchbend(0, 12000)},
+      },
+      60_ms);
+}
+
+void test_feeding_ahead_should_render_channel_mode_and_program_changes_in_real_time(void) {
+  const auto mode = [](uint8_t ch, ControlChange cc) {
+    return MidiChannelMessage::control_change(ch, cc, 0);
+  };
+  assert_ahead_renders_like_real_time(
+      {
+          {0_ms, MidiChannelMessage::note_on(0, 57, 127)},
+          {1_ms, MidiChannelMessage::note_on(1, 64, 90)},
+          {Duration::micros(4'500), MidiChannelMessage::program_change(0, 3)},
+          {6_ms, MidiChannelMessage::note_on(0, 60, 127)},
+          {9_ms, MidiChannelMessage::pitchbend(1, 3000)},
+          {Duration::micros(12'700), mode(1, ControlChange::ALL_NOTES_OFF)},
+          {14_ms, MidiChannelMessage::note_on(1, 67, 100)},
+          {17_ms, MidiChannelMessage::program_change(1, 5)},
+          {17_ms, MidiChannelMessage::note_on(1, 71, 100)},
+          {Duration::micros(21'300), mode(0, ControlChange::ALL_SOUND_OFF)},
+          {24_ms, MidiChannelMessage::note_on(0, 62, 110)},
+          {28_ms, mode(1, ControlChange::RESET_ALL_CONTROLLERS)},
+          {Duration::micros(33'100), mode(0, ControlChange::ALL_NOTES_OFF)},
+          {36_ms, MidiChannelMessage::program_change(0, 1)},
+          {38_ms, MidiChannelMessage::note_on(0, 64, 127)},
+      },
+      70_ms, 10_ms);
+}
+
+void test_latency_should_play_late_input_at_a_fixed_delay(void) {
+  constexpr auto latency = 20_ms;
+  struct Arrival {
+    Duration time, delay; // delay: until the message is handled, e.g. by a busy input
+    MidiChannelMessage message;
+  };
+  std::vector<Arrival> arrivals;
+  for (uint32_t i = 0; i < 12; i++) {
+    const Duration time = Duration::micros(1'000 + 7'300 * i);
+    const Duration delay = Duration::micros((i * 5'311) % 6'000);
+    const uint8_t number = 50 + (i / 2) * 3;
+    const auto message = i % 2 ? MidiChannelMessage::note_off(0, number, 0)
+                               : MidiChannelMessage::note_on(0, number, 110);
+    arrivals.push_back({time, delay, message});
+  }
+
+  // Reference: each message handled ahead of its time by more than a note period, which is what
+  // notes need to play it exactly
+  std::array<Stream, 2> exact;
+  {
+    Teslasynth<2> tsynth;
+    for (const auto &a : arrivals) {
+      const uint64_t due = a.time.micros() - arrivals[0].time.micros();
+      if (due > 15'000)
+        advance(tsynth, exact, Duration::micros(due - 15'000));
+      tsynth.handle(a.message, a.time);
+    }
+    advance(tsynth, exact, 200_ms);
+  }
+
+  // Live: handled at the start of the first 10ms block after arrival and delay
+  std::array<Stream, 2> live;
+  Teslasynth<2> tsynth;
+  tsynth.configuration().synth().latency = latency;
+  size_t next = 0;
+  Duration played = Duration::zero();
+  for (Duration block = 10_ms; played < 200_ms + latency; block += 10_ms) {
+    for (; next < arrivals.size() && arrivals[next].time + arrivals[next].delay < block; next++)
+      tsynth.handle(arrivals[next].message, arrivals[next].time);
+    if (tsynth.track().is_playing())
+      advance(tsynth, live, played += 10_ms);
+  }
+
+  TEST_ASSERT_EQUAL(exact[0].size() + 1, live[0].size());
+  TEST_ASSERT_EQUAL_UINT32(0, live[0][0].first);
+  TEST_ASSERT_EQUAL_UINT32(latency.micros(), live[0][0].second);
+  for (size_t i = 0; i < exact[0].size(); i++) {
+    TEST_ASSERT_EQUAL_UINT32(exact[0][i].first, live[0][i + 1].first);
+    TEST_ASSERT_EQUAL_UINT32(exact[0][i].second, live[0][i + 1].second);
+  }
+
+  const auto &timing = tsynth.input_timing();
+  TEST_ASSERT_EQUAL(arrivals.size(), timing.buffered.count);
+  TEST_ASSERT_EQUAL(0, timing.buffered.late);
+  TEST_ASSERT_GREATER_THAN(0, timing.unbuffered.late);
+  TEST_ASSERT_TRUE(timing.unbuffered.jitter_us() > 0);
+  tsynth.reset_input_timing();
+  TEST_ASSERT_EQUAL(0, tsynth.input_timing().unbuffered.count);
+}
+
 extern "C" void app_main(void) {
   UNITY_BEGIN();
   RUN_TEST(test_note_pulse_empty);
@@ -374,13 +643,22 @@ extern "C" void app_main(void) {
   RUN_TEST(test_config_instrument_overrides_runtime_instrument);
   RUN_TEST(test_non_existing_instrument_number_falls_back_to_default);
   RUN_TEST(test_should_turnoff_when_needed);
+  RUN_TEST(test_channel_mode_messages_should_act_at_their_time);
+  RUN_TEST(test_channel_mode_messages_should_only_act_on_their_channel);
+  RUN_TEST(test_should_apply_program_changes_at_their_time);
+  RUN_TEST(test_reset_all_controllers_should_center_pitch_bend);
   RUN_TEST(test_should_start_playing_the_first_note_on_message);
   RUN_TEST(test_should_ignore_off_messages_when_not_playing);
   RUN_TEST(test_should_adjust_note_sizes);
   RUN_TEST(test_reload_config_should_adjust_note_sizes);
+  RUN_TEST(test_set_config_should_use_its_tuning_without_reloading);
   RUN_TEST(test_should_handle_channel_volume);
   RUN_TEST(test_should_handle_pitch_bend);
   RUN_TEST(test_sample_all_should_write_each_output_to_its_own_buffer_slot);
+  RUN_TEST(test_should_apply_messages_fed_ahead_at_their_time);
+  RUN_TEST(test_feeding_ahead_should_render_like_feeding_in_real_time);
+  RUN_TEST(test_feeding_ahead_should_render_channel_mode_and_program_changes_in_real_time);
+  RUN_TEST(test_latency_should_play_late_input_at_a_fixed_delay);
 
   UNITY_END();
 }
@@ -0,0 +1,163 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+// Parsing, handling and rendering run in the firmware's real time tasks and
+// must never reach the heap. Global operator new is replaced here, and counts
+// every allocation made while the trap is armed.
+
+#include "midi_core.hpp"
+#include "midi_parser.hpp"
+#include "midi_synth.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <unity.h>
+#include <vector>
+
+using namespace teslasynth::midisynth;
+
+static bool armed = false;
+static size_t trapped = 0;
+
+static void *allocate(std::size_t size) {
+  if (armed)
+    trapped++;
+  if (void *p = std::malloc(size != 0 ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size) { return allocate(size); }
+void *operator new[](std::size_t size) { return allocate(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  if (armed)
+    trapped++;
+  return std::malloc(size != 0 ? size : 1);
+}
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept {
+  return operator new(size, tag);
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+/// Counts the allocations made while it is alive
+class Trap {
+  size_t _from = trapped;
+
+public:
+  Trap() { armed = true; }
+  ~Trap() { armed = false; }
+  size_t count() const { return trapped - _from; }
+};
+
+void test_trap_should_catch_allocations(void) {
+  // Kept alive so the allocation can't be optimized away
+  static std::unique_ptr<int> kept;
+  size_t count;
+  {
+    Trap trap;
+    kept = std::make_unique<int>(1);
+    count = trap.count();
+  }
+  TEST_ASSERT_EQUAL(1, count);
+}
+
+constexpr uint8_t outputs = 4;
+
+/**
+ * Every kind of message the engine handles, on all 16 channels and the
+ * percussion channel, with running status, realtime bytes in between
+ * messages and a sysex the parser has to skip.
+ */
+static std::vector<uint8_t> stress_stream(uint32_t seed) {
+  std::vector<uint8_t> res;
+  auto random = [&seed](uint32_t range) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) % range;
+  };
+  for (int i = 0; i < 4000; i++) {
+    const uint8_t ch = random(16), note = 24 + random(84);
+    switch (random(10)) {
+    case 0:
+      res.insert(res.end(), {static_cast<uint8_t>(0xE0 | ch), static_cast<uint8_t>(random(128)),
+                             static_cast<uint8_t>(random(128))});
+      break;
+    case 1:
+      res.insert(res.end(),
+                 {static_cast<uint8_t>(0xB0 | ch), 7, static_cast<uint8_t>(random(128))});
+      break;
+    case 2:
+      res.insert(res.end(), {static_cast<uint8_t>(0xC0 | ch), static_cast<uint8_t>(random(40))});
+      break;
+    case 3:
+      res.insert(res.end(), {0xF8, 0xF0, 0x7D, 0x01, 0x02, 0xF7});
+      break;
+    case 4:
+      res.insert(res.end(), {static_cast<uint8_t>(0x80 | ch), note, 0});
+      break;
+    default:
+      // Note on, then a running status note off
+      res.insert(res.end(), {static_cast<uint8_t>(0x90 | ch), note,
+                             static_cast<uint8_t>(1 + random(127)), note, 0});
+      break;
+    }
+  }
+  // All notes off on one channel, while the others keep playing
+  res.insert(res.end(), {0xB0, 123, 0});
+  return res;
+}
+
+void test_should_not_allocate_while_playing(void) {
+  Configuration<outputs> config;
+  config.routing().percussion = true;
+  config.routing().mapping[9] = OutputNumberOpt<outputs>(outputs - 1);
+  auto synth = std::make_unique<Teslasynth<outputs>>(config);
+  auto buffer = std::make_unique<PulseBuffer<outputs, 64>>();
+  const auto bytes = stress_stream(7);
+
+  Duration now = 0_ms;
+  MidiParser parser([&](const MidiChannelMessage &msg) { synth->handle(msg, now); });
+
+  uint64_t pulses = 0;
+  bool restarted;
+  size_t count;
+  {
+    Trap trap;
+    for (size_t at = 0; at < bytes.size(); at += 24) {
+      now += 1_ms;
+      parser.feed(bytes.data() + at, std::min<size_t>(24, bytes.size() - at));
+      synth->sample_all(1_ms, *buffer);
+      for (uint8_t ch = 0; ch < outputs; ch++)
+        pulses += buffer->data_size(ch);
+    }
+
+    // Then playing again from a stopped track
+    synth->off();
+    const uint8_t restart[] = {0x90, 60, 100, 0x99, 36, 127};
+    now += 1_ms;
+    parser.feed(restart, sizeof(restart));
+    synth->sample_all(1_ms, *buffer);
+    restarted = synth->track().is_playing() && buffer->data_size(0) > 0;
+    count = trap.count();
+  }
+
+  TEST_ASSERT_GREATER_THAN(0, pulses);
+  TEST_ASSERT_TRUE(restarted);
+  TEST_ASSERT_EQUAL_MESSAGE(0, count, "Allocated while parsing, handling or rendering");
+}
+
+extern "C" void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_trap_should_catch_allocations);
+  RUN_TEST(test_should_not_allocate_while_playing);
+  UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  app_main();
+}
@@ -0,0 +1,120 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "core.hpp"
+#include "midi_core.hpp"
+#include "midi_synth.hpp"
+#include "output_cursor.hpp"
+#include "pulse_encoder.hpp"
+#include "synthesizer/helpers/assertions.hpp"
+#include <cstdint>
+#include <unity.h>
+#include <vector>
+
+using namespace teslasynth::midisynth;
+
+constexpr uint8_t outputs = 2;
+using Synth = Teslasynth<outputs>;
+
+static void play_chords(Synth &synth) {
+  for (uint8_t ch = 0; ch < outputs; ch++)
+    for (uint8_t n = 0; n < 3; n++)
+      synth.handle(MidiChannelMessage::note_on(ch, 60 + 5 * ch + 4 * n, 60 + 20 * n),
+                   Duration::micros(700 * ch + 300 * n));
+}
+
+static uint32_t total_us(const std::vector<Pulse> &pulses) {
+  uint32_t total = 0;
+  for (const auto &p : pulses)
+    total += p.length().micros();
+  return total;
+}
+
+static std::vector<Pulse> pull_all(Synth &synth, OutputCursor<PulseEncoder> &cursor,
+                                   Duration32 length, size_t chunk) {
+  std::vector<Pulse> pulses;
+  Pulse out[16];
+  cursor.start(length);
+  while (!cursor.done()) {
+    const size_t n = cursor.pull(synth, out, chunk);
+    TEST_ASSERT_GREATER_THAN(0, n);
+    TEST_ASSERT_LESS_OR_EQUAL(chunk, n);
+    pulses.insert(pulses.end(), out, out + n);
+  }
+  return pulses;
+}
+
+void test_cursor_should_render_like_blocks(void) {
+  Synth blocks, pulled;
+  play_chords(blocks);
+  play_chords(pulled);
+  PulseBuffer<outputs, 255> buffer;
+  std::array<OutputCursor<PulseEncoder>, outputs> cursors{OutputCursor<PulseEncoder>(0),
+                                                           OutputCursor<PulseEncoder>(1)};
+
+  for (int block = 0; block < 20; block++) {
+    blocks.sample_all(10_ms, buffer);
+    for (uint8_t ch = 0; ch < outputs; ch++) {
+      // Pulled in chunks as small as a hardware half buffer would free
+      const auto pulses = pull_all(pulled, cursors[ch], 10_ms, 3 + block % 5);
+      TEST_ASSERT_EQUAL(buffer.data_size(ch), pulses.size());
+      for (size_t i = 0; i < pulses.size(); i++) {
+        assert_duration_equal(buffer.at(ch, i).on, pulses[i].on);
+        assert_duration_equal(buffer.at(ch, i).off, pulses[i].off);
+      }
+    }
+  }
+}
+
+void test_cursor_should_not_be_capped_by_a_buffer(void) {
+  Synth blocks, pulled;
+  play_chords(blocks);
+  play_chords(pulled);
+  PulseBuffer<outputs, 8> buffer;
+  OutputCursor<PulseEncoder> cursor(1);
+
+  blocks.sample_all(30_ms, buffer);
+  TEST_ASSERT_EQUAL(8, buffer.data_size(1));
+  uint32_t capped = 0;
+  for (size_t i = 0; i < buffer.data_size(1); i++)
+    capped += buffer.at(1, i).length().micros();
+  TEST_ASSERT_LESS_THAN(30000, capped);
+
+  const auto pulses = pull_all(pulled, cursor, 30_ms, 8);
+  TEST_ASSERT_GREATER_THAN(8, pulses.size());
+  TEST_ASSERT_GREATER_OR_EQUAL(30000, total_us(pulses));
+  assert_duration_equal(pulled.track().played_time(1), Duration::micros(total_us(pulses)));
+}
+
+void test_cursor_should_cover_long_lengths(void) {
+  Synth synth;
+  synth.handle(MidiChannelMessage::note_on(0, 40, 100), 0_ms);
+  OutputCursor<RmtSymbolCompiler> cursor;
+  cursor.start(Duration32::micros(200'000));
+  TEST_ASSERT_FALSE(cursor.done());
+
+  uint32_t symbols[4];
+  uint32_t total = 0, pulls = 0;
+  while (!cursor.done()) {
+    const size_t n = cursor.pull(synth, symbols, 4);
+    for (size_t i = 0; i < n; i++)
+      total += RmtSymbolEncoder::duration0(symbols[i]) + RmtSymbolEncoder::duration1(symbols[i]);
+    pulls++;
+  }
+  TEST_ASSERT_GREATER_THAN(1, pulls);
+  TEST_ASSERT_GREATER_OR_EQUAL(200'000, total);
+  TEST_ASSERT_EQUAL_UINT32(synth.track().played_time(0).micros(), total);
+  TEST_ASSERT_TRUE(cursor.left().is_zero());
+}
+
+extern "C" void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_cursor_should_render_like_blocks);
+  RUN_TEST(test_cursor_should_not_be_capped_by_a_buffer);
+  RUN_TEST(test_cursor_should_cover_long_lengths);
+  UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  app_main();
+}
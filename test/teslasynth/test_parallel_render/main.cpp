@@ -0,0 +1,119 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "core.hpp"
+#include "midi_core.hpp"
+#include "midi_synth.hpp"
+#include "render_partition.hpp"
+#include "synthesizer/helpers/assertions.hpp"
+#include <cstdint>
+#include <thread>
+#include <unity.h>
+#include <vector>
+
+using namespace teslasynth::midisynth;
+
+void test_partition_should_cover_every_output_once(void) {
+  for (uint8_t outputs = 0; outputs <= 8; outputs++)
+    for (uint8_t workers = 1; workers <= 4; workers++) {
+      uint8_t next = 0, smallest = 255, largest = 0;
+      for (uint8_t w = 0; w < workers; w++) {
+        const auto range = partition_outputs(outputs, workers, w);
+        TEST_ASSERT_EQUAL(next, range.first);
+        next = range.end();
+        smallest = std::min(smallest, range.count);
+        largest = std::max(largest, range.count);
+      }
+      TEST_ASSERT_EQUAL(outputs, next);
+      TEST_ASSERT_LESS_OR_EQUAL(1, largest - smallest);
+    }
+}
+
+void test_partition_examples(void) {
+  TEST_ASSERT_TRUE((partition_outputs(4, 2, 0) == OutputRange{0, 2}));
+  TEST_ASSERT_TRUE((partition_outputs(4, 2, 1) == OutputRange{2, 2}));
+  TEST_ASSERT_TRUE((partition_outputs(3, 2, 0) == OutputRange{0, 2}));
+  TEST_ASSERT_TRUE((partition_outputs(3, 2, 1) == OutputRange{2, 1}));
+  TEST_ASSERT_TRUE(partition_outputs(1, 2, 1).empty());
+  TEST_ASSERT_TRUE(partition_outputs(4, 0, 0).empty());
+  TEST_ASSERT_TRUE(partition_outputs(4, 2, 2).empty());
+  TEST_ASSERT_TRUE(partition_outputs(4, 2, 1).contains(3));
+  TEST_ASSERT_FALSE(partition_outputs(4, 2, 1).contains(1));
+}
+
+constexpr uint8_t outputs = 4;
+using Synth = Teslasynth<outputs>;
+using Buffer = PulseBuffer<outputs, 64>;
+
+static void play_chords(Synth &synth) {
+  for (uint8_t ch = 0; ch < 8; ch++)
+    for (uint8_t n = 0; n < 3; n++)
+      synth.handle(MidiChannelMessage::note_on(ch, 48 + 7 * ch + 4 * n, 60 + 20 * n),
+                   Duration::micros(1000 * ch + 300 * n));
+}
+
+static void assert_buffers_equal(Buffer &expected, Buffer &actual) {
+  for (uint8_t ch = 0; ch < outputs; ch++) {
+    TEST_ASSERT_EQUAL(expected.data_size(ch), actual.data_size(ch));
+    for (size_t i = 0; i < expected.data_size(ch); i++) {
+      assert_duration_equal(expected.at(ch, i).on, actual.at(ch, i).on);
+      assert_duration_equal(expected.at(ch, i).off, actual.at(ch, i).off);
+    }
+  }
+}
+
+void test_threads_should_render_like_a_single_pass(void) {
+  for (uint8_t workers = 1; workers <= 3; workers++) {
+    Synth serial, parallel;
+    play_chords(serial);
+    play_chords(parallel);
+    Buffer expected, actual;
+
+    size_t pulses = 0;
+    for (int block = 0; block < 200; block++) {
+      if (block == 120) {
+        serial.handle(MidiChannelMessage::note_off(1, 55, 0), 1200_ms);
+        parallel.handle(MidiChannelMessage::note_off(1, 55, 0), 1200_ms);
+      }
+      serial.sample_all(10_ms, expected);
+
+      std::vector<std::thread> threads;
+      for (uint8_t w = 0; w < workers; w++)
+        threads.emplace_back([&parallel, &actual, workers, w] {
+          parallel.sample_range(10_ms, actual, partition_outputs(outputs, workers, w));
+        });
+      for (auto &t : threads)
+        t.join();
+
+      assert_buffers_equal(expected, actual);
+      for (uint8_t ch = 0; ch < outputs; ch++)
+        pulses += expected.data_size(ch);
+    }
+    TEST_ASSERT_GREATER_THAN(1000, pulses);
+  }
+}
+
+void test_range_should_clear_only_its_outputs_when_stopped(void) {
+  Synth synth;
+  Buffer buffer;
+  for (uint8_t ch = 0; ch < outputs; ch++)
+    buffer.written[ch] = 7;
+  synth.sample_range(10_ms, buffer, {1, 2});
+  TEST_ASSERT_EQUAL(7, buffer.data_size(0));
+  TEST_ASSERT_EQUAL(0, buffer.data_size(1));
+  TEST_ASSERT_EQUAL(0, buffer.data_size(2));
+  TEST_ASSERT_EQUAL(7, buffer.data_size(3));
+}
+
+extern "C" void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_partition_should_cover_every_output_once);
+  RUN_TEST(test_partition_examples);
+  RUN_TEST(test_threads_should_render_like_a_single_pass);
+  RUN_TEST(test_range_should_clear_only_its_outputs_when_stopped);
+  UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  app_main();
+}
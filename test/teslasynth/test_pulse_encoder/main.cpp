@@ -0,0 +1,241 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "core.hpp"
+#include "midi_core.hpp"
+#include "midi_synth.hpp"
+#include "pulse_encoder.hpp"
+#include <cstdint>
+#include <cstring>
+#include <unity.h>
+
+using namespace teslasynth::midisynth;
+
+// Same layout as ESP-IDF's rmt_symbol_word_t
+union RmtWord {
+  struct {
+    uint16_t duration0 : 15;
+    uint16_t level0 : 1;
+    uint16_t duration1 : 15;
+    uint16_t level1 : 1;
+  };
+  uint32_t val;
+};
+
+static RmtWord word(uint32_t symbol) {
+  RmtWord w;
+  std::memcpy(&w, &symbol, sizeof(w));
+  return w;
+}
+
+static Pulse pulse(uint16_t on, uint16_t off) {
+  return {Duration16::micros(on), Duration16::micros(off)};
+}
+
+void test_pulse_encoder_is_identity(void) {
+  const Pulse p = pulse(120, 3000);
+  const Pulse e = PulseEncoder::encode(p);
+  TEST_ASSERT_EQUAL(120, e.on.micros());
+  TEST_ASSERT_EQUAL(3000, e.off.micros());
+}
+
+void test_rmt_should_encode_on_pulses(void) {
+  const auto w = word(RmtSymbolEncoder::encode(pulse(120, 3000)));
+  TEST_ASSERT_EQUAL(120, w.duration0);
+  TEST_ASSERT_EQUAL(1, w.level0);
+  TEST_ASSERT_EQUAL(3000, w.duration1);
+  TEST_ASSERT_EQUAL(0, w.level1);
+
+  // A pulse without a gap still needs a non-zero second half
+  TEST_ASSERT_EQUAL(1, word(RmtSymbolEncoder::encode(pulse(120, 0))).duration1);
+}
+
+void test_rmt_should_split_silences(void) {
+  for (uint32_t off = 2; off <= 65534; off += 97) {
+    const auto w = word(RmtSymbolEncoder::encode(pulse(0, off)));
+    TEST_ASSERT_EQUAL(0, w.level0);
+    TEST_ASSERT_EQUAL(0, w.level1);
+    TEST_ASSERT_GREATER_THAN(0, w.duration0);
+    TEST_ASSERT_GREATER_THAN(0, w.duration1);
+    TEST_ASSERT_EQUAL(off, w.duration0 + w.duration1);
+  }
+  const auto shortest = word(RmtSymbolEncoder::encode(pulse(0, 0)));
+  TEST_ASSERT_EQUAL(1, shortest.duration0);
+  TEST_ASSERT_EQUAL(1, shortest.duration1);
+}
+
+void test_rmt_should_clamp_long_durations(void) {
+  const auto w = word(RmtSymbolEncoder::encode(pulse(40000, 50000)));
+  TEST_ASSERT_EQUAL(0x7FFF, w.duration0);
+  TEST_ASSERT_EQUAL(1, w.level0);
+  TEST_ASSERT_EQUAL(0x7FFF, w.duration1);
+  TEST_ASSERT_EQUAL(0, w.level1);
+
+  const auto longest = word(RmtSymbolEncoder::encode(pulse(0, 65535)));
+  TEST_ASSERT_EQUAL(0x7FFF, longest.duration0);
+  TEST_ASSERT_EQUAL(0x7FFF, longest.duration1);
+}
+
+void test_rmt_symbol_accessors(void) {
+  const auto s = RmtSymbolEncoder::encode(pulse(250, 1200));
+  TEST_ASSERT_EQUAL(250, RmtSymbolEncoder::duration0(s));
+  TEST_ASSERT_TRUE(RmtSymbolEncoder::level0(s));
+  TEST_ASSERT_EQUAL(1200, RmtSymbolEncoder::duration1(s));
+  TEST_ASSERT_FALSE(RmtSymbolEncoder::level1(s));
+}
+
+void test_sample_all_should_encode_while_rendering(void) {
+  Teslasynth<2> pulses_synth, symbols_synth;
+  PulseBuffer<2, 64> pulses;
+  PulseBuffer<2, 64, RmtSymbolEncoder> symbols;
+  for (uint8_t ch = 0; ch < 2; ch++) {
+    pulses_synth.handle(MidiChannelMessage::note_on(ch, 60 + 5 * ch, 100), 0_ms);
+    symbols_synth.handle(MidiChannelMessage::note_on(ch, 60 + 5 * ch, 100), 0_ms);
+  }
+
+  for (int block = 0; block < 5; block++) {
+    pulses_synth.sample_all(10_ms, pulses);
+    symbols_synth.sample_all(10_ms, symbols);
+    for (uint8_t ch = 0; ch < 2; ch++) {
+      TEST_ASSERT_GREATER_THAN(0, pulses.data_size(ch));
+      TEST_ASSERT_EQUAL(pulses.data_size(ch), symbols.data_size(ch));
+      for (uint8_t i = 0; i < pulses.data_size(ch); i++)
+        TEST_ASSERT_EQUAL_UINT32(RmtSymbolEncoder::encode(pulses.at(ch, i)), symbols.at(ch, i));
+    }
+  }
+}
+
+static uint32_t total_us(const uint32_t *symbols, size_t size) {
+  uint32_t total = 0;
+  for (size_t i = 0; i < size; i++)
+    total += RmtSymbolEncoder::duration0(symbols[i]) + RmtSymbolEncoder::duration1(symbols[i]);
+  return total;
+}
+
+static void assert_valid(const uint32_t *symbols, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    TEST_ASSERT_GREATER_THAN(0, RmtSymbolEncoder::duration0(symbols[i]));
+    TEST_ASSERT_GREATER_THAN(0, RmtSymbolEncoder::duration1(symbols[i]));
+    TEST_ASSERT_FALSE(RmtSymbolEncoder::level1(symbols[i]));
+  }
+}
+
+void test_compiler_should_merge_silences(void) {
+  uint32_t out[8];
+  size_t size = 0;
+  for (int i = 0; i < 5; i++)
+    size = RmtSymbolCompiler::append(out, size, pulse(0, 100));
+  TEST_ASSERT_EQUAL(1, size);
+  TEST_ASSERT_FALSE(RmtSymbolEncoder::level0(out[0]));
+  TEST_ASSERT_EQUAL(500, total_us(out, size));
+}
+
+void test_compiler_should_fold_deadtime_into_silence(void) {
+  uint32_t out[8];
+  size_t size = RmtSymbolCompiler::append(out, 0, pulse(120, 300));
+  size = RmtSymbolCompiler::append(out, size, pulse(0, 2000));
+  size = RmtSymbolCompiler::append(out, size, pulse(0, 700));
+  TEST_ASSERT_EQUAL(1, size);
+  TEST_ASSERT_EQUAL(120, RmtSymbolEncoder::duration0(out[0]));
+  TEST_ASSERT_TRUE(RmtSymbolEncoder::level0(out[0]));
+  TEST_ASSERT_EQUAL(3000, RmtSymbolEncoder::duration1(out[0]));
+
+  size = RmtSymbolCompiler::append(out, size, pulse(80, 0));
+  TEST_ASSERT_EQUAL(2, size);
+  TEST_ASSERT_EQUAL(80, RmtSymbolEncoder::duration0(out[1]));
+  TEST_ASSERT_EQUAL(1, RmtSymbolEncoder::duration1(out[1]));
+}
+
+void test_compiler_should_chain_long_gaps(void) {
+  uint32_t out[16];
+  size_t size = RmtSymbolCompiler::append(out, 0, pulse(120, 50000));
+  TEST_ASSERT_EQUAL(2, size);
+  assert_valid(out, size);
+  TEST_ASSERT_EQUAL(50120, total_us(out, size));
+
+  for (int i = 0; i < 4; i++) {
+    const size_t before = size;
+    size = RmtSymbolCompiler::append(out, size, pulse(0, 65535));
+    TEST_ASSERT_LESS_OR_EQUAL(before + RmtSymbolCompiler::max_symbols, size);
+  }
+  assert_valid(out, size);
+  TEST_ASSERT_EQUAL(50120 + 4 * 65535, total_us(out, size));
+}
+
+void test_compiler_should_keep_durations_exact(void) {
+  uint32_t out[2 * 4096];
+  size_t size = 0;
+  uint32_t expected = 0;
+  uint32_t seed = 1;
+  for (int i = 0; i < 4096; i++) {
+    seed = seed * 1103515245 + 12345;
+    const uint16_t off = (seed >> 8) % 40000 + 1;
+    const uint16_t on = i % 3 == 0 ? (seed >> 20) % 400 + 1 : 0;
+    if (i == 0 && on == 0 && off == 1)
+      continue;
+    size = RmtSymbolCompiler::append(out, size, pulse(on, off));
+    expected += on + off;
+  }
+  assert_valid(out, size);
+  TEST_ASSERT_EQUAL_UINT32(expected, total_us(out, size));
+}
+
+void test_compiler_should_render_sparse_music_in_fewer_symbols(void) {
+  Teslasynth<1> encoded_synth, compiled_synth;
+  PulseBuffer<1, 64, RmtSymbolEncoder> encoded;
+  PulseBuffer<1, 64, RmtSymbolCompiler> compiled;
+  encoded_synth.handle(MidiChannelMessage::note_on(0, 48, 100), 0_ms);
+  compiled_synth.handle(MidiChannelMessage::note_on(0, 48, 100), 0_ms);
+
+  size_t encoded_symbols = 0, compiled_symbols = 0;
+  for (int block = 0; block < 20; block++) {
+    encoded_synth.sample_all(10_ms, encoded);
+    compiled_synth.sample_all(10_ms, compiled);
+    encoded_symbols += encoded.data_size(0);
+    compiled_symbols += compiled.data_size(0);
+    assert_valid(&compiled.data(0), compiled.data_size(0));
+    TEST_ASSERT_EQUAL_UINT32(total_us(&encoded.data(0), encoded.data_size(0)),
+                             total_us(&compiled.data(0), compiled.data_size(0)));
+
+    // The same pulses start at the same offsets
+    uint32_t encoded_at = 0, compiled_at = 0;
+    size_t j = 0;
+    for (size_t i = 0; i < encoded.data_size(0); i++) {
+      const uint32_t s = encoded.at(0, i);
+      if (RmtSymbolEncoder::level0(s)) {
+        while (!RmtSymbolEncoder::level0(compiled.at(0, j))) {
+          compiled_at += total_us(&compiled.at(0, j), 1);
+          j++;
+        }
+        TEST_ASSERT_EQUAL_UINT32(encoded_at, compiled_at);
+        TEST_ASSERT_EQUAL(RmtSymbolEncoder::duration0(s),
+                          RmtSymbolEncoder::duration0(compiled.at(0, j)));
+        compiled_at += total_us(&compiled.at(0, j), 1);
+        j++;
+      }
+      encoded_at += total_us(&s, 1);
+    }
+  }
+  TEST_ASSERT_GREATER_THAN(0, compiled_symbols);
+  TEST_ASSERT_LESS_THAN(encoded_symbols, compiled_symbols);
+}
+
+extern "C" void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_pulse_encoder_is_identity);
+  RUN_TEST(test_rmt_should_encode_on_pulses);
+  RUN_TEST(test_rmt_should_split_silences);
+  RUN_TEST(test_rmt_should_clamp_long_durations);
+  RUN_TEST(test_rmt_symbol_accessors);
+  RUN_TEST(test_sample_all_should_encode_while_rendering);
+  RUN_TEST(test_compiler_should_merge_silences);
+  RUN_TEST(test_compiler_should_fold_deadtime_into_silence);
+  RUN_TEST(test_compiler_should_chain_long_gaps);
+  RUN_TEST(test_compiler_should_keep_durations_exact);
+  RUN_TEST(test_compiler_should_render_sparse_music_in_fewer_symbols);
+  UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  app_main();
+}
@@ -0,0 +1,230 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "core.hpp"
+#include "midi_core.hpp"
+#include "midi_synth.hpp"
+#include "pulse_encoder.hpp"
+#include "render_cadence.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <unity.h>
+#include <vector>
+
+using namespace teslasynth::midisynth;
+
+static BlockReport playing(std::optional<Duration32> next_edge = Duration32::micros(100)) {
+  return {.playing = true, .note_started = false, .saturated = false, .next_edge = next_edge};
+}
+
+void test_cadence_should_idle_while_not_playing(void) {
+  RenderCadence cadence;
+  TEST_ASSERT_FALSE(cadence.next(BlockReport{}).has_value());
+  TEST_ASSERT_EQUAL(2000, cadence.period().micros());
+}
+
+void test_cadence_should_grow_during_sustain(void) {
+  RenderCadence cadence;
+  BlockReport attack = playing();
+  attack.note_started = true;
+  TEST_ASSERT_EQUAL(2000, cadence.next(attack)->micros());
+  TEST_ASSERT_EQUAL(4000, cadence.next(playing())->micros());
+  TEST_ASSERT_EQUAL(8000, cadence.next(playing())->micros());
+  TEST_ASSERT_EQUAL(16000, cadence.next(playing())->micros());
+  TEST_ASSERT_EQUAL(20000, cadence.next(playing())->micros());
+  TEST_ASSERT_EQUAL(20000, cadence.next(playing())->micros());
+
+  TEST_ASSERT_EQUAL(2000, cadence.next(attack)->micros());
+}
+
+void test_cadence_should_shorten_when_saturated(void) {
+  RenderCadence cadence;
+  for (int i = 0; i < 5; i++)
+    cadence.next(playing());
+  TEST_ASSERT_EQUAL(20000, cadence.period().micros());
+  BlockReport dense = playing(Duration32::zero());
+  dense.saturated = true;
+  TEST_ASSERT_EQUAL(2000, cadence.next(dense)->micros());
+}
+
+void test_cadence_should_sleep_until_the_next_edge(void) {
+  RenderCadence cadence({.min_period = Duration16::micros(1000),
+                         .max_period = Duration16::micros(30000)});
+  BlockReport attack = playing(Duration32::micros(7000));
+  attack.note_started = true;
+  TEST_ASSERT_EQUAL(7000, cadence.next(attack)->micros());
+  TEST_ASSERT_EQUAL(1000, cadence.period().micros());
+  TEST_ASSERT_EQUAL(30000, cadence.next(playing(Duration32::micros(90000)))->micros());
+  TEST_ASSERT_EQUAL(30000, cadence.next(playing(std::nullopt))->micros());
+}
+
+struct Event {
+  uint32_t time;
+  MidiChannelMessage message;
+};
+
+struct Simulation {
+  uint32_t blocks = 0, rendered = 0, playing_time = 0, max_attack_latency = 0, gaps = 0;
+  uint64_t queued_until = 0;
+};
+
+/**
+ * Runs a render loop against simulated time: input wakes the loop early, but
+ * blocks are never shorter than the minimum period. Blocks are rendered ahead
+ * like the firmware does, and played back to back by a simulated transmitter,
+ * which counts a gap whenever it runs dry while a note sounds. With a fixed
+ * period of `fixed_us` it waits that long every time.
+ */
+static Simulation simulate(const std::vector<Event> &events, uint32_t until,
+                           std::optional<uint32_t> fixed_us = std::nullopt) {
+  Teslasynth<1> synth;
+  PulseBuffer<1, 64, RmtSymbolCompiler> buffer;
+  RenderCadence cadence;
+  RenderAhead ahead(cadence.config().min_period);
+  const uint32_t min = fixed_us.value_or(cadence.config().min_period.micros());
+
+  Simulation res;
+  std::optional<Duration16> wait;
+  uint32_t last = 0;
+  size_t next = 0;
+  bool saturated = false;
+  while (last < until) {
+    uint32_t wake = wait ? last + wait->micros() : until;
+    if (fixed_us)
+      wake = last + *fixed_us;
+    else if (next < events.size() && events[next].time < wake)
+      wake = std::max(events[next].time, last + min);
+    wake = std::min(wake, until);
+
+    const bool sounding = synth.next_edge(0).has_value();
+    BlockReport report{
+        .playing = false, .note_started = false, .saturated = saturated, .next_edge = std::nullopt};
+    for (; next < events.size() && events[next].time <= wake; next++) {
+      const auto &e = events[next];
+      synth.handle(e.message, Duration::micros(e.time));
+      if (e.message.type == MidiMessageType::NoteOn) {
+        report.note_started = true;
+        res.max_attack_latency = std::max(res.max_attack_latency, wake - e.time);
+      }
+    }
+
+    report.playing = synth.track().is_playing();
+    if (auto edge = synth.next_edge(0))
+      report.next_edge = Duration32::micros(edge->micros());
+    wait = cadence.next(report);
+    if (fixed_us && wait)
+      wait = Duration16::micros(*fixed_us);
+    if (wait) {
+      const Duration16 budget = ahead.budget(wake, *wait);
+      const Duration before = synth.track().played_time(0);
+      synth.sample_all(budget, buffer);
+      res.blocks++;
+      res.playing_time += budget.micros();
+      saturated = buffer.data_size(0) + RmtSymbolCompiler::max_symbols > 64;
+
+      if (sounding && res.queued_until < wake)
+        res.gaps++;
+      const auto played = *(synth.track().played_time(0) - before);
+      res.queued_until = std::max<uint64_t>(res.queued_until, wake) + played.micros();
+      wait = std::min(*wait, ahead.queue(wake, budget));
+    }
+    last = wake;
+  }
+  res.rendered = synth.track().played_time(0).micros();
+  return res;
+}
+
+static std::vector<Event> sparse_song() {
+  std::vector<Event> events;
+  for (uint32_t bar = 0; bar < 4; bar++) {
+    const uint32_t t = 100'000 + bar * 500'000 + bar * 1'337;
+    events.push_back({t, MidiChannelMessage::note_on(0, 48 + 5 * bar, 100)});
+    events.push_back({t + 400'000, MidiChannelMessage::note_off(0, 48 + 5 * bar, 0)});
+  }
+  return events;
+}
+
+void test_simulation_should_save_blocks_during_sustain(void) {
+  const auto events = sparse_song();
+  const auto fixed = simulate(events, 2'200'000, 10'000);
+  const auto adaptive = simulate(events, 2'200'000);
+
+  TEST_ASSERT_GREATER_THAN(0, adaptive.blocks);
+  TEST_ASSERT_LESS_THAN(fixed.blocks * 2 / 3, adaptive.blocks);
+  // Every note goes out within the shortest period
+  TEST_ASSERT_LESS_OR_EQUAL(2000, adaptive.max_attack_latency);
+  TEST_ASSERT_GREATER_THAN(2000, fixed.max_attack_latency);
+}
+
+void test_simulation_should_render_all_of_the_track(void) {
+  const auto adaptive = simulate(sparse_song(), 2'200'000);
+  // Blocks may overrun by a pulse's dead-time, nothing is skipped
+  TEST_ASSERT_GREATER_OR_EQUAL(adaptive.playing_time, adaptive.rendered);
+  TEST_ASSERT_LESS_THAN(adaptive.playing_time + 1000, adaptive.rendered);
+}
+
+void test_render_ahead_should_cover_the_wait(void) {
+  RenderAhead ahead(Duration16::micros(2000));
+  TEST_ASSERT_EQUAL(7000, ahead.budget(1000, Duration16::micros(5000)).micros());
+  TEST_ASSERT_EQUAL(5000, ahead.queue(1000, Duration16::micros(7000)).micros());
+  // Woken a bit late, the margin is still queued and only the rest is rendered
+  TEST_ASSERT_EQUAL(1000, ahead.backlog(7000));
+  TEST_ASSERT_EQUAL(21000, ahead.budget(7000, Duration16::micros(20000)).micros());
+  // The queue ran dry, so the next block starts from now
+  TEST_ASSERT_EQUAL(0, ahead.backlog(50000));
+  TEST_ASSERT_EQUAL(4000, ahead.budget(50000, Duration16::micros(2000)).micros());
+  // A wait that the largest block can't cover is cut short
+  TEST_ASSERT_EQUAL(UINT16_MAX, ahead.budget(50000, Duration16::micros(65000)).micros());
+  TEST_ASSERT_EQUAL(UINT16_MAX - 2000,
+                    ahead.queue(50000, Duration16::micros(UINT16_MAX)).micros());
+  // Once the hardware drops the queue, the whole wait is rendered again
+  ahead.drained();
+  TEST_ASSERT_EQUAL(0, ahead.backlog(51000));
+  TEST_ASSERT_EQUAL(7000, ahead.budget(51000, Duration16::micros(5000)).micros());
+}
+
+void test_simulation_should_not_leave_gaps(void) {
+  // A low note sleeps until its next pulse, a higher one lets the period double
+  std::vector<Event> events = sparse_song();
+  events.insert(events.begin(), {50'000, MidiChannelMessage::note_on(0, 35, 100)});
+  events.push_back({2'000'000, MidiChannelMessage::note_off(0, 35, 0)});
+  const auto adaptive = simulate(events, 2'200'000);
+  const auto fixed = simulate(events, 2'200'000, 10'000);
+
+  TEST_ASSERT_EQUAL(0, adaptive.gaps);
+  TEST_ASSERT_EQUAL(0, fixed.gaps);
+  // The queue keeps up with time, ahead of it by a period, the margin and a pulse's overrun
+  TEST_ASSERT_GREATER_OR_EQUAL(2'200'000, adaptive.queued_until);
+  TEST_ASSERT_LESS_OR_EQUAL(2'200'000 + 24'000, adaptive.queued_until);
+}
+
+void test_simulation_should_shorten_dense_passages(void) {
+  std::vector<Event> events;
+  for (uint8_t n = 0; n < 4; n++)
+    events.push_back({1000u + n, MidiChannelMessage::note_on(0, 100 + n, 127)});
+  const auto sustained = simulate(events, 500'000, 20'000);
+  const auto dense = simulate(events, 500'000);
+  // The highest notes need more symbols than a long block has room for, and
+  // what doesn't fit falls behind
+  TEST_ASSERT_GREATER_THAN(sustained.blocks, dense.blocks);
+  TEST_ASSERT_LESS_THAN(sustained.playing_time - sustained.rendered,
+                        dense.playing_time - dense.rendered);
+}
+
+extern "C" void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_cadence_should_idle_while_not_playing);
+  RUN_TEST(test_cadence_should_grow_during_sustain);
+  RUN_TEST(test_cadence_should_shorten_when_saturated);
+  RUN_TEST(test_cadence_should_sleep_until_the_next_edge);
+  RUN_TEST(test_render_ahead_should_cover_the_wait);
+  RUN_TEST(test_simulation_should_save_blocks_during_sustain);
+  RUN_TEST(test_simulation_should_render_all_of_the_track);
+  RUN_TEST(test_simulation_should_not_leave_gaps);
+  RUN_TEST(test_simulation_should_shorten_dense_passages);
+  UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  app_main();
+}
@@ -0,0 +1,103 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "render_profile.hpp"
+#include <cstdint>
+#include <thread>
+#include <unity.h>
+#include <vector>
+
+using namespace teslasynth::midisynth;
+
+struct FakeClock {
+  static inline uint32_t ticks = 0;
+  static uint32_t now() { return ticks; }
+};
+
+void test_buckets_are_bit_widths(void) {
+  TEST_ASSERT_EQUAL(0, Histogram::bucket_of(0));
+  TEST_ASSERT_EQUAL(1, Histogram::bucket_of(1));
+  TEST_ASSERT_EQUAL(2, Histogram::bucket_of(2));
+  TEST_ASSERT_EQUAL(2, Histogram::bucket_of(3));
+  TEST_ASSERT_EQUAL(11, Histogram::bucket_of(1024));
+  TEST_ASSERT_EQUAL(32, Histogram::bucket_of(UINT32_MAX));
+  for (size_t b = 0; b < Histogram::buckets; b++)
+    TEST_ASSERT_EQUAL(b, Histogram::bucket_of(Histogram::upper_bound(b)));
+}
+
+void test_histogram_counts_and_percentiles(void) {
+  Histogram h;
+  TEST_ASSERT_EQUAL(0, h.percentile(50));
+  for (uint32_t v = 1; v <= 100; v++)
+    h.record(v < 90 ? 10 : 1000);
+  TEST_ASSERT_EQUAL(100, h.count());
+  TEST_ASSERT_EQUAL(1000, h.max());
+  TEST_ASSERT_EQUAL(89, h.bucket(Histogram::bucket_of(10)));
+  TEST_ASSERT_EQUAL(15, h.percentile(50));
+  TEST_ASSERT_EQUAL(15, h.percentile(89));
+  TEST_ASSERT_EQUAL(1000, h.percentile(90));
+  TEST_ASSERT_EQUAL(1000, h.percentile(100));
+
+  h.reset();
+  TEST_ASSERT_EQUAL(0, h.count());
+  TEST_ASSERT_EQUAL(0, h.max());
+}
+
+void test_scope_timer_records_elapsed_ticks(void) {
+  RenderProfile profile;
+  FakeClock::ticks = UINT32_MAX - 5;
+  {
+    ScopeTimer<FakeClock> timer(profile.timing(Stage::Render));
+    FakeClock::ticks += 20; // wraps
+  }
+  TEST_ASSERT_EQUAL(1, profile.timing(Stage::Render).count());
+  TEST_ASSERT_EQUAL(20, profile.timing(Stage::Render).max());
+  TEST_ASSERT_EQUAL(0, profile.timing(Stage::Parse).count());
+}
+
+void test_profile_counts_deadline_misses(void) {
+  RenderProfile profile;
+  profile.block(100, 2000);
+  profile.block(2500, 2000);
+  TEST_ASSERT_EQUAL(2, profile.timing(Stage::Block).count());
+  TEST_ASSERT_EQUAL(1, profile.deadline_misses.load());
+  profile.input_dropped++;
+  profile.reset();
+  TEST_ASSERT_EQUAL(0, profile.deadline_misses.load());
+  TEST_ASSERT_EQUAL(0, profile.input_dropped.load());
+  TEST_ASSERT_EQUAL(0, profile.timing(Stage::Block).count());
+}
+
+void test_histogram_is_safe_to_record_concurrently(void) {
+  static Histogram h;
+  constexpr uint32_t per_thread = 200'000;
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < 4; t++)
+    threads.emplace_back([t] {
+      for (uint32_t i = 0; i < per_thread; i++)
+        h.record(i % 1000 + t);
+    });
+  for (auto &thread : threads)
+    thread.join();
+
+  TEST_ASSERT_EQUAL_UINT32(4 * per_thread, h.count());
+  TEST_ASSERT_EQUAL_UINT32(999 + 3, h.max());
+  uint32_t total = 0;
+  for (size_t b = 0; b < Histogram::buckets; b++)
+    total += h.bucket(b);
+  TEST_ASSERT_EQUAL_UINT32(4 * per_thread, total);
+}
+
+extern "C" void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_buckets_are_bit_widths);
+  RUN_TEST(test_histogram_counts_and_percentiles);
+  RUN_TEST(test_scope_timer_records_elapsed_ticks);
+  RUN_TEST(test_profile_counts_deadline_misses);
+  RUN_TEST(test_histogram_is_safe_to_record_concurrently);
+  UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  app_main();
+}
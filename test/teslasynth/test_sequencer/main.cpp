@@ -230,6 +230,26 @@ void test_should_sequence_polyphonic_out_of_phase_multichannel_note_off(void) {
   assert_duration_equal(ch1[0].off, buffer.at(1, 0).off);
 }
 
+void test_sample_channel_should_stop_at_capacity(void) {
+  Teslasynth<2> tsynth(sconf);
+  tsynth.note_on(0, mnotef(0), 10_ms);
+  tsynth.note_on(0, mnotef(12), 11_ms);
+
+  std::vector<Pulse> pulses;
+  const size_t written = tsynth.sample_channel(
+      0, 10_ms, 3, [&](size_t i, const Pulse &p) {
+        TEST_ASSERT_EQUAL(pulses.size(), i);
+        pulses.push_back(p);
+      });
+
+  TEST_ASSERT_EQUAL(3, written);
+  TEST_ASSERT_EQUAL(3, pulses.size());
+  assert_duration_equal(pulses[0].on, 100_us);
+  assert_duration_equal(pulses[1].off, 800_us);
+  assert_duration_equal(pulses[2].on, 100_us);
+  assert_duration_equal(tsynth.track().played_time(0), 1200_us);
+}
+
 void samples_all_bps(Teslasynth<> &tsynth, int bps = 100) {
   const auto freq = Hertz(bps);
   const Duration16 sample_time = Duration16::micros(freq.period().micros());
@@ -390,6 +410,7 @@ extern "C" void app_main(void) {
   RUN_TEST(test_should_sequence_polyphonic_out_of_phase);
   RUN_TEST(test_should_sequence_polyphonic_out_of_phase_multichannel);
   RUN_TEST(test_should_sequence_polyphonic_out_of_phase_multichannel_note_off);
+  RUN_TEST(test_sample_channel_should_stop_at_capacity);
   RUN_TEST(test_must_not_be_limited_when_no_duty_limit);
   RUN_TEST(test_must_not_exceed_duty_limit);
   RUN_TEST(test_duty_rejection_saturates_off);
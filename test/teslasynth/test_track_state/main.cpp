@@ -46,6 +46,39 @@ void test_stop(void) {
   assert_duration_equal(track.played_time(0), Duration::zero());
 }
 
+void test_latency(void) {
+  TrackState<> track;
+  assert_duration_equal(track.on_receive(0, 10_ms, 15_ms), 15_ms);
+  assert_duration_equal(track.started_time(), 10_ms);
+  assert_duration_equal(track.on_play(0, 12_ms), 12_ms);
+
+  // 2ms behind playback without the latency, still 13ms ahead with it
+  assert_duration_equal(track.on_receive(0, 20_ms, 15_ms), 25_ms);
+  const auto &timing = track.timing();
+  TEST_ASSERT_EQUAL(2, timing.unbuffered.count);
+  TEST_ASSERT_EQUAL(1, timing.unbuffered.late);
+  TEST_ASSERT_EQUAL(2000, timing.unbuffered.max_us);
+  TEST_ASSERT_FLOAT_WITHIN(1, 1000, timing.unbuffered.mean_us());
+  TEST_ASSERT_FLOAT_WITHIN(1, 1000, timing.unbuffered.jitter_us());
+  TEST_ASSERT_EQUAL(2, timing.buffered.count);
+  TEST_ASSERT_EQUAL(0, timing.buffered.late);
+
+  track.reset_timing();
+  TEST_ASSERT_EQUAL(0, track.timing().unbuffered.count);
+}
+
+void test_receive_behind_playback(void) {
+  TrackState<> track;
+  assert_duration_equal(track.on_receive(0, 10_ms), Duration::zero());
+  assert_duration_equal(track.on_play(0, 22_ms), 22_ms);
+
+  // Played from where playback is, the time in between already went out
+  assert_duration_equal(track.on_receive(0, 15_ms), 22_ms);
+  assert_duration_equal(track.received_time(0), 22_ms);
+  assert_duration_equal(track.on_receive(0, 40_ms), 30_ms);
+  TEST_ASSERT_EQUAL(1, track.timing().unbuffered.late);
+}
+
 void test_playback(void) {
   TrackState<> track;
   assert_duration_equal(track.on_play(0, 10_ms), Duration::zero());
@@ -68,7 +101,7 @@ void test_playback(void) {
 
 void test_callback(void) {
   bool playing = false;
-  TrackState<> track([&](bool state) { playing = state; });
+  TrackState track([&](bool state) { playing = state; });
   TEST_ASSERT_FALSE(playing);
   assert_duration_equal(track.on_receive(0, 10_ms), Duration::zero());
   TEST_ASSERT_TRUE(playing);
@@ -81,6 +114,8 @@ extern "C" void app_main(void) {
   RUN_TEST(test_empty);
   RUN_TEST(test_tick);
   RUN_TEST(test_stop);
+  RUN_TEST(test_latency);
+  RUN_TEST(test_receive_behind_playback);
   RUN_TEST(test_playback);
   RUN_TEST(test_callback);
   UNITY_END();
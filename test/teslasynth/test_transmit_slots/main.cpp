@@ -0,0 +1,99 @@
+// Copyright Hossein Naderi 2025, 2026
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "transmit_slots.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <unity.h>
+
+using namespace teslasynth::midisynth;
+
+void slots_are_handed_out_in_order(void) {
+  TransmitSlots<3> slots;
+  for (size_t i = 0; i < 3; i++) {
+    TEST_ASSERT_TRUE(slots.next().has_value());
+    TEST_ASSERT_EQUAL(i, *slots.next());
+    slots.submit();
+  }
+  TEST_ASSERT_EQUAL(3, slots.in_flight());
+  TEST_ASSERT_FALSE(slots.next().has_value());
+
+  slots.release();
+  TEST_ASSERT_EQUAL(0, *slots.next());
+  slots.submit();
+  TEST_ASSERT_FALSE(slots.next().has_value());
+}
+
+void ping_pong_alternates(void) {
+  TransmitSlots<2> slots;
+  for (size_t block = 0; block < 10; block++) {
+    TEST_ASSERT_EQUAL(block % 2, *slots.next());
+    slots.submit();
+    if (block > 0)
+      slots.release();
+    TEST_ASSERT_LESS_OR_EQUAL(2, slots.in_flight());
+  }
+}
+
+void retracted_slots_are_reused(void) {
+  TransmitSlots<2> slots;
+  slots.submit();
+  TEST_ASSERT_EQUAL(1, *slots.next());
+  slots.submit();
+  slots.retract();
+  // Slot 0 is still in flight, so slot 1 is the one to render into again
+  TEST_ASSERT_EQUAL(1, *slots.next());
+  TEST_ASSERT_EQUAL(1, slots.in_flight());
+}
+
+void slots_are_never_overwritten_in_flight(void) {
+  constexpr uint32_t blocks = 500'000;
+  static TransmitSlots<3> slots;
+  static std::array<std::atomic<uint32_t>, 3> buffers;
+  static std::array<std::atomic<uint32_t>, 3> queue;
+  static std::atomic<uint32_t> queued{0};
+
+  // The transmitter reads back each block long after it was submitted
+  std::thread transmitter([&] {
+    for (uint32_t block = 0; block < blocks;) {
+      if (queued.load(std::memory_order_acquire) == block) {
+        std::this_thread::yield();
+        continue;
+      }
+      const uint32_t slot = queue[block % 3].load(std::memory_order_relaxed);
+      for (int spin = 0; spin < 50; spin++)
+        TEST_ASSERT_EQUAL_UINT32(block, buffers[slot].load(std::memory_order_relaxed));
+      slots.release();
+      block++;
+    }
+  });
+
+  for (uint32_t block = 0; block < blocks;) {
+    auto slot = slots.next();
+    if (!slot) {
+      std::this_thread::yield();
+      continue;
+    }
+    buffers[*slot].store(block, std::memory_order_relaxed);
+    queue[block % 3].store(*slot, std::memory_order_relaxed);
+    slots.submit();
+    queued.store(++block, std::memory_order_release);
+  }
+  transmitter.join();
+  TEST_ASSERT_EQUAL(0, slots.in_flight());
+}
+
+extern "C" void app_main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(slots_are_handed_out_in_order);
+  RUN_TEST(ping_pong_alternates);
+  RUN_TEST(retracted_slots_are_reused);
+  RUN_TEST(slots_are_never_overwritten_in_flight);
+  UNITY_END();
+}
+
+int main(int argc, char **argv) {
+  app_main();
+}
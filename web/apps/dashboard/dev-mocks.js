@@ -15,6 +15,7 @@ const MIDI_CHANNELS = 16;
 const synthConfig = {
     tuning: 440,
     instrument: null,
+    latency: 0,
     channels: Array.from({ length: OUTPUTS }, () => ({
         notes: 4,
         'max-on-time': 100,
@@ -169,6 +169,16 @@ function SynthConfigForm({
                 onChange={(id) => setDraft({ ...draft, instrument: id })}
                 value={draft['instrument']}
             />
+            <NumberInput
+                id="latency"
+                title="Input Latency (us)"
+                help="Fixed delay added to live MIDI input so every message plays exactly on time. Set it just above the jitter measured by the `jitter` console command; 0 plays messages as soon as they are handled."
+                value={draft.latency ?? 0}
+                min="0"
+                max="50000"
+                step="1"
+                onChange={(n) => setDraft({ ...draft, latency: n })}
+            />
 
             <h3>Channels</h3>
 